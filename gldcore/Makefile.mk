@@ -4,6 +4,7 @@ dist_pkgdata_DATA += gldcore/gridlabd.cnf
 
 GLD_SOURCES_PLACE_HOLDER = 
 GLD_SOURCES_PLACE_HOLDER += gldcore/aggregate.cpp gldcore/aggregate.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/batch.cpp gldcore/batch.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/class.cpp gldcore/class.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/cmdarg.cpp gldcore/cmdarg.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/compare.cpp gldcore/compare.h
@@ -23,6 +24,7 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/gld_sock.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/globals.cpp gldcore/globals.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/gridlabd.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/gui.cpp gldcore/gui.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/hash.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/http_client.cpp gldcore/http_client.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/index.cpp gldcore/index.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/instance.cpp gldcore/instance.h
@@ -63,6 +65,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/stream_type.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/test.cpp gldcore/test.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/threadpool.cpp gldcore/threadpool.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/timestamp.cpp gldcore/timestamp.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/trace.cpp gldcore/trace.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/column.cpp gldcore/column.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/transform.cpp gldcore/transform.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/unit.cpp gldcore/unit.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/validate.cpp gldcore/validate.h
@@ -65,7 +65,12 @@ GldAggregator::GldAggregator(AGGREGATION *a) ///< an existing aggregator
 GldAggregator::~GldAggregator(void)
 {
 	if ( --aggr->refcnt == 0 )
+	{
+		free(aggr->members);
+		free(aggr->addrs);
+		free(aggr->values);
 		delete aggr;
+	}
 }
 
 /** This constructor builds a new collection of objects into an aggregation.  
@@ -347,6 +352,22 @@ GldAggregator::GldAggregator(const char *aggregator, /**< aggregator (min,max,av
 			result->flags = flags;
 			result->punit = to_unit;
 			result->scale = scale;
+			result->generation = 0;
+			result->n_members = 0;
+			result->max_members = 0;
+			result->members = NULL;
+			result->addrs = NULL;
+			result->values = NULL;
+			result->column = NULL;
+			result->column_checked = false;
+			result->factor = 1.0;
+			result->offset = 0.0;
+			if ( part == AP_NONE && from_unit != NULL && to_unit != NULL )
+			{
+				/* same affine conversion as unit_convert_ex() */
+				result->factor = from_unit->a / to_unit->a;
+				result->offset = to_unit->b - from_unit->b * result->factor;
+			}
 		}
 		else
 		{
@@ -363,91 +384,343 @@ GldAggregator::GldAggregator(const char *aggregator, /**< aggregator (min,max,av
 	aggr->refcnt = 1;
 }
 
-/** This function performs an aggregate calculation given by the aggregation 
+/** Rebuild the materialized member list of the aggregation.
+
+	The member list only changes when objects are created or removed, or when
+	an object header field the group can select on is changed (see
+	object_get_generation()).  Groups that select on the object clock are
+	rerun on every evaluation.  The address of the aggregated value is resolved
+	once for each member so that evaluations need not look up the property.
  **/
-double GldAggregator::get_value(void)
+void GldAggregator::update_members(void)
 {
-	OBJECT *obj;
-	double numerator=0, denominator=0, secondary=0;
-
-	/* non-constant groups need search program rerun */
-	if ((aggr->group->constflags & CF_CONSTANT) != CF_CONSTANT){
-		aggr->last = find_pgm_run(NULL,aggr->group); /** @todo use constant part instead of NULL (ticket #3) */
+	unsigned long long generation = object_get_generation();
+	bool constant = (aggr->group->constflags & CF_CONSTANT) == CF_CONSTANT;
+	bool clocked = (aggr->group->constflags & CF_CLOCK) == CF_CLOCK;
+	if ( aggr->members != NULL && aggr->generation == generation && ( constant || ! clocked ) )
+	{
+		return;
 	}
 
-	for(obj = find_first(aggr->last); obj != NULL; obj = find_next(aggr->last, obj)){
-		double value=0;
-		double *pdouble = NULL;
-		complex *pcomplex = NULL;
+	/* rerun the search program, since even constant groups change when objects do */
+	FINDLIST *list = find_pgm_run(NULL,aggr->group); /** @todo use constant part instead of NULL (ticket #3) */
+	if ( list == NULL )
+	{
+		throw_exception("aggregate group run failed");
+		/* TROUBLESHOOT
+			The group of an aggregation whose membership varies could not be rerun.
+			This is most likely caused by a lack of memory.
+		 */
+	}
+	free(aggr->last);
+	aggr->last = list;
 
-		/* add time-sensitivity to verify that we are only aggregating objects that are in-service and not out-service. */
-		if(obj->in_svc >= global_clock || obj->out_svc <= global_clock)
+	size_t n = 0;
+	for ( OBJECT *obj = find_first(aggr->last) ; obj != NULL ; obj = find_next(aggr->last,obj) )
+	{
+		PROPERTY *prop = aggr->pinfo;
+		if ( object_prop_in_class(obj,prop) == NULL || prop->access == PA_PRIVATE )
+		{
 			continue;
+		}
+		if ( aggr->part == AP_NONE ? ! ( prop->ptype == PT_double || prop->ptype == PT_random ) : prop->ptype != PT_complex )
+		{
+			continue;
+		}
+		if ( n == aggr->max_members )
+		{
+			size_t size = aggr->max_members > 0 ? aggr->max_members*2 : 64;
+			OBJECT **members = (OBJECT**)realloc(aggr->members,size*sizeof(OBJECT*));
+			if ( members != NULL ) aggr->members = members;
+			void **addrs = (void**)realloc(aggr->addrs,size*sizeof(void*));
+			if ( addrs != NULL ) aggr->addrs = addrs;
+			double *values = (double*)realloc(aggr->values,size*sizeof(double));
+			if ( values != NULL ) aggr->values = values;
+			if ( members == NULL || addrs == NULL || values == NULL )
+			{
+				throw_exception("aggregate member list allocation failed");
+				/* TROUBLESHOOT
+					The system has run out of memory while building the member list of an aggregation.
+					Try freeing up system memory and try again.
+				 */
+			}
+			aggr->max_members = size;
+		}
+		aggr->members[n] = obj;
+		aggr->addrs[n] = (void*)((char*)(obj+1)+(int64)(prop->addr));
+		n++;
+	}
+	aggr->n_members = n;
+	aggr->generation = generation;
+	aggr->column = NULL;
+	aggr->column_checked = false;
+}
 
-		switch (aggr->pinfo->ptype) {
-		case PT_complex:
-		case PT_enduse:
-			pcomplex = object_get_complex(obj,aggr->pinfo);
-			if (pcomplex!=NULL)
+/** Use the property column whose objects are exactly the members of the
+	aggregation.  The check is made once the column has been refreshed in a
+	sync pass for the same object generation as the member list.
+ **/
+void GldAggregator::attach_column(void)
+{
+	if ( aggr->n_members == 0 )
+	{
+		aggr->column_checked = true;
+		return;
+	}
+	PROPERTYCOLUMN *column = column_find(aggr->members[0]->oclass,aggr->pinfo);
+	if ( column == NULL )
+	{
+		aggr->column_checked = true;
+		return;
+	}
+	if ( ! column_refresh(column) || column->generation != aggr->generation )
+	{
+		return;
+	}
+	if ( column->size == aggr->n_members && memcmp(column->objects,aggr->members,column->size*sizeof(OBJECT*)) == 0 )
+	{
+		aggr->column = column;
+	}
+	aggr->column_checked = true;
+}
+
+/** Gather the values of the in-service members into the value buffer.
+	@return the number of values gathered
+ **/
+size_t GldAggregator::gather(const double **data)
+{
+	OBJECT **members = aggr->members;
+	void **addrs = aggr->addrs;
+	double *values = aggr->values;
+	bool transform = aggr->factor != 1.0 || aggr->offset != 0.0 || (aggr->flags&AF_ABS) == AF_ABS;
+	size_t n = 0;
+	*data = values;
+
+	/* read from the property column when all the members are in service */
+	if ( ! aggr->column_checked )
+	{
+		attach_column();
+	}
+	PROPERTYCOLUMN *column = aggr->column;
+	if ( column != NULL && column_refresh(column) && column->generation == aggr->generation
+		&& column->in_svc < global_clock && column->out_svc > global_clock )
+	{
+		n = column->size;
+		switch ( aggr->part ) {
+		case AP_NONE:
+		case AP_REAL:
+			if ( ! transform )
 			{
-				switch (aggr->part) {
-				case AP_REAL: value = pcomplex->Re(); break;
-				case AP_IMAG: value = pcomplex->Im(); break;
-				case AP_MAG: value = pcomplex->Mag(); break;
-				case AP_ARG: value = pcomplex->Arg(); break;
-				case AP_ANG: value = pcomplex->Ang();  break;
-				default: pcomplex = NULL; break; /* invalidate the result */
-				}
+				*data = column->real;
+				return n;
 			}
+			memcpy(values,column->real,n*sizeof(double));
 			break;
-		case PT_double:
-		case PT_loadshape:
-		case PT_random:
-			pdouble = object_get_double(obj,aggr->pinfo);
-			if (pdouble!=NULL){
-				value = *pdouble;
-				if(aggr->pinfo->unit != 0 && aggr->punit != 0){
-					int rv = unit_convert_ex(aggr->pinfo->unit, aggr->punit, &value);
-					if(rv == 0){ // error
-						;
-					}
-				} // else don't worry
+		case AP_IMAG:
+			if ( ! transform )
+			{
+				*data = column->imag;
+				return n;
+			}
+			memcpy(values,column->imag,n*sizeof(double));
+			break;
+		case AP_MAG:
+			for ( size_t m = 0 ; m < n ; m++ )
+			{
+				values[m] = complex(column->real[m],column->imag[m]).Mag();
+			}
+			break;
+		case AP_ARG:
+			for ( size_t m = 0 ; m < n ; m++ )
+			{
+				values[m] = complex(column->real[m],column->imag[m]).Arg();
+			}
+			break;
+		case AP_ANG:
+			for ( size_t m = 0 ; m < n ; m++ )
+			{
+				values[m] = complex(column->real[m],column->imag[m]).Ang();
 			}
 			break;
 		default:
+			n = 0;
 			break;
 		}
+	}
+	else
+	{
+		for ( size_t m = 0 ; m < aggr->n_members ; m++ )
+		{
+			/* add time-sensitivity to verify that we are only aggregating objects that are in-service and not out-service. */
+			OBJECT *obj = members[m];
+			if ( obj->in_svc >= global_clock || obj->out_svc <= global_clock )
+			{
+				continue;
+			}
+			complex *pcomplex = (complex*)addrs[m];
+			switch ( aggr->part ) {
+			case AP_NONE: values[n++] = *(double*)addrs[m]; break;
+			case AP_REAL: values[n++] = pcomplex->Re(); break;
+			case AP_IMAG: values[n++] = pcomplex->Im(); break;
+			case AP_MAG: values[n++] = pcomplex->Mag(); break;
+			case AP_ARG: values[n++] = pcomplex->Arg(); break;
+			case AP_ANG: values[n++] = pcomplex->Ang(); break;
+			default: break;
+			}
+		}
+	}
 
-		if (pdouble!=NULL || pcomplex!=NULL) /* valid value */
+	/* apply unit conversion and absolute value to the whole buffer */
+	if ( aggr->factor != 1.0 || aggr->offset != 0.0 )
+	{
+		double a = aggr->factor, b = aggr->offset;
+		for ( size_t i = 0 ; i < n ; i++ )
 		{
-			if ((aggr->flags&AF_ABS)==AF_ABS) value=fabs(value);
+			values[i] = values[i]*a + b;
+		}
+	}
+	if ( (aggr->flags&AF_ABS) == AF_ABS )
+	{
+		for ( size_t i = 0 ; i < n ; i++ )
+		{
+			values[i] = fabs(values[i]);
+		}
+	}
+	return n;
+}
+
+/* Aggregation kernels
+
+	These use independent accumulators so the compiler can vectorize the loops
+	without reordering a single floating point dependency chain.
+ */
+static double aggregate_sum(const double *x, size_t n)
+{
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+	{
+		s0 += x[i]; s1 += x[i+1]; s2 += x[i+2]; s3 += x[i+3];
+	}
+	for ( ; i < n ; i++ )
+	{
+		s0 += x[i];
+	}
+	return (s0+s1)+(s2+s3);
+}
+static double aggregate_min(const double *x, size_t n)
+{
+	double m0 = x[0], m1 = x[0], m2 = x[0], m3 = x[0];
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+	{
+		m0 = x[i] < m0 ? x[i] : m0;
+		m1 = x[i+1] < m1 ? x[i+1] : m1;
+		m2 = x[i+2] < m2 ? x[i+2] : m2;
+		m3 = x[i+3] < m3 ? x[i+3] : m3;
+	}
+	for ( ; i < n ; i++ )
+	{
+		m0 = x[i] < m0 ? x[i] : m0;
+	}
+	m0 = m1 < m0 ? m1 : m0;
+	m2 = m3 < m2 ? m3 : m2;
+	return m2 < m0 ? m2 : m0;
+}
+static double aggregate_max(const double *x, size_t n)
+{
+	double m0 = x[0], m1 = x[0], m2 = x[0], m3 = x[0];
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+	{
+		m0 = x[i] > m0 ? x[i] : m0;
+		m1 = x[i+1] > m1 ? x[i+1] : m1;
+		m2 = x[i+2] > m2 ? x[i+2] : m2;
+		m3 = x[i+3] > m3 ? x[i+3] : m3;
+	}
+	for ( ; i < n ; i++ )
+	{
+		m0 = x[i] > m0 ? x[i] : m0;
+	}
+	m0 = m1 > m0 ? m1 : m0;
+	m2 = m3 > m2 ? m3 : m2;
+	return m2 > m0 ? m2 : m0;
+}
+static double aggregate_sumsq(const double *x, size_t n, double mean)
+{
+	double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	size_t i = 0;
+	for ( ; i+4 <= n ; i += 4 )
+	{
+		double d0 = x[i]-mean, d1 = x[i+1]-mean, d2 = x[i+2]-mean, d3 = x[i+3]-mean;
+		s0 += d0*d0; s1 += d1*d1; s2 += d2*d2; s3 += d3*d3;
+	}
+	for ( ; i < n ; i++ )
+	{
+		double d = x[i]-mean;
+		s0 += d*d;
+	}
+	return (s0+s1)+(s2+s3);
+}
+
+/** This function performs an aggregate calculation given by the aggregation
+ **/
+double GldAggregator::get_value(void)
+{
+	double numerator=0, denominator=0, secondary=0;
+
+	update_members();
+	const double *x;
+	size_t n = gather(&x);
+
+	switch (aggr->op) {
+	case AGGR_MIN:
+		if ( n > 0 )
+		{
+			numerator = aggregate_min(x,n);
+			denominator = 1;
+		}
+		break;
+	case AGGR_MAX:
+		if ( n > 0 )
+		{
+			numerator = aggregate_max(x,n);
+			denominator = 1;
+		}
+		break;
+	case AGGR_COUNT:
+		numerator = (double)n;
+		denominator = n > 0 ? 1 : 0;
+		break;
+	case AGGR_MBE:
+		numerator = aggregate_sum(x,n);
+		denominator = (double)n;
+		secondary = n > 0 ? numerator/denominator : 0;
+		break;
+	case AGGR_AVG:
+	case AGGR_MEAN:
+		numerator = aggregate_sum(x,n);
+		denominator = (double)n;
+		break;
+	case AGGR_SUM:
+		numerator = aggregate_sum(x,n);
+		denominator = n > 0 ? 1 : 0;
+		break;
+	case AGGR_STD:
+	case AGGR_VAR:
+		// two-pass algorithm; like the compensated on-line algorithm (see Knuth 1998)
+		// it doesn't suffer from numerical instability when mean(x)-x is near zero
+		denominator = (double)n;
+		if ( n > 0 )
+		{
+			numerator = aggregate_sumsq(x,n,aggregate_sum(x,n)/denominator);
+		}
+		break;
+	default:
+		for ( size_t i = 0 ; i < n ; i++ )
+		{
+			double value = x[i];
 			switch (aggr->op) {
-			case AGGR_MIN:
-				if (value<numerator || denominator==0) numerator=value;
-				denominator = 1;
-				break;
-			case AGGR_MAX:
-				if (value>numerator || denominator==0) numerator=value;
-				denominator = 1;
-				break;
-			case AGGR_COUNT:
-				numerator++;
-				denominator=1;
-				break;
-			case AGGR_MBE:
-				denominator++;
-				numerator += value;
-				secondary += (value-secondary)/denominator;
-				break;
-			case AGGR_AVG:
-			case AGGR_MEAN:
-				numerator+=value;
-				denominator++;
-				break;
-			case AGGR_SUM:
-				numerator+=value;
-				denominator = 1;
-				break;
 			case AGGR_PROD:
 				numerator*=value;
 				denominator = 1;
@@ -458,22 +731,13 @@ double GldAggregator::get_value(void)
 					secondary = value;
 				numerator++;
 				break;
-			case AGGR_STD:
-			case AGGR_VAR:
-				denominator++;
-				// note this uses a compensated on-line algorithm (see Knuth 1998)
-				// it's better than the obvious method because it doesn't suffer from numerical instability when mean(x)-x is near zero
-				{	double delta = value-secondary;
-					secondary += delta/denominator;
-					numerator += delta*(value-secondary);
-				}
-				break;
 			case AGGR_SKEW:
 			case AGGR_KUR:
 			default:
 				break;
 			}
 		}
+		break;
 	}
 	switch (aggr->op) {
 	case AGGR_GAMMA:
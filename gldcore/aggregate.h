@@ -131,6 +131,16 @@ DEPRECATED typedef enum e_aggregate_flags
 		size_t refcnt - count of references to this aggregator
 		struct <s_findlist> *last - the result of the last aggregation run
 		AGGREGATION *next - the next aggregation in the list of aggregators
+		unsigned long long generation - the object generation when the members were last built
+		size_t n_members - the number of members in the group
+		size_t max_members - the capacity of the member arrays
+		<OBJECT> **members - the members of the group
+		void **addrs - the resolved address of the aggregated value in each member
+		double *values - the buffer into which values are gathered
+		double factor - the unit conversion factor
+		double offset - the unit conversion offset
+		struct <s_property_column> *column - the property column holding the values of the members (NULL if none)
+		bool column_checked - flag indicating the members were compared with the property columns
  */
 DEPRECATED typedef struct s_aggregate {
 	AGGREGATOR op; 
@@ -143,6 +153,16 @@ DEPRECATED typedef struct s_aggregate {
 	size_t refcnt; 
 	struct s_findlist *last; 
 	struct s_aggregate *next; 
+	unsigned long long generation;
+	size_t n_members;
+	size_t max_members;
+	OBJECT **members;
+	void **addrs;
+	double *values;
+	double factor;
+	double offset;
+	struct s_property_column *column;
+	bool column_checked;
 } AGGREGATION; 
 
 /* Function: aggregate_mkgroup
@@ -168,6 +188,18 @@ class GldAggregator
 private:
 	AGGREGATION *aggr;
 
+	// Method: update_members
+	//	Rebuild the member list and value addresses when the object generation changes
+	void update_members(void);
+
+	// Method: gather
+	//	Copy the values of the in-service members into the value buffer
+	size_t gather(const double **data);
+
+	// Method: attach_column
+	//	Use the property column whose objects are exactly the members, if any
+	void attach_column(void);
+
 public:
 	/*	Constructor: GldAggregator
 			Implement a new aggregator
@@ -0,0 +1,10 @@
+# the time at which the object is moved to another parent (2020-01-01 01:30:00 UTC)
+change = 1577842200
+moved = False
+
+def reparent(obj,t):
+    global moved
+    if t >= change and not moved:
+        gridlabd.set_value(obj,"parent","p2")
+        moved = True
+    return t+1800
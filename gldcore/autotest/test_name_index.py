@@ -0,0 +1,10 @@
+# the time at which the object is named (2020-01-01 01:30:00 UTC)
+change = 1577842200
+named = False
+
+def rename(obj,t):
+    global named
+    if t >= change and not named:
+        gridlabd.set_value(obj,"name","obj_1_named")
+        named = True
+    return t+1800
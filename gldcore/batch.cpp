@@ -0,0 +1,86 @@
+/* File: batch.cpp
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file batch.cpp
+	@addtogroup batch
+ @{
+ **/
+
+#include "gldcore.h"
+
+void batch_free(BATCHLIST *list)
+{
+	size_t n;
+	for ( n = 0 ; n < list->n_batches ; n++ )
+		free(list->batch[n]);
+	free(list->batch);
+	list->batch = NULL;
+	list->n_batches = 0;
+	list->max_batches = 0;
+	list->built = false;
+}
+
+BATCH *batch_next(BATCHLIST *list, BATCH *batch)
+{
+	if ( batch != NULL && batch->n < BATCH_CHUNK )
+		return batch;
+	if ( list->n_batches == list->max_batches )
+	{
+		size_t size = list->max_batches > 0 ? list->max_batches*2 : 16;
+		BATCH **batches = (BATCH**)realloc(list->batch,sizeof(BATCH*)*size);
+		if ( batches == NULL )
+			return NULL;
+		list->batch = batches;
+		list->max_batches = size;
+	}
+	batch = (BATCH*)malloc(list->size);
+	if ( batch == NULL )
+		return NULL;
+	batch->n = 0;
+	batch->t2 = TS_NEVER;
+	list->batch[list->n_batches++] = batch;
+	return batch;
+}
+
+bool batch_ready(BATCHLIST *list, unsigned int generation)
+{
+	if ( list->built && list->generation == generation )
+		return true;
+	batch_free(list);
+	if ( list->build(list) )
+	{
+		list->built = true;
+		list->generation = generation;
+		return true;
+	}
+	batch_free(list);
+	output_warning("%s_batch disabled because the %s batches could not be allocated", list->name, list->name);
+	/* TROUBLESHOOT
+		There was not enough memory to group the enduses or loadshapes into batches.
+		They are updated one at a time instead, which gives the same results.
+		Free up memory or clear enduse_batch or loadshape_batch to avoid this warning.
+	 */
+	*list->enabled = false;
+	return false;
+}
+
+TIMESTAMP batch_syncall(BATCHLIST *list, TIMESTAMP t1)
+{
+	size_t n;
+	TIMESTAMP t2 = TS_NEVER;
+	TASKPOOL *pool = my_instance->get_exec()->get_taskpool();
+	if ( pool != NULL )
+		taskpool_run(pool,(void**)list->batch,list->n_batches,list->update,&t1,NULL);
+	else
+	{
+		for ( n = 0 ; n < list->n_batches ; n++ )
+			list->update(&t1,0,list->batch[n]);
+	}
+	for ( n = 0 ; n < list->n_batches ; n++ )
+	{
+		if ( list->batch[n]->t2 < t2 ) t2 = list->batch[n]->t2;
+	}
+	return t2;
+}
+
+/**@}**/
@@ -0,0 +1,112 @@
+/* File: batch.h
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file batch.h
+	@addtogroup batch Sync batches
+	@ingroup core
+
+	A batch list groups the items of a core sync list (e.g., enduses or
+	loadshapes) into batches of up to BATCH_CHUNK items.  Each batch gathers
+	the inputs of its items into arrays, updates them with a branch-free
+	kernel the compiler can vectorize, and scatters the results back to the
+	items.  The batches are updated on the sync thread pool when it is
+	running.
+
+	The owner defines its batch as a struct whose first member is a BATCH,
+	and provides the functions that build the batches and update one batch.
+	The batches are rebuilt whenever the owner's generation changes.
+
+ @{
+ **/
+
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#if ! defined _GLDCORE_H && ! defined _GRIDLABD_H
+#error "this header may only be included from gldcore.h or gridlabd.h"
+#endif
+
+#include "timestamp.h"
+#include "threadpool.h"
+
+/* Define: BATCH_CHUNK
+	Maximum number of items in a batch
+ */
+#define BATCH_CHUNK 256
+
+/* Define: BATCH_KERNEL
+	Attribute of the batch kernels
+
+	The kernels compute every result for every item and then select among
+	them, so they do not need floating point traps to be preserved.  Without
+	that gcc will not vectorize the selects.
+ */
+#if defined(__GNUC__) && ! defined(__clang__)
+#define BATCH_KERNEL __attribute__((optimize("no-trapping-math")))
+#else
+#define BATCH_KERNEL
+#endif
+
+/* Typedef: BATCH
+	Header of a batch
+ */
+typedef struct s_batch {
+	size_t n;				/**< number of items in the batch */
+	TIMESTAMP t2;			/**< earliest next event of the batch */
+} BATCH;
+
+/* Typedef: BATCHLIST
+	Batches of a sync list
+ */
+typedef struct s_batchlist {
+	const char *name;		/**< name of the items (e.g., "enduse") */
+	bool *enabled;			/**< global that enables the batches */
+	size_t size;			/**< size of a batch */
+	bool (*build)(struct s_batchlist *list); /**< adds the items to the batches */
+	TASKCALL update;		/**< updates one batch (the argument is the TIMESTAMP t1) */
+	BATCH **batch;			/**< batches */
+	size_t n_batches;		/**< number of batches */
+	size_t max_batches;		/**< capacity of the batch array */
+	bool built;				/**< flag indicating the batches were built */
+	unsigned int generation; /**< generation of the items when the batches were built */
+} BATCHLIST;
+
+/* Function: batch_free
+	Free the batches of a list
+ */
+void batch_free(BATCHLIST *list);
+
+/* Function: batch_next
+	Get a batch with room for another item
+
+	Returns:
+	The given batch if it has room, otherwise a new empty batch, or NULL if
+	memory could not be allocated
+ */
+BATCH *batch_next(BATCHLIST *list, /**< batch list */
+				  BATCH *batch); /**< last batch used (NULL to start a new one) */
+
+/* Function: batch_ready
+	Make sure the batches match the items
+
+	If the batches cannot be built the list's global is cleared and the
+	items must be updated one at a time.
+
+	Returns:
+	true if the batches can be used
+ */
+bool batch_ready(BATCHLIST *list, /**< batch list */
+				 unsigned int generation); /**< current generation of the items */
+
+/* Function: batch_syncall
+	Update all the batches
+
+	Returns:
+	The earliest next event of the batches
+ */
+TIMESTAMP batch_syncall(BATCHLIST *list, /**< batch list */
+						TIMESTAMP t1); /**< time of the update */
+
+#endif
+
+/**@}**/
@@ -164,6 +164,184 @@ int property_create(PROPERTY *prop, void *addr)
 }
 #endif
 
+/* Flattened property index
+
+	Each class keeps an open-addressed hash table of all the properties it 
+	can see, including those inherited from its parents, so that a lookup
+	costs one hash and usually one string compare instead of a scan of the
+	whole inheritance chain.  Properties declared by the class itself come
+	before those of its parents, so a property that shadows a parent 
+	property is found first, just as with the linear search.
+
+	The index is built on the first lookup after a property is added to any 
+	class or a class in the inheritance chain gets a new parent, which only 
+	happens while modules are loading.  Replaced indexes are kept on a retired 
+	list rather than freed because another thread may still be reading the 
+	stale one.  The retired indexes are freed once the model is initialized 
+	(see class_free_retired_property_indexes).
+ */
+typedef struct s_property_slot {
+	unsigned int hash;
+	PROPERTY *prop;
+} PROPERTYSLOT;
+struct s_property_index {
+	unsigned int generation; /**< property generation when index was built */
+	size_t depth; /**< number of ancestors when index was built */
+	CLASS **chain; /**< ancestors when index was built, parent first */
+	size_t mask; /**< slot count - 1 */
+	size_t count; /**< number of properties indexed */
+	PROPERTYSLOT *slot; /**< hash slots */
+	struct s_property_index *retired; /**< previously built index */
+};
+typedef struct s_property_index PROPERTYINDEX;
+static unsigned int property_generation = 1;
+static LOCKVAR property_index_lock = 0;
+
+static PROPERTYINDEX *class_build_property_index(CLASS *oclass)
+{
+	// count properties and check for inheritance loops
+	size_t count = 0;
+	unsigned int depth = 0;
+	for ( CLASS *c = oclass ; c != NULL ; c = c->parent )
+	{
+		if ( depth++ > class_count )
+		{
+			return NULL;
+		}
+		for ( PROPERTY *prop = c->pmap ; prop != NULL && prop->oclass == c ; prop = prop->next )
+		{
+			count++;
+		}
+	}
+
+	size_t size = 16;
+	while ( size < count*2 )
+	{
+		size *= 2;
+	}
+	PROPERTYINDEX *index = (PROPERTYINDEX*)malloc(sizeof(PROPERTYINDEX));
+	PROPERTYSLOT *slot = (PROPERTYSLOT*)calloc(size,sizeof(PROPERTYSLOT));
+	CLASS **chain = (CLASS**)malloc(sizeof(CLASS*)*depth);
+	if ( index == NULL || slot == NULL || chain == NULL )
+	{
+		free(index);
+		free(slot);
+		free(chain);
+		return NULL;
+	}
+	index->generation = property_generation;
+	index->depth = 0;
+	index->chain = chain;
+	for ( CLASS *c = oclass->parent ; c != NULL ; c = c->parent )
+	{
+		chain[index->depth++] = c;
+	}
+	index->mask = size-1;
+	index->count = 0;
+	index->slot = slot;
+	index->retired = oclass->pindex;
+	for ( CLASS *c = oclass ; c != NULL ; c = c->parent )
+	{
+		for ( PROPERTY *prop = c->pmap ; prop != NULL && prop->oclass == c ; prop = prop->next )
+		{
+			unsigned int hash = hash_name(prop->name);
+			size_t n;
+			for ( n = hash&index->mask ; slot[n].hash != 0 ; n = (n+1)&index->mask )
+			{
+				if ( slot[n].hash == hash && strcmp(slot[n].prop->name,prop->name) == 0 )
+				{
+					break; // shadowed by a child class property
+				}
+			}
+			if ( slot[n].hash == 0 )
+			{
+				slot[n].hash = hash;
+				slot[n].prop = prop;
+				index->count++;
+			}
+		}
+	}
+	return index;
+}
+
+static inline bool class_property_index_valid(CLASS *oclass, PROPERTYINDEX *index)
+{
+	if ( index == NULL || index->generation != property_generation )
+	{
+		return false;
+	}
+	CLASS *c = oclass->parent;
+	for ( size_t n = 0 ; n < index->depth ; n++, c = c->parent )
+	{
+		if ( c != index->chain[n] )
+		{
+			return false;
+		}
+	}
+	return c == NULL;
+}
+
+/** Free the property indexes that were replaced while the modules were loading.
+	This must only be called when no other thread can be looking up properties.
+ **/
+void class_free_retired_property_indexes(void)
+{
+	wlock(&property_index_lock);
+	for ( CLASS *oclass = class_get_first_class() ; oclass != NULL ; oclass = oclass->next )
+	{
+		PROPERTYINDEX *index = oclass->pindex;
+		if ( index == NULL )
+		{
+			continue;
+		}
+		while ( index->retired != NULL )
+		{
+			PROPERTYINDEX *retired = index->retired;
+			index->retired = retired->retired;
+			free(retired->slot);
+			free(retired->chain);
+			free(retired);
+		}
+	}
+	wunlock(&property_index_lock);
+}
+
+/* get the current property index of a class, rebuilding it if needed
+	@return the index, or NULL if it cannot be built
+ */
+static PROPERTYINDEX *class_get_property_index(CLASS *oclass)
+{
+	PROPERTYINDEX *index = __atomic_load_n(&oclass->pindex,__ATOMIC_ACQUIRE);
+	if ( ! class_property_index_valid(oclass,index) )
+	{
+		wlock(&property_index_lock);
+		index = oclass->pindex;
+		if ( ! class_property_index_valid(oclass,index) )
+		{
+			index = class_build_property_index(oclass);
+			if ( index != NULL )
+			{
+				__atomic_store_n(&oclass->pindex,index,__ATOMIC_RELEASE);
+			}
+		}
+		wunlock(&property_index_lock);
+	}
+	return index;
+}
+
+static PROPERTY *class_find_property_indexed(PROPERTYINDEX *index, const char *name)
+{
+	unsigned int hash = hash_name(name);
+	for ( size_t n = hash&index->mask ; index->slot[n].hash != 0 ; n = (n+1)&index->mask )
+	{
+		if ( index->slot[n].hash == hash && strcmp(index->slot[n].prop->name,name) == 0 )
+		{
+			return index->slot[n].prop;
+		}
+	}
+	return NULL;
+}
+
 /* though improbable, this is to prevent more complicated, specifically crafted
 	inheritence loops.  these should be impossible if a class_register call is
 	immediately followed by a class_define_map call. -d3p988 */
@@ -201,40 +379,30 @@ static PROPERTY *find_header_property(CLASS *oclass,
 	return prop;
 }
 
-/** Find the named property in the class
-
-	@return a pointer to the PROPERTY, or \p NULL if the property is not found.
- **/
-PROPERTY *class_find_property(CLASS *oclass,     /**< the object class */
-                              const PROPERTYNAME name) /**< the property name */
+/* check whether a property found by name is deprecated */
+static void class_check_deprecated_property(CLASS *oclass, PROPERTY *prop)
 {
-	if ( oclass == NULL )
+	if (prop->flags&PF_DEPRECATED && !(prop->flags&PF_DEPRECATED_NONOTICE) && !global_suppress_deprecated_messages)
 	{
-//		output_debug("class_find_property(CLASS *oclass=<%s>, PROPERTYNAME name='%s') -> NULL",oclass->name,name);
-		return NULL;
-	}
-
-	PROPERTY *prop = find_header_property(oclass,name);
-	if ( prop ) 
-	{
-//		output_debug("class_find_property(CLASS *oclass=<%s>, PROPERTYNAME name='%s') -> PROPERTY<%s:%s>",oclass->name,name,prop->oclass->name,prop->name);
-		return prop;
+		output_warning("class_find_property(CLASS *oclass='%s', PROPERTYNAME name='%s': property is deprecated", oclass->name, prop->name);
+		/* TROUBLESHOOT
+			You have done a search on a property that has been flagged as deprecated and will most likely not be supported soon.
+			Correct the usage of this property to get rid of this message.
+		 */
+		if (global_suppress_repeat_messages)
+			prop->flags |= ~PF_DEPRECATED_NONOTICE;
 	}
+}
 
+/* find a property by a linear search of the class inheritance chain */
+static PROPERTY *class_find_property_scan(CLASS *oclass, const PROPERTYNAME name)
+{
+	PROPERTY *prop;
 	for ( prop = class_get_first_property_inherit(oclass) ; prop != NULL ; prop = class_get_next_property_inherit(prop) )
 	{
 		if (strcmp(name,prop->name)==0)
 		{
-			if (prop->flags&PF_DEPRECATED && !(prop->flags&PF_DEPRECATED_NONOTICE) && !global_suppress_deprecated_messages)
-			{
-				output_warning("class_find_property(CLASS *oclass='%s', PROPERTYNAME name='%s': property is deprecated", oclass->name, name);
-				/* TROUBLESHOOT
-					You have done a search on a property that has been flagged as deprecated and will most likely not be supported soon.
-					Correct the usage of this property to get rid of this message.
-				 */
-				if (global_suppress_repeat_messages)
-					prop->flags |= ~PF_DEPRECATED_NONOTICE;
-			}
+			class_check_deprecated_property(oclass,prop);
 //			output_debug("class_find_property(CLASS *oclass=<%s>, PROPERTYNAME name='%s') -> PROPERTY<%s:%s>",oclass->name,name,prop->oclass->name,prop->name);
 			return prop;
 		}
@@ -265,6 +433,41 @@ PROPERTY *class_find_property(CLASS *oclass,     /**< the object class */
 	}
 }
 
+/** Find the named property in the class
+
+	@return a pointer to the PROPERTY, or \p NULL if the property is not found.
+ **/
+PROPERTY *class_find_property(CLASS *oclass,     /**< the object class */
+                              const PROPERTYNAME name) /**< the property name */
+{
+	if ( oclass == NULL )
+	{
+//		output_debug("class_find_property(CLASS *oclass=<%s>, PROPERTYNAME name='%s') -> NULL",oclass->name,name);
+		return NULL;
+	}
+
+	PROPERTY *prop = find_header_property(oclass,name);
+	if ( prop ) 
+	{
+//		output_debug("class_find_property(CLASS *oclass=<%s>, PROPERTYNAME name='%s') -> PROPERTY<%s:%s>",oclass->name,name,prop->oclass->name,prop->name);
+		return prop;
+	}
+
+	PROPERTYINDEX *index = class_get_property_index(oclass);
+	if ( index != NULL )
+	{
+		prop = class_find_property_indexed(index,name);
+		if ( prop != NULL )
+		{
+			class_check_deprecated_property(oclass,prop);
+		}
+		return prop;
+	}
+
+	// index could not be built, use a linear search so loops are reported
+	return class_find_property_scan(oclass,name);
+}
+
 /** Add a property to a class
  **/
 void class_add_property(CLASS *oclass,  /**< the class to which the property is to be added */
@@ -277,6 +480,7 @@ void class_add_property(CLASS *oclass,  /**< the class to which the property is
 		oclass->pmap = prop;
 	else
 		last->next = prop;
+	property_generation++;
 }
 
 bool has_child_class(CLASS *oclass)
@@ -1531,4 +1735,106 @@ int class_get_xsd(CLASS *oclass, /**< a pointer to the class to convert to XSD *
 }
 
 
+/** Test the class property index
+	
+	Every property visible in every registered class, and one name that is
+	not, is looked up with the index and with a linear search of the 
+	inheritance chain.  The results must agree, and the lookup rate of
+	both methods is reported.
+
+	@return the number of failed lookups
+ **/
+int class_property_test(void)
+{
+	const unsigned int rounds = 100;
+	const char *missing = "__no_such_property__";
+	int failed = 0;
+	size_t n_classes = 0, n_props = 0, n_lookups = 0;
+	int64 t_index = 0, t_scan = 0;
+	int suppress = global_suppress_deprecated_messages;
+	global_suppress_deprecated_messages = 1;
+
+	output_test("\nBEGIN: class property index tests");
+	for ( CLASS *oclass = first_class ; oclass != NULL ; oclass = oclass->next )
+	{
+		// collect the names visible in this class
+		size_t count = 1;
+		for ( CLASS *c = oclass ; c != NULL ; c = c->parent )
+		{
+			for ( PROPERTY *prop = c->pmap ; prop != NULL && prop->oclass == c ; prop = prop->next )
+			{
+				count++;
+			}
+		}
+		const char **name = (const char**)malloc(sizeof(const char*)*count);
+		if ( name == NULL )
+		{
+			output_test(" ! memory allocation failed");
+			failed++;
+			break;
+		}
+		size_t n = 0;
+		for ( CLASS *c = oclass ; c != NULL ; c = c->parent )
+		{
+			for ( PROPERTY *prop = c->pmap ; prop != NULL && prop->oclass == c ; prop = prop->next )
+			{
+				name[n++] = prop->name;
+			}
+		}
+		name[n++] = missing;
+
+		// verify the index against the linear search
+		for ( n = 0 ; n < count ; n++ )
+		{
+			PROPERTY *found = class_find_property(oclass,name[n]);
+			PROPERTY *expect = class_find_property_scan(oclass,name[n]);
+			if ( found != expect )
+			{
+				output_test(" ! class %s property %s found <%s:%s> but expected <%s:%s>", oclass->name, name[n],
+					found?found->oclass->name:"NULL", found?found->name:"NULL",
+					expect?expect->oclass->name:"NULL", expect?expect->name:"NULL");
+				failed++;
+			}
+		}
+
+		// time both methods
+		volatile PROPERTY *sink = NULL;
+		int64 t0 = trace_now();
+		for ( unsigned int r = 0 ; r < rounds ; r++ )
+		{
+			for ( n = 0 ; n < count ; n++ )
+			{
+				sink = class_find_property(oclass,name[n]);
+			}
+		}
+		int64 t1 = trace_now();
+		for ( unsigned int r = 0 ; r < rounds ; r++ )
+		{
+			for ( n = 0 ; n < count ; n++ )
+			{
+				sink = class_find_property_scan(oclass,name[n]);
+			}
+		}
+		int64 t2 = trace_now();
+		(void)sink;
+		t_index += t1-t0;
+		t_scan += t2-t1;
+		n_classes++;
+		n_props += count-1;
+		n_lookups += count*rounds;
+		free(name);
+	}
+	global_suppress_deprecated_messages = suppress;
+
+	double r_index = t_index > 0 ? n_lookups*1e9/t_index : 0;
+	double r_scan = t_scan > 0 ? n_lookups*1e9/t_scan : 0;
+	output_test("%d classes, %d properties, %d lookups", (int)n_classes, (int)n_props, (int)n_lookups);
+	output_test("indexed lookups: %.3g per second", r_index);
+	output_test("linear lookups: %.3g per second", r_scan);
+	output_test("END: %d class property index tests failed", failed);
+	output_message("class property index test: %d classes, %d properties, %d failures", (int)n_classes, (int)n_props, failed);
+	output_message("indexed %.3g lookups/s, linear %.3g lookups/s (%.1fx)", r_index, r_scan, r_scan>0 ? r_index/r_scan : 0);
+	return failed;
+}
+
 /**@}**/
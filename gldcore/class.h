@@ -36,8 +36,11 @@ typedef int64 (*FUNCTIONADDR)(void*,...);
 		PC_PARENT_OVERRIDE_OMIT = 0x0040 - used to ignore parent's use of PC_UNSAFE_OVERRIDE_OMIT
 		PC_UNSAFE_OVERRIDE_OMIT = 0x0080 - used to flag that omitting overrides is unsafe
 		PC_ABSTRACTONLY = 0x0100 - used to flag that the class should never be instantiated itself, only inherited classes should
-		PC_AUTOLOCK = 0x0200 - used to flag that sync operations should not be automatically write locked
+		PC_AUTOLOCK = 0x0200 - used to flag that sync operations should be automatically write locked
 		PC_OBSERVER = 0x0400 - used to flag whether commit process needs to be delayed with respect to ordinary "in-the-loop" objects
+		PC_LAZYSYNC = 0x0800 - used to flag that sync may be skipped when the object has no pending event (see <global_lazy_sync>)
+		PC_PARALLELUPDATE = 0x1000 - used to flag that deltamode updates of the class are reentrant and may run concurrently with other updates (see <global_deltamode_parallel>)
+		PC_PARALLELINIT = 0x2000 - used to flag that init of the class is reentrant and may run concurrently with other inits (see <global_init_parallel>)
  */
 typedef enum e_passconfig
 {
@@ -51,6 +54,9 @@ typedef enum e_passconfig
 	PC_ABSTRACTONLY 		= 0x0100,
 	PC_AUTOLOCK 			= 0x0200,
 	PC_OBSERVER 			= 0x0400,
+	PC_LAZYSYNC 			= 0x0800,
+	PC_PARALLELUPDATE 		= 0x1000,
+	PC_PARALLELINIT 		= 0x2000,
 } PASSCONFIG;
 
 /*	Typedef: NOTIFYMODULE
@@ -235,6 +241,7 @@ typedef struct s_eventhandlers {
 	has_runtime - flag to indicate runtime DLL is used
 	runtime - filename of runtime DLL used
 	next - next class in class list
+	pindex - flattened property lookup index (core use only)
  */
 struct s_class_list {
 	// Field: magic
@@ -304,6 +311,8 @@ struct s_class_list {
 	struct s_eventhandlers events;
 	// Field: next
 	struct s_class_list *next;
+	// Field: pindex
+	struct s_property_index *pindex;
 }; /* CLASS */
 
 #ifdef __cplusplus
@@ -359,6 +368,13 @@ DEPRECATED PROPERTY *class_find_property(CLASS *oclass, PROPERTYNAME name);
  */
 DEPRECATED void class_add_property(CLASS *oclass, PROPERTY *prop);
 
+/* Function: class_free_retired_property_indexes
+	Free the property indexes that were replaced while the modules were loading
+
+	This must only be called when no other thread can be looking up properties.
+ */
+void class_free_retired_property_indexes(void);
+
 /* Function: class_add_extended_property
 
 	This function is obsolete.
@@ -569,6 +585,15 @@ DEPRECATED int class_add_loadmethod(CLASS *oclass, const char *name, LOADMETHODC
  */
 DEPRECATED LOADMETHOD *class_get_loadmethod(CLASS *oclass,const char *name);
 
+/* Function: class_property_test
+
+	Verify the property lookup index of every registered class against
+	a linear search and report the lookup rate of both.
+	
+	Returns: the number of failed lookups
+ */
+int class_property_test(void);
+
 #ifdef __cplusplus
 }
 
@@ -871,6 +871,52 @@ int GldCmdarg::pidfile(int argc, const char *argv[])
 	return 0;
 }
 
+DEPRECATED static int restore(void *main, int argc, const char *argv[])
+{
+	return ((GldMain*)main)->get_cmdarg()->restore(argc,argv);
+}
+int GldCmdarg::restore(int argc, const char *argv[])
+{
+	if ( argc>1 )
+	{
+		strcpy(global_checkpoint_restore,(argc--,*++argv));
+		return 1;
+	}
+	else
+	{
+		output_fatal("missing checkpoint file");
+		/* TROUBLESHOOT
+			The <b>--restore</b> command line directive
+			was not followed by a valid filename.  The correct syntax is
+			<b>--restore <i>file</i></b>.
+		 */
+		return CMDERR;
+	}
+}
+
+DEPRECATED static int scenarios(void *main, int argc, const char *argv[])
+{
+	return ((GldMain*)main)->get_cmdarg()->scenarios(argc,argv);
+}
+int GldCmdarg::scenarios(int argc, const char *argv[])
+{
+	if ( argc>1 )
+	{
+		strcpy(global_scenario_file,(argc--,*++argv));
+		return 1;
+	}
+	else
+	{
+		output_fatal("missing scenario file");
+		/* TROUBLESHOOT
+			The <b>--scenarios</b> command line directive
+			was not followed by a valid filename.  The correct syntax is
+			<b>--scenarios <i>file</i></b>.
+		 */
+		return CMDERR;
+	}
+}
+
 DEPRECATED static int kml(void *main, int argc, const char *argv[])
 {
 	return ((GldMain*)main)->get_cmdarg()->kml(argc,argv);
@@ -1893,6 +1939,34 @@ int GldCmdarg::locktest(int argc, const char *argv[])
 	return CMDOK;
 }
 
+DEPRECATED static int proptest(void *main, int argc, const char *argv[])
+{
+	return ((GldMain*)main)->get_cmdarg()->proptest(argc,argv);
+}
+int GldCmdarg::proptest(int argc, const char *argv[])
+{
+	if ( argc > 1 && argv[1][0] != '-' )
+	{
+		char modules[1024];
+		strncpy(modules,argv[1],sizeof(modules)-1);
+		modules[sizeof(modules)-1] = '\0';
+		char *last = NULL;
+		for ( char *name = strtok_r(modules,",",&last) ; name != NULL ; name = strtok_r(NULL,",",&last) )
+		{
+			if ( module_load(name,0,NULL) == NULL )
+			{
+				output_error("module %s is not found", name);
+				/*	TROUBLESHOOT
+					The <b>--proptest</b> parameter was followed by a module that could
+					not be loaded.  Verify that the module exists in GridLAB-D's <b>lib</b> folder.
+				*/
+				return CMDERR;
+			}
+		}
+	}
+	return class_property_test() == 0 ? CMDOK : CMDERR;
+}
+
 DEPRECATED static int workdir(void *main, int argc, const char *argv[])
 {
 	return ((GldMain*)main)->get_cmdarg()->workdir(argc,argv);
@@ -2175,6 +2249,7 @@ DEPRECATED static CMDARG main_commands[] = {
 	{"loadshapetest", NULL,	loadshapetest,	NULL, "Perform loadshape pseudo-object test" },
 	{"locktest",	NULL,	locktest,		NULL, "Perform memory locking test" },
 	{"modtest",		NULL,	modtest,		"<module>", "Perform test function provided by module" },
+	{"proptest",	NULL,	proptest,		"[<module>[,...]]", "Perform class property lookup test" },
 	{"randtest",	NULL,	randtest,		NULL, "Perform random number generator test" },
 	{"scheduletest", NULL,	scheduletest,	NULL, "Perform schedule pseudo-object test" },	
 	{"test",		NULL,	test,			"<module>", "Perform unit test of module (deprecated)" },
@@ -2202,6 +2277,8 @@ DEPRECATED static CMDARG main_commands[] = {
 
 	{NULL,NULL,NULL,NULL, "Process control"},
 	{"pidfile",		NULL,	pidfile,		"[=<filename>]", "Set the process ID file (default is gridlabd.pid)" },
+	{"restore",		NULL,	restore,		"<file>", "Restore the simulation state from a checkpoint file after initialization" },
+	{"scenarios",	NULL,	scenarios,		"<file>", "Run the scenarios in a CSV file from the initialized model" },
 	{"threadcount", "T",	threadcount,	"<n>", "Set the maximum number of threads allowed" },
 	{"job",			NULL,	job,			"...", "Start a job"},
 
@@ -176,12 +176,15 @@ public:
 	int plist(int argc, const char *argv[]);
 	int printenv(int argc, const char *argv[]);
 	int profile(int argc, const char *argv[]);
+	int proptest(int argc, const char *argv[]);
 	int pstatus(int argc, const char *argv[]);
 	int quiet(int argc, const char *argv[]);
 	int randtest(int argc, const char *argv[]);
 	int redirect(int argc, const char *argv[]);
 	int relax(int argc, const char *argv[]);
 	int remote_client(int argc, const char *argv[]);
+	int restore(int argc, const char *argv[]);
+	int scenarios(int argc, const char *argv[]);
 	int scheduletest(int argc, const char *argv[]);
 	int server(int argc, const char *argv[]);
 	int server_inaddr(int argc, const char *argv[]);
@@ -0,0 +1,251 @@
+/* File: column.cpp
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file column.cpp
+	@addtogroup column
+ @{
+ **/
+
+#include "gldcore.h"
+
+SET_MYCONTEXT(DMC_COLUMN)
+
+static PROPERTYCOLUMN *column_list = NULL;
+static unsigned long long column_passes = 0; /* number of sync passes started */
+static unsigned long long column_pass = 0; /* current sync pass (0 if none) */
+
+PROPERTYCOLUMN *column_find(CLASS *oclass, PROPERTY *prop)
+{
+	for ( PROPERTYCOLUMN *column = column_list ; column != NULL ; column = column->next )
+	{
+		if ( column->oclass == oclass && column->prop == prop )
+		{
+			return column;
+		}
+	}
+	return NULL;
+}
+
+PROPERTYCOLUMN *column_create(CLASS *oclass, PROPERTY *prop)
+{
+	if ( prop->ptype != PT_double && prop->ptype != PT_complex )
+	{
+		return NULL;
+	}
+	PROPERTYCOLUMN *column = column_find(oclass,prop);
+	if ( column != NULL )
+	{
+		return column;
+	}
+	column = (PROPERTYCOLUMN*)malloc(sizeof(PROPERTYCOLUMN));
+	if ( column == NULL )
+	{
+		return NULL;
+	}
+	memset(column,0,sizeof(PROPERTYCOLUMN));
+	column->oclass = oclass;
+	column->prop = prop;
+	column->updated = TS_NEVER;
+	column->in_svc = TS_NEVER;
+	column->out_svc = TS_ZERO;
+	column->next = column_list;
+	column_list = column;
+	return column;
+}
+
+bool column_exists(void)
+{
+	return column_list != NULL;
+}
+
+/* rebuild the object list of a column */
+static bool column_rebuild(PROPERTYCOLUMN *column, unsigned long long generation)
+{
+	size_t n = 0;
+	for ( OBJECT *obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		if ( obj->oclass != column->oclass )
+		{
+			continue;
+		}
+		if ( n == column->max )
+		{
+			size_t size = column->max > 0 ? column->max*2 : 64;
+			OBJECT **objects = (OBJECT**)realloc(column->objects,size*sizeof(OBJECT*));
+			if ( objects != NULL ) column->objects = objects;
+			double *real = (double*)realloc(column->real,size*sizeof(double));
+			if ( real != NULL ) column->real = real;
+			double *imag = column->imag;
+			if ( column->prop->ptype == PT_complex )
+			{
+				imag = (double*)realloc(column->imag,size*sizeof(double));
+				if ( imag != NULL ) column->imag = imag;
+			}
+			if ( objects == NULL || real == NULL || ( column->prop->ptype == PT_complex && imag == NULL ) )
+			{
+				return false;
+			}
+			column->max = size;
+		}
+		column->objects[n++] = obj;
+	}
+	column->size = n;
+	column->generation = generation;
+	return true;
+}
+
+/* copy the values of the objects into a column */
+static void column_update(PROPERTYCOLUMN *column)
+{
+	OBJECT **objects = column->objects;
+	size_t offset = (size_t)column->prop->addr;
+	TIMESTAMP in_svc = TS_ZERO, out_svc = TS_NEVER;
+	if ( column->prop->ptype == PT_complex )
+	{
+		double *real = column->real, *imag = column->imag;
+		for ( size_t n = 0 ; n < column->size ; n++ )
+		{
+			OBJECT *obj = objects[n];
+			complex *value = (complex*)((char*)(obj+1)+offset);
+			real[n] = value->Re();
+			imag[n] = value->Im();
+			if ( obj->in_svc > in_svc ) in_svc = obj->in_svc;
+			if ( obj->out_svc < out_svc ) out_svc = obj->out_svc;
+		}
+	}
+	else
+	{
+		double *real = column->real;
+		for ( size_t n = 0 ; n < column->size ; n++ )
+		{
+			OBJECT *obj = objects[n];
+			real[n] = *(double*)((char*)(obj+1)+offset);
+			if ( obj->in_svc > in_svc ) in_svc = obj->in_svc;
+			if ( obj->out_svc < out_svc ) out_svc = obj->out_svc;
+		}
+	}
+	column->in_svc = in_svc;
+	column->out_svc = out_svc;
+	column->updated = global_clock;
+}
+
+/* create the columns in a list of class.property names */
+static STATUS column_create_list(const char *columns)
+{
+	char list[1024], *item, *last = NULL;
+	strncpy(list,columns,sizeof(list)-1);
+	list[sizeof(list)-1] = '\0';
+	for ( item = strtok_r(list,", ",&last) ; item != NULL ; item = strtok_r(NULL,", ",&last) )
+	{
+		char classname[64], propname[64];
+		if ( sscanf(item,"%63[^.].%63s",classname,propname) != 2 )
+		{
+			output_error("property_columns: '%s' is not a valid class.property name", item);
+			/* TROUBLESHOOT
+				The property_columns global variable must list properties as
+				class.property, separated by commas.  Correct the list and try again.
+			 */
+			return FAILED;
+		}
+		CLASS *oclass = class_get_class_from_classname(classname);
+		if ( oclass == NULL )
+		{
+			output_error("property_columns: class '%s' not found", classname);
+			/* TROUBLESHOOT
+				The property_columns global variable lists a class that is not loaded.
+				Check the spelling of the class name and make sure the module that
+				implements it is loaded.
+			 */
+			return FAILED;
+		}
+		PROPERTY *prop = class_find_property(oclass,propname);
+		if ( prop == NULL )
+		{
+			output_error("property_columns: class '%s' has no property '%s'", classname, propname);
+			/* TROUBLESHOOT
+				The property_columns global variable lists a property that is not
+				defined by the class.  Check the spelling of the property name and try again.
+			 */
+			return FAILED;
+		}
+		if ( column_create(oclass,prop) == NULL )
+		{
+			output_error("property_columns: property '%s.%s' is not a double or complex", classname, propname);
+			/* TROUBLESHOOT
+				Only double and complex properties can be kept in columns.
+				Remove the property from the property_columns global variable and try again.
+			 */
+			return FAILED;
+		}
+		IN_MYCONTEXT output_debug("property_columns: created column for %s.%s", classname, propname);
+	}
+	return SUCCESS;
+}
+
+STATUS column_init(void)
+{
+	if ( strcmp(global_property_columns,"") != 0 && column_create_list(global_property_columns) == FAILED )
+	{
+		return FAILED;
+	}
+	if ( column_exists() )
+	{
+		column_update_all();
+	}
+	return SUCCESS;
+}
+
+void column_update_all(void)
+{
+	unsigned long long generation = object_get_generation();
+	for ( PROPERTYCOLUMN *column = column_list ; column != NULL ; column = column->next )
+	{
+		if ( column->generation != generation && ! column_rebuild(column,generation) )
+		{
+			throw_exception("property column allocation failed");
+			/* TROUBLESHOOT
+				The system has run out of memory while building a property column.
+				Try freeing up system memory or clearing property_columns and try again.
+			 */
+		}
+		column_update(column);
+	}
+}
+
+void column_pass_begin(void)
+{
+	column_pass = ++column_passes;
+}
+
+void column_pass_end(void)
+{
+	column_pass = 0;
+}
+
+bool column_refresh(PROPERTYCOLUMN *column)
+{
+	unsigned long long pass = column_pass;
+	if ( pass == 0 )
+	{
+		return false;
+	}
+	bool ok = true;
+	wlock(&column->lock);
+	if ( column->pass != pass )
+	{
+		unsigned long long generation = object_get_generation();
+		if ( column->generation != generation && ! column_rebuild(column,generation) )
+		{
+			ok = false;
+		}
+		else
+		{
+			column_update(column);
+			column->pass = pass;
+		}
+	}
+	wunlock(&column->lock);
+	return ok;
+}
+
+/** @} **/
@@ -0,0 +1,125 @@
+/* File: column.h
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file column.h
+	@addtogroup column Property columns
+	@ingroup core
+
+	A property column is a contiguous copy of one double or complex property
+	of every object of a class.  The columns listed in <global_property_columns>
+	are copied from the objects the first time they are read in each sync
+	pass, so consumers that read the same property from every object of a
+	class (e.g., aggregations) can scan an array instead of following a
+	pointer to each object.
+
+	A column read in a sync pass holds the values the objects have when the
+	pass first reads it, which include all the changes made by earlier passes,
+	players, schedules, transforms, and commits.  Outside of the sync passes
+	(e.g., in commit or in deltamode) columns cannot be refreshed and consumers
+	must read the objects.
+
+ @{
+ **/
+
+#ifndef _COLUMN_H
+#define _COLUMN_H
+
+#if ! defined _GLDCORE_H && ! defined _GRIDLABD_H
+#error "this header may only be included from gldcore.h or gridlabd.h"
+#endif
+
+/* Typedef: PROPERTYCOLUMN
+	Columnar copy of a class property
+
+	The value of the object objects[n] is in real[n] and, for complex
+	properties, imag[n].
+ */
+typedef struct s_property_column {
+	CLASS *oclass;			/**< class whose objects are in the column */
+	PROPERTY *prop;			/**< property copied (double or complex) */
+	unsigned long long generation; /**< object generation when the object list was built */
+	TIMESTAMP updated;		/**< clock when the values were last copied (TS_NEVER if never) */
+	unsigned long long pass; /**< sync pass in which the values were last copied */
+	LOCKVAR lock;			/**< lock held while the values are copied */
+	size_t size;			/**< number of objects in the column */
+	size_t max;				/**< capacity of the arrays */
+	OBJECT **objects;		/**< objects in id order */
+	double *real;			/**< double values or real parts */
+	double *imag;			/**< imaginary parts (NULL unless complex) */
+	TIMESTAMP in_svc;		/**< latest in-service time of the objects */
+	TIMESTAMP out_svc;		/**< earliest out-of-service time of the objects */
+	struct s_property_column *next; /**< next column */
+} PROPERTYCOLUMN;
+
+/* Function: column_create
+	Create a column for a class property
+
+	If the column already exists it is returned.
+
+	Returns:
+	The column, or NULL if the property is not a double or complex
+ */
+PROPERTYCOLUMN *column_create(CLASS *oclass, /**< class of the objects */
+							  PROPERTY *prop); /**< property to copy */
+
+/* Function: column_find
+	Find the column of a class property
+
+	Returns:
+	The column, or NULL if none
+ */
+PROPERTYCOLUMN *column_find(CLASS *oclass, /**< class of the objects */
+							PROPERTY *prop); /**< property copied */
+
+/* Function: column_exists
+	Check whether any column has been created
+
+	Returns:
+	true if at least one column exists
+ */
+bool column_exists(void);
+
+/* Function: column_init
+	Create the columns listed in <global_property_columns> and fill all the
+	columns, including those created by modules
+
+	Returns:
+	SUCCESS or FAILED
+ */
+STATUS column_init(void);
+
+/* Function: column_update_all
+	Copy the current values of all objects into all columns
+
+	The object lists are rebuilt first if objects were created or removed
+	since the last update.
+ */
+void column_update_all(void);
+
+/* Function: column_pass_begin
+	Start a sync pass, after which each column is copied again the first
+	time it is refreshed
+ */
+void column_pass_begin(void);
+
+/* Function: column_pass_end
+	End a sync pass, after which columns cannot be refreshed until the next
+	pass begins
+ */
+void column_pass_end(void);
+
+/* Function: column_refresh
+	Copy the current values of the objects into a column unless it was
+	already copied in the current sync pass
+
+	This may be called concurrently by objects synced in the same pass.
+
+	Returns:
+	true if the column holds the values of the current sync pass, false if
+	no sync pass is running or the object list could not be rebuilt
+ */
+bool column_refresh(PROPERTYCOLUMN *column); /**< column to refresh */
+
+#endif
+
+/** @} **/
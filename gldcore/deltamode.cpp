@@ -9,13 +9,49 @@
 
 #include "gldcore.h"
 
+#include <atomic>
+
 SET_MYCONTEXT(DMC_DELTAMODE)
 
+extern GldMain *my_instance;
+
 static OBJECT **delta_objectlist = NULL; /* qualified object list */
 static int delta_objectcount = 0; /* qualified object count */
 static MODULE **delta_modulelist = NULL; /* qualified module list */
 static int delta_modulecount = 0; /* qualified module count */
 
+/* parallel update groups (see deltamode_parallel) */
+typedef struct s_deltagroup {
+	void **object; /* objects of the rank that may be updated concurrently, grouped by class */
+	size_t n_objects; /* number of concurrent objects */
+	OBJECT **serial; /* objects of the rank whose class is not flagged PC_PARALLELUPDATE */
+	size_t n_serial; /* number of serial objects */
+} DELTAGROUP;
+static DELTAGROUP *delta_grouplist = NULL; /* update groups in rank order */
+static unsigned int delta_groupcount = 0; /* number of update groups */
+static TASKPOOL *delta_taskpool = NULL; /* thread pool used for parallel updates */
+
+/* parallel update call data */
+typedef struct s_deltacall {
+	DT timestep;
+	unsigned int iteration_count;
+} DELTACALL;
+
+/* multi-rate updates (see delta_substep) */
+typedef struct s_deltarate {
+	OBJECT *obj; /* object that is updated less often than every timestep */
+	unsigned int steps; /* number of timesteps per update */
+	unsigned int phase; /* number of timesteps since the last update */
+	int mode; /* mode returned by the last update, held until the next update */
+	bool warned; /* substep rounding warning was given */
+} DELTARATE;
+static DELTARATE *delta_ratelist = NULL; /* multi-rate objects sorted by address */
+static unsigned int delta_ratecount = 0; /* number of multi-rate objects */
+
+/* parallel update results (SM_EVENT < SM_DELTA < SM_DELTA_ITER is the merge priority) */
+static std::atomic<int> delta_update_mode(SM_EVENT);
+static std::atomic<OBJECT*> delta_update_error(NULL);
+
 void delta_modecheck(const char*)
 {
 	if ( global_deltamode_allowed == TRUE )
@@ -31,6 +67,237 @@ DELTAPROFILE *delta_getprofile(void)
 	return &profile;
 }
 
+/* order multi-rate objects by address */
+static int delta_rate_compare(const void *a, const void *b)
+{
+	OBJECT *obj_a = ((DELTARATE*)a)->obj, *obj_b = ((DELTARATE*)b)->obj;
+	return obj_a < obj_b ? -1 : ( obj_a > obj_b ? 1 : 0 );
+}
+
+/* get the multi-rate data of an object, or NULL if it is updated every timestep */
+static inline DELTARATE *delta_rate_find(OBJECT *obj)
+{
+	if ( obj->delta_substep <= 0 || delta_ratecount == 0 )
+		return NULL;
+	DELTARATE key;
+	key.obj = obj;
+	return (DELTARATE*)bsearch(&key,delta_ratelist,delta_ratecount,sizeof(DELTARATE),delta_rate_compare);
+}
+
+/* collect the objects that have a delta_substep */
+static STATUS delta_init_rates(void)
+{
+	char temp_name_buff[64];
+	int n;
+	for ( n = 0 ; n < delta_objectcount ; n++ )
+	{
+		OBJECT *obj = delta_objectlist[n];
+		if ( obj->delta_substep <= 0 )
+			continue;
+		if ( obj->oclass->update == NULL )
+		{
+			output_warning("object '%s' delta_substep is ignored because class '%s' is updated by its module",
+				object_name(obj,temp_name_buff,63), obj->oclass->name);
+			/* TROUBLESHOOT
+			   Only objects whose class has an object-level deltamode update function can be updated at their
+			   own interval.  The objects of other classes, such as powerflow objects, are updated by their
+			   module on every deltamode timestep.  Remove the object's delta_substep to avoid this warning.
+			 */
+			continue;
+		}
+		delta_ratecount++;
+	}
+	if ( delta_ratecount == 0 )
+		return SUCCESS;
+	delta_ratelist = (DELTARATE*)malloc(sizeof(DELTARATE)*delta_ratecount);
+	if ( delta_ratelist == NULL )
+	{
+		output_error("unable to allocate memory for deltamode multi-rate list");
+		/* TROUBLESHOOT
+		  Deltamode operation requires more memory than is available.
+		  Try freeing up memory by making more heap available or making the model smaller. 
+		 */
+		return FAILED;
+	}
+	memset(delta_ratelist,0,sizeof(DELTARATE)*delta_ratecount);
+	DELTARATE *rate = delta_ratelist;
+	for ( n = 0 ; n < delta_objectcount ; n++ )
+	{
+		OBJECT *obj = delta_objectlist[n];
+		if ( obj->delta_substep <= 0 || obj->oclass->update == NULL )
+			continue;
+		rate->obj = obj;
+		rate->steps = 1;
+		rate++;
+	}
+	qsort(delta_ratelist,delta_ratecount,sizeof(DELTARATE),delta_rate_compare);
+	IN_MYCONTEXT output_verbose("deltamode updates %u object(s) at multiple rates", delta_ratecount);
+	return SUCCESS;
+}
+
+/* compute the update interval of each multi-rate object when deltamode starts */
+static void delta_rate_start(DT timestep)
+{
+	char temp_name_buff[64];
+	DELTARATE *rate;
+	for ( rate = delta_ratelist ; rate < delta_ratelist+delta_ratecount ; rate++ )
+	{
+		DT substep = (DT)(rate->obj->delta_substep*DT_SECOND+0.5);
+		rate->steps = substep > timestep ? (unsigned int)(substep/timestep) : 1;
+		if ( substep % timestep != 0 && ! rate->warned )
+		{
+			output_warning("object '%s' delta_substep %g s is not a multiple of the deltamode timestep, using %g s",
+				object_name(rate->obj,temp_name_buff,63), rate->obj->delta_substep, (double)(rate->steps*timestep)/DT_SECOND);
+			/* TROUBLESHOOT
+			   An object's delta_substep is not an integer multiple of the deltamode timestep the modules requested.
+			   The update interval is rounded down to a multiple of the timestep.  Change the object's delta_substep
+			   to a multiple of the timestep to avoid this warning.
+			 */
+			rate->warned = true;
+		}
+		rate->phase = 0;
+		rate->mode = SM_EVENT;
+	}
+}
+
+/* advance the phase of the multi-rate objects */
+static void delta_rate_advance(void)
+{
+	DELTARATE *rate;
+	for ( rate = delta_ratelist ; rate < delta_ratelist+delta_ratecount ; rate++ )
+	{
+		if ( ++rate->phase == rate->steps )
+			rate->phase = 0;
+	}
+}
+
+/* order objects by class and then by id */
+static int delta_group_compare(const void *a, const void *b)
+{
+	OBJECT *obj_a = *(OBJECT**)a, *obj_b = *(OBJECT**)b;
+	if ( obj_a->oclass->id != obj_b->oclass->id )
+		return obj_a->oclass->id < obj_b->oclass->id ? -1 : 1;
+	return obj_a->id < obj_b->id ? -1 : ( obj_a->id > obj_b->id ? 1 : 0 );
+}
+
+/* partition the object list into one group per rank, each with concurrent and serial objects */
+static STATUS delta_init_groups(void)
+{
+	int n, m;
+	DELTAGROUP *group = NULL;
+
+	delta_taskpool = my_instance->get_exec()->get_taskpool();
+	if ( delta_taskpool == NULL )
+	{
+		IN_MYCONTEXT output_verbose("deltamode_parallel ignored because the sync thread pool is not running");
+		return SUCCESS;
+	}
+	delta_grouplist = (DELTAGROUP*)malloc(sizeof(DELTAGROUP)*delta_objectcount);
+	if ( delta_grouplist == NULL )
+	{
+		output_error("unable to allocate memory for deltamode update groups");
+		/* TROUBLESHOOT
+		  Deltamode operation requires more memory than is available.
+		  Try freeing up memory by making more heap available or making the model smaller. 
+		 */
+		return FAILED;
+	}
+	memset(delta_grouplist,0,sizeof(DELTAGROUP)*delta_objectcount);
+
+	/* objects in the same rank do not depend on each other */
+	for ( n = 0 ; n < delta_objectcount ; n = m )
+	{
+		for ( m = n ; m < delta_objectcount && delta_objectlist[m]->rank == delta_objectlist[n]->rank ; m++ ) {}
+		group = &delta_grouplist[delta_groupcount++];
+		group->object = (void**)malloc(sizeof(void*)*(m-n));
+		group->serial = (OBJECT**)malloc(sizeof(OBJECT*)*(m-n));
+		if ( group->object == NULL || group->serial == NULL )
+		{
+			output_error("unable to allocate memory for deltamode update groups");
+			return FAILED;
+		}
+		for ( int k = n ; k < m ; k++ )
+		{
+			OBJECT *obj = delta_objectlist[k];
+			if ( obj->oclass->update == NULL )
+				continue;
+			if ( (obj->oclass->passconfig&PC_PARALLELUPDATE) == PC_PARALLELUPDATE )
+				group->object[group->n_objects++] = obj;
+			else
+				group->serial[group->n_serial++] = obj;
+		}
+		qsort(group->object,group->n_objects,sizeof(void*),delta_group_compare);
+	}
+	IN_MYCONTEXT output_verbose("deltamode updates use %d thread(s) over %u rank group(s)", 
+		taskpool_get_threadcount(delta_taskpool), delta_groupcount);
+	return SUCCESS;
+}
+
+/* update a single object and merge its result */
+static void delta_update_object(void *arg, unsigned int thread, void *item)
+{
+	DELTACALL *call = (DELTACALL*)arg;
+	OBJECT *obj = (OBJECT*)item;
+	int autolock = obj->oclass->passconfig&PC_AUTOLOCK;
+	int result, mode;
+
+	/* skip objects that are out of service or after an object failed */
+	if ( obj->in_svc_double > global_delta_curr_clock || obj->out_svc_double < global_delta_curr_clock 
+		|| delta_update_error.load(std::memory_order_relaxed) != NULL )
+		return;
+
+	DELTARATE *rate = delta_rate_find(obj);
+	if ( rate != NULL && rate->phase != 0 )
+	{
+		/* not due on this timestep */
+		result = rate->mode;
+	}
+	else
+	{
+		if ( autolock ) wlock(&obj->lock);
+		result = (SIMULATIONMODE)obj->oclass->update(obj,global_clock,global_deltaclock,rate?call->timestep*rate->steps:call->timestep,call->iteration_count);
+		if ( autolock ) wunlock(&obj->lock);
+		if ( rate != NULL )
+			rate->mode = ( result == SM_DELTA_ITER ? SM_DELTA : result );
+	}
+
+	if ( result == SM_ERROR )
+	{
+		OBJECT *none = NULL;
+		delta_update_error.compare_exchange_strong(none,obj);
+	}
+	else if ( result == SM_DELTA || result == SM_DELTA_ITER )
+	{
+		/* lock-free maximum of the mode priorities */
+		mode = delta_update_mode.load(std::memory_order_relaxed);
+		while ( result > mode && ! delta_update_mode.compare_exchange_weak(mode,result,std::memory_order_relaxed) ) {}
+	}
+}
+
+/* update all objects one rank group at a time using the thread pool */
+static SIMULATIONMODE delta_update_groups(DT timestep, unsigned int iteration_count)
+{
+	DELTACALL call = {timestep,iteration_count};
+	unsigned int n;
+	size_t m;
+	delta_update_mode.store(SM_EVENT);
+	delta_update_error.store(NULL);
+	for ( n = 0 ; n < delta_groupcount ; n++ )
+	{
+		DELTAGROUP *group = &delta_grouplist[n];
+		taskpool_run(delta_taskpool,group->object,group->n_objects,delta_update_object,&call,NULL);
+		for ( m = 0 ; m < group->n_serial ; m++ )
+			delta_update_object(&call,0,group->serial[m]);
+		if ( delta_update_error.load() != NULL )
+		{
+			char temp_name_buff[64];
+			output_error("delta_update(): update failed for object \'%s\'", object_name(delta_update_error.load(), temp_name_buff, 63));
+			return SM_ERROR;
+		}
+	}
+	return (SIMULATIONMODE)delta_update_mode.load();
+}
+
 /** Initialize the delta mode code
 
 	This call must be completed before the first call to any delta mode code.
@@ -202,6 +469,18 @@ STATUS delta_init(void)
 	rankcount = NULL;
 	free(ranklist);
 	ranklist = NULL;
+
+	/* build multi-rate update list */
+	if ( delta_init_rates() == FAILED )
+	{
+		return FAILED;
+	}
+
+	/* build parallel update groups */
+	if ( global_deltamode_parallel && delta_init_groups() == FAILED )
+	{
+		return FAILED;
+	}
 Success:
 	profile.t_init += clock() - t;
 	return SUCCESS;
@@ -285,6 +564,9 @@ DT delta_update(void)
 	/* Initialize the forced "post-update" timestep variable */
 	delta_forced_iteration = global_deltamode_forced_extra_timesteps;
 
+	/* Initialize the multi-rate update intervals */
+	delta_rate_start(timestep);
+
 	/* process updates until mode is switched or 1 hour elapses */
 	for ( global_deltaclock=0; global_deltaclock<global_deltamode_maximumtime; global_deltaclock+=timestep )
 	{
@@ -316,43 +598,63 @@ DT delta_update(void)
 			interupdate_mode = SM_EVENT;
 
 			/* Loop through objects with their individual updates */
-			for ( n=0 ; n<delta_objectcount ; n++ )
+			if ( delta_grouplist != NULL )
 			{
-				d_obj = delta_objectlist[n];	/* Shouldn't need NULL checks, since they were done above */
-				d_oclass = d_obj->oclass;
-
-				/* See if the object is in service or not */
-				if ((d_obj->in_svc_double <= global_delta_curr_clock) && (d_obj->out_svc_double >= global_delta_curr_clock))
+				interupdate_mode = delta_update_groups(timestep,delta_iteration_count);
+				if ( interupdate_mode == SM_ERROR )
+					return DT_INVALID;
+			}
+			else
+			{
+				for ( n=0 ; n<delta_objectcount ; n++ )
 				{
-					if ( d_oclass->update )	/* Make sure it exists - init should handle this */
+					d_obj = delta_objectlist[n];	/* Shouldn't need NULL checks, since they were done above */
+					d_oclass = d_obj->oclass;
+
+					/* See if the object is in service or not */
+					if ((d_obj->in_svc_double <= global_delta_curr_clock) && (d_obj->out_svc_double >= global_delta_curr_clock))
 					{
-						/* Call the object-level interupdate */
-						interupdate_mode_result = (SIMULATIONMODE)d_oclass->update(d_obj,global_clock,global_deltaclock,timestep,delta_iteration_count);
-
-						/* Check the status and handle appropriately */
-						switch ( interupdate_mode_result ) {
-							case SM_DELTA_ITER:
-								interupdate_mode = SM_DELTA_ITER;
-								break;
-							case SM_DELTA:
-								if (interupdate_mode != SM_DELTA_ITER)
-									interupdate_mode = SM_DELTA;
-								/* default else - leave it as is (SM_DELTA_ITER) */
-								break;
-							case SM_ERROR:
-								output_error("delta_update(): update failed for object \'%s\'", object_name(d_obj, temp_name_buff, 63));
-								/* TROUBLESHOOT
-								   An object failed to update correctly while operating in deltamode.
-								   Generally, this is an internal error and should be reported to the GridLAB-D developers.
-								 */
-								return DT_INVALID;
-							case SM_EVENT:
-							default: /* mode remains untouched */
-								break;
-						}
-					} /*End update exists */
-				}/* End in service */
-				/* Defaulted else, skip over it (not in service) */
+						if ( d_oclass->update )	/* Make sure it exists - init should handle this */
+						{
+							DELTARATE *rate = delta_rate_find(d_obj);
+							if ( rate != NULL && rate->phase != 0 )
+							{
+								/* Multi-rate object not due on this timestep - hold its last mode */
+								interupdate_mode_result = (SIMULATIONMODE)rate->mode;
+							}
+							else
+							{
+								/* Call the object-level interupdate */
+								interupdate_mode_result = (SIMULATIONMODE)d_oclass->update(d_obj,global_clock,global_deltaclock,rate?timestep*rate->steps:timestep,delta_iteration_count);
+								if ( rate != NULL )
+									rate->mode = ( interupdate_mode_result == SM_DELTA_ITER ? SM_DELTA : interupdate_mode_result );
+							}
+
+							/* Check the status and handle appropriately */
+							switch ( interupdate_mode_result ) {
+								case SM_DELTA_ITER:
+									interupdate_mode = SM_DELTA_ITER;
+									break;
+								case SM_DELTA:
+									if (interupdate_mode != SM_DELTA_ITER)
+										interupdate_mode = SM_DELTA;
+									/* default else - leave it as is (SM_DELTA_ITER) */
+									break;
+								case SM_ERROR:
+									output_error("delta_update(): update failed for object \'%s\'", object_name(d_obj, temp_name_buff, 63));
+									/* TROUBLESHOOT
+									   An object failed to update correctly while operating in deltamode.
+									   Generally, this is an internal error and should be reported to the GridLAB-D developers.
+									 */
+									return DT_INVALID;
+								case SM_EVENT:
+								default: /* mode remains untouched */
+									break;
+							}
+						} /*End update exists */
+					}/* End in service */
+					/* Defaulted else, skip over it (not in service) */
+				}
 			}
 
 			/* send interupdate messages */
@@ -413,6 +715,9 @@ DT delta_update(void)
 			return DT_INVALID;
 		}
 
+		/* count the timesteps until the next update of the multi-rate objects */
+		delta_rate_advance();
+
 		// We have finished the current timestep. Call delta_clockUpdate.
 		clockupdate_result = delta_clockupdate(timestep, interupdate_mode);
 
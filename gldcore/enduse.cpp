@@ -11,6 +11,7 @@ SET_MYCONTEXT(DMC_ENDUSE)
 
 static enduse *enduse_list = NULL;
 static unsigned int n_enduses = 0;
+static unsigned int enduse_generation = 0; /* changes when an enduse is created */
 
 double enduse_get_part(void *x, const char *name)
 {
@@ -93,6 +94,7 @@ int enduse_create(void *ptr)
 	data->next = enduse_list;
 	enduse_list = data;
 	n_enduses++;
+	enduse_generation++;
 
 	// check the power factor
 	data->power_factor = 1.0;
@@ -282,6 +284,116 @@ void *enduse_syncproc(void *ptr)
 	return (void*)0;
 }
 
+/* Enduse batches (see the enduse_batch global and batch.h)
+
+   The enduses are grouped into batches in list order, and the energy and
+   heat gain of each batch are accumulated by a branch-free loop.
+ */
+typedef struct s_endusebatch {
+	BATCH head; /**< batch header */
+	enduse *item[BATCH_CHUNK]; /**< enduses in the batch */
+	double total_r[BATCH_CHUNK]; /**< real part of total power */
+	double total_i[BATCH_CHUNK]; /**< imaginary part of total power */
+	double energy_r[BATCH_CHUNK]; /**< real part of energy */
+	double energy_i[BATCH_CHUNK]; /**< imaginary part of energy */
+	double heatgain[BATCH_CHUNK]; /**< heat gain */
+	double cumulative_heatgain[BATCH_CHUNK]; /**< cumulative heat gain */
+	double dt[BATCH_CHUNK]; /**< hours since the last update */
+	double update[BATCH_CHUNK]; /**< 1 if energy is accumulated, 0 if not */
+} ENDUSEBATCH;
+
+/* group the enduses into batches */
+static bool enduse_batch_build(BATCHLIST *list)
+{
+	enduse *e;
+	ENDUSEBATCH *batch = NULL;
+	for ( e = enduse_list ; e != NULL ; e = e->next )
+	{
+#ifdef _DEBUG
+		if (e->magic!=enduse_magic)
+			throw_exception("enduse '%s' magic number bad", e->name);
+#endif
+		batch = (ENDUSEBATCH*)batch_next(list,(BATCH*)batch);
+		if ( batch == NULL )
+			return false;
+		batch->item[batch->head.n++] = e;
+	}
+	IN_MYCONTEXT output_debug("enduse_batch_build(): %u enduses grouped into %u batches", n_enduses, (unsigned int)list->n_batches);
+	return true;
+}
+
+/* accumulate energy and heat gain the same way enduse_sync() does in PC_PRETOPDOWN 
+   (gcc turns selects on the same condition into branches, so each output has its own loop) */
+BATCH_KERNEL static void enduse_batch_accumulate(size_t n, 
+	const double *total_r, const double *total_i, const double *dt, const double *update, 
+	double *energy_r, double *energy_i, double *heatgain, double *cumulative_heatgain)
+{
+	size_t i;
+	for ( i = 0 ; i < n ; i++ )
+	{
+		double er = energy_r[i], sum = er + total_r[i] * dt[i];
+		energy_r[i] = update[i] > 0 ? sum : er;
+	}
+	for ( i = 0 ; i < n ; i++ )
+	{
+		double ei = energy_i[i], sum = ei + total_i[i] * dt[i];
+		energy_i[i] = update[i] > 0 ? sum : ei;
+	}
+	for ( i = 0 ; i < n ; i++ )
+	{
+		double c = cumulative_heatgain[i], sum = c + heatgain[i] * dt[i];
+		cumulative_heatgain[i] = update[i] > 0 ? sum : c;
+	}
+	for ( i = 0 ; i < n ; i++ )
+	{
+		double q = heatgain[i], h = dt[i];
+		double reset = h > 0.0 ? 0.0 : q;
+		heatgain[i] = update[i] > 0 ? reset : q;
+	}
+}
+
+static void enduse_batch_update(void *arg, unsigned int thread, void *item)
+{
+	ENDUSEBATCH *batch = (ENDUSEBATCH*)item;
+	TIMESTAMP t1 = *(TIMESTAMP*)arg;
+	TIMESTAMP t2 = TS_NEVER;
+	size_t i, n = batch->head.n;
+
+	/* gather */
+	for ( i = 0 ; i < n ; i++ )
+	{
+		enduse *e = batch->item[i];
+		batch->total_r[i] = e->total.Re();
+		batch->total_i[i] = e->total.Im();
+		batch->energy_r[i] = e->energy.Re();
+		batch->energy_i[i] = e->energy.Im();
+		batch->heatgain[i] = e->heatgain;
+		batch->cumulative_heatgain[i] = e->cumulative_heatgain;
+		batch->dt[i] = (double)(t1-e->t_last)/(double)3600;
+		batch->update[i] = e->t_last > TS_ZERO ? 1.0 : 0.0;
+	}
+
+	/* accumulate */
+	enduse_batch_accumulate(n,batch->total_r,batch->total_i,batch->dt,batch->update,
+		batch->energy_r,batch->energy_i,batch->heatgain,batch->cumulative_heatgain);
+
+	/* scatter and find the earliest next event */
+	for ( i = 0 ; i < n ; i++ )
+	{
+		enduse *e = batch->item[i];
+		e->energy.Re() = batch->energy_r[i];
+		e->energy.Im() = batch->energy_i[i];
+		e->heatgain = batch->heatgain[i];
+		e->cumulative_heatgain = batch->cumulative_heatgain[i];
+		e->t_last = t1;
+		if ( e->shape && e->shape->type != MT_UNKNOWN && e->shape->t2 < t2 ) 
+			t2 = e->shape->t2;
+	}
+	batch->head.t2 = t2;
+}
+
+static BATCHLIST enduse_batches = {"enduse",&global_enduse_batch,sizeof(ENDUSEBATCH),enduse_batch_build,enduse_batch_update};
+
 TIMESTAMP enduse_syncall(TIMESTAMP t1)
 {
 	static unsigned int n_threads_ed=0;
@@ -293,8 +405,8 @@ TIMESTAMP enduse_syncall(TIMESTAMP t1)
 	if (n_enduses == 0)
 		return TS_NEVER;
 
-	// number of threads desired
-	if (n_threads_ed==0)
+	// number of threads desired (batches use the sync thread pool instead)
+	if (n_threads_ed==0 && !global_enduse_batch)
 	{
 		enduse *e;
 		size_t n_items, en = 0;
@@ -351,8 +463,15 @@ TIMESTAMP enduse_syncall(TIMESTAMP t1)
 		}
 	}
 
+	// update by batch
+	if ( global_enduse_batch && batch_ready(&enduse_batches,enduse_generation) )
+	{
+		t2 = batch_syncall(&enduse_batches,t1);
+		next_t2_ed = t2;
+	}
+
 	// no threading required
-	if (n_threads_ed<2)
+	else if (n_threads_ed<2)
 	{
 		// process list directly
 		enduse *e;
@@ -87,6 +87,7 @@
 
 #include "gldcore.h"
 #include <sys/resource.h>
+#include <sys/wait.h>
 
 SET_MYCONTEXT(DMC_EXEC)
 
@@ -167,38 +168,29 @@ static void rusage_report(void)
 
 /* TODO: remove these when reentrant code is completed */
 DEPRECATED extern GldMain *my_instance;
-DEPRECATED static MTIITEM exec_commit_get0(MTIITEM item)
+static void exec_taskpool_sync(void *exec, unsigned int thread, void *obj)
 {
-	return my_instance->get_exec()->commit_get0(item);
+	((GldExec*)exec)->ss_do_object_sync(thread,obj);
 }
-DEPRECATED static MTIITEM exec_commit_get1(MTIITEM item)
+static void exec_taskgraph_sync(void *exec, unsigned int thread, void *obj)
 {
-	return my_instance->get_exec()->commit_get1(item);
+	((GldExec*)exec)->dag_do_object_sync(thread,obj);
 }
-DEPRECATED static void exec_commit_call(MTIDATA output, MTIITEM item, MTIDATA input)
+static void exec_taskgraph_init(void *exec, unsigned int thread, void *task)
 {
-	my_instance->get_exec()->commit_call(output,item,input);
+	((GldExec*)exec)->dep_do_object_init(thread,task);
 }
-DEPRECATED static MTIDATA exec_commit_set(MTIDATA to, MTIDATA from)
+static void exec_taskpool_precommit(void *exec, unsigned int thread, void *obj)
 {
-	return my_instance->get_exec()->commit_set(to,from);
+	((GldExec*)exec)->dt_do_object_precommit(thread,obj);
 }
-DEPRECATED static int exec_commit_compare(MTIDATA a, MTIDATA b)
+static void exec_taskpool_commit(void *exec, unsigned int thread, void *obj)
 {
-	return my_instance->get_exec()->commit_compare(a,b);
+	((GldExec*)exec)->dt_do_object_commit(thread,obj);
 }
-DEPRECATED static void exec_commit_gather(MTIDATA a, MTIDATA b)
+static void exec_taskpool_finalize(void *exec, unsigned int thread, void *obj)
 {
-	my_instance->get_exec()->commit_gather(a,b);
-}
-DEPRECATED static int exec_commit_reject(MTI *mti, MTIDATA value)
-{
-	return my_instance->get_exec()->commit_reject(mti,value);
-}
-DEPRECATED static void *exec_obj_syncproc(void *ptr)
-{
-	OBJSYNCDATA *data = (OBJSYNCDATA*)ptr;
-	return data->main->get_exec()->obj_syncproc(data);
+	((GldExec*)exec)->dt_do_object_finalize(thread,obj);
 }
 DEPRECATED void *exec_slave_node_proc(void *args)
 {
@@ -392,11 +384,18 @@ GldExec::GldExec(GldMain *main)
 	thread_data = NULL;
 	cstart = 0;
 	cend = 0;
-	arg_data_array = NULL;
 	object_heartbeats = NULL;
 	n_object_heartbeats = 0;
 	max_object_heartbeats = 0;
-	memset(commit_list,0,sizeof(commit_list));
+	memset(&precommit_table,0,sizeof(precommit_table));
+	memset(commit_table,0,sizeof(commit_table));
+	memset(&finalize_table,0,sizeof(finalize_table));
+	dispatch_result = NULL;
+	n_dispatch_results = 0;
+	dispatch_t0 = dispatch_t2 = TS_NEVER;
+	dispatch_inservice = false;
+	precommit_table.generation = finalize_table.generation = (unsigned long long)-1;
+	commit_table[0].generation = commit_table[1].generation = (unsigned long long)-1;
 	create_scripts = NULL;
 	init_scripts = NULL;
 	precommit_scripts = NULL;
@@ -407,13 +406,21 @@ GldExec::GldExec(GldMain *main)
 	pthread_cond_init(&mls_svr_signal,NULL);
 	mls_created = 0;
 	mls_destroyed = 0;
-	startlock = NULL;
-	donelock = NULL;
-	start = NULL;
-	done = NULL;
-	next_t1 = NULL;
-	donecount = NULL;
-	n_threads = NULL; 
+	taskpool = NULL;
+	memset(rankbucket,0,sizeof(rankbucket));
+	memset(n_rankbuckets,0,sizeof(n_rankbuckets));
+	memset(syncgraph,0,sizeof(syncgraph));
+	sync_abort = false;
+	init_abort = false;
+	init_retry_all = false;
+	memset(pass_stats,0,sizeof(pass_stats));
+	memset(lazy_wake,0,sizeof(lazy_wake));
+	lazy_dirty = NULL;
+	lazy_child_index = NULL;
+	lazy_child = NULL;
+	n_lazy = 0;
+	lazy_epoch = 0;
+	lazy_stats = NULL;
 	main_sync.step_to = TS_NEVER;
 	main_sync.hard_event = 0;
 	main_sync.status = SUCCESS;
@@ -431,8 +438,11 @@ GldExec::GldExec(GldMain *main)
 GldExec::~GldExec(void)
 {
 	if ( object_heartbeats ) free(object_heartbeats);
-	free_simplelinklist(commit_list[0]);
-	free_simplelinklist(commit_list[1]);
+	free(precommit_table.object);
+	free(commit_table[0].object);
+	free(commit_table[1].object);
+	free(finalize_table.object);
+	free(dispatch_result);
 	free_simplelist(create_scripts);
 	free_simplelist(init_scripts);
 	free_simplelist(precommit_scripts);
@@ -441,14 +451,10 @@ GldExec::~GldExec(void)
 	free_simplelist(term_scripts);
 	free_simplelist(script_exports);
 	if ( thread_data ) free(thread_data);
-	if ( arg_data_array ) free(arg_data_array);
-	if ( next_t1 ) free(next_t1);
-	if ( donecount ) free(donecount);
-	if ( n_threads ) free(n_threads);
-	if ( startlock ) free(startlock);
-	if ( donelock ) free(donelock);
-	if ( start ) free(start);
-	if ( done ) free(done);
+	free_rankbuckets();
+	free_syncgraph();
+	free_lazysync();
+	taskpool_destroy(taskpool);
 }
 
 void GldExec::free_simplelist(SIMPLELIST *list)
@@ -461,25 +467,11 @@ void GldExec::free_simplelist(SIMPLELIST *list)
 	}	
 }
 
-void GldExec::free_simplelinklist(SIMPLELINKLIST *list)
-{
-	if ( list )
-	{
-		free_simplelinklist(list->next);
-		free(list);
-	}
-}
-
 struct thread_data *GldExec::create_threaddata(size_t count)
 {
 	return (struct thread_data *)malloc(sizeof(struct thread_data)+sizeof(struct sync_data)*count);
 }
 
-struct arg_data *GldExec::create_argdata(size_t count)
-{
-	return (struct arg_data *)malloc(sizeof(struct arg_data)*count);
-}
-
 void GldExec::run_dump(void)
 {
 	if ( dumpfile[0] == '\0' || dumpinterval==TS_NEVER )
@@ -646,13 +638,13 @@ STATUS GldExec::setup_ranks(void)
 			switch ( passtype[i] )
 			{
 			case PC_PRETOPDOWN:
-				ignore &= (obj->events.presync==NULL);
+				ignore &= (obj->cold->events.presync==NULL);
 				break;
 			case PC_BOTTOMUP:
-				ignore &= (obj->events.sync==NULL);
+				ignore &= (obj->cold->events.sync==NULL);
 				break;
 			case PC_POSTTOPDOWN:				
-				ignore &= (obj->events.postsync==NULL);
+				ignore &= (obj->cold->events.postsync==NULL);
 				break;
 			default:
 				break;
@@ -679,6 +671,352 @@ STATUS GldExec::setup_ranks(void)
 	return SUCCESS;
 }
 
+static int rankbucket_compare(const void *a, const void *b)
+{
+	const char *obj_a = *(const char**)a, *obj_b = *(const char**)b;
+	return obj_a < obj_b ? -1 : ( obj_a > obj_b ? 1 : 0 );
+}
+
+STATUS GldExec::setup_rankbuckets(void)
+{
+	size_t pass;
+	free_rankbuckets();
+	for ( pass = 0 ; ranks[pass] != NULL ; pass++ )
+	{
+		int i;
+		size_t n = 0;
+
+		/* count non-empty ranks */
+		for ( i = PASSINIT(pass) ; PASSCMP(i, pass) ; i += PASSINC(pass) )
+		{
+			if ( ranks[pass]->ordinal[i] != NULL && ranks[pass]->ordinal[i]->size > 0 )
+				n++;
+		}
+		rankbucket[pass] = (RANKBUCKET*)malloc(sizeof(RANKBUCKET)*(n+1));
+		if ( rankbucket[pass] == NULL )
+		{
+			output_error("rank bucket memory allocation failed");
+			return FAILED;
+		}
+		memset(rankbucket[pass],0,sizeof(RANKBUCKET)*(n+1));
+
+		/* copy each rank list into an array in processing order */
+		n = 0;
+		for ( i = PASSINIT(pass) ; PASSCMP(i, pass) ; i += PASSINC(pass) )
+		{
+			GLLIST *list = ranks[pass]->ordinal[i];
+			LISTITEM *item;
+			RANKBUCKET *bucket = &rankbucket[pass][n];
+			if ( list == NULL || list->size == 0 )
+				continue;
+			bucket->rank = i;
+			bucket->object = (void**)malloc(sizeof(void*)*list->size);
+			if ( bucket->object == NULL )
+			{
+				output_error("rank bucket memory allocation failed");
+				return FAILED;
+			}
+			for ( item = list->first ; item != NULL && bucket->n_objects < list->size ; item = item->next )
+				bucket->object[bucket->n_objects++] = item->data;
+
+			/* walk the object slabs sequentially instead of in shuffled order */
+			if ( global_object_arena_rankorder )
+				qsort(bucket->object,bucket->n_objects,sizeof(void*),rankbucket_compare);
+			n++;
+		}
+		n_rankbuckets[pass] = n;
+	}
+	return SUCCESS;
+}
+
+void GldExec::free_rankbuckets(void)
+{
+	size_t pass, n;
+	for ( pass = 0 ; pass < sizeof(rankbucket)/sizeof(rankbucket[0]) ; pass++ )
+	{
+		if ( rankbucket[pass] == NULL )
+			continue;
+		for ( n = 0 ; n < n_rankbuckets[pass] ; n++ )
+			free(rankbucket[pass][n].object);
+		free(rankbucket[pass]);
+		rankbucket[pass] = NULL;
+		n_rankbuckets[pass] = 0;
+	}
+}
+
+/*	The dependency graph of a pass keeps the order of every parent/child pair,
+	using the nearest ancestor that participates in the pass.  Objects whose
+	rank was set explicitly (by a module or the model) or is higher than their
+	children require are pinned, and gates keep every pinned object in the same 
+	order as the rank barriers would relative to all other objects.  Other 
+	objects are free to run as soon as their own parent or children are done.
+ */
+static bool syncgraph_pinned(OBJECT *obj, OBJECTRANK *implied)
+{
+	return (obj->flags&OF_RERANK) == OF_RERANK || obj->rank > implied[obj->id];
+}
+
+STATUS GldExec::setup_syncgraph(void)
+{
+	OBJECT *obj;
+	size_t pass, n_ids = 0;
+	OBJECTRANK *implied;
+	size_t *node;
+
+	free_syncgraph();
+	if ( ! global_sync_dag || taskpool == NULL )
+		return SUCCESS;
+
+	/* find the rank each object needs given only its children */
+	for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		if ( obj->id >= n_ids )
+			n_ids = obj->id+1;
+	}
+	implied = (OBJECTRANK*)malloc(sizeof(OBJECTRANK)*(n_ids+1));
+	node = (size_t*)malloc(sizeof(size_t)*(n_ids+1));
+	if ( implied == NULL || node == NULL )
+	{
+		output_error("sync graph memory allocation failed");
+		free(implied);
+		free(node);
+		return FAILED;
+	}
+	memset(implied,0,sizeof(OBJECTRANK)*(n_ids+1));
+	for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		if ( obj->parent != NULL && obj->rank+1 > implied[obj->parent->id] )
+			implied[obj->parent->id] = obj->rank+1;
+	}
+
+	for ( pass = 0 ; pass < sizeof(rankbucket)/sizeof(rankbucket[0]) ; pass++ )
+	{
+		TASKGRAPH *graph;
+		size_t b, n, n_pinned = 0, n_pinned_before = 0;
+		size_t pinned_gate = (size_t)-1, all_gate = (size_t)-1;
+		if ( rankbucket[pass] == NULL || n_rankbuckets[pass] == 0 )
+			continue;
+		graph = syncgraph[pass] = taskgraph_create();
+		for ( n = 0 ; n < n_ids ; n++ )
+			node[n] = (size_t)-1;
+
+		/* gates are only needed when some objects are pinned */
+		for ( b = 0 ; b < n_rankbuckets[pass] ; b++ )
+		{
+			for ( n = 0 ; n < rankbucket[pass][b].n_objects ; n++ )
+			{
+				obj = (OBJECT*)rankbucket[pass][b].object[n];
+				node[obj->id] = taskgraph_add_node(graph,obj);
+				if ( syncgraph_pinned(obj,implied) )
+					n_pinned++;
+			}
+		}
+
+		for ( b = 0 ; b < n_rankbuckets[pass] ; b++ )
+		{
+			RANKBUCKET *bucket = &rankbucket[pass][b];
+			size_t next_pinned_gate = (size_t)-1, next_all_gate = (size_t)-1;
+			if ( n_pinned > 0 && b+1 < n_rankbuckets[pass] )
+			{
+				/* gates passed once every pinned/every object in this rank and all prior ranks is done */
+				next_pinned_gate = taskgraph_add_node(graph,NULL);
+				next_all_gate = taskgraph_add_node(graph,NULL);
+				if ( pinned_gate != (size_t)-1 )
+					taskgraph_add_edge(graph,pinned_gate,next_pinned_gate);
+				if ( all_gate != (size_t)-1 )
+					taskgraph_add_edge(graph,all_gate,next_all_gate);
+			}
+			for ( n = 0 ; n < bucket->n_objects ; n++ )
+			{
+				OBJECT *dep;
+				bool pinned;
+				obj = (OBJECT*)bucket->object[n];
+				pinned = syncgraph_pinned(obj,implied);
+
+				/* nearest ancestor in this pass (parent goes after child bottom-up, before child top-down) */
+				for ( dep = obj->parent ; dep != NULL && node[dep->id] == (size_t)-1 ; dep = dep->parent ) {}
+				if ( dep != NULL )
+				{
+					if ( passtype[pass] == PC_BOTTOMUP )
+						taskgraph_add_edge(graph,node[obj->id],node[dep->id]);
+					else
+						taskgraph_add_edge(graph,node[dep->id],node[obj->id]);
+				}
+
+				/* pinned objects wait for all prior ranks, others only for prior pinned objects */
+				if ( pinned && all_gate != (size_t)-1 )
+					taskgraph_add_edge(graph,all_gate,node[obj->id]);
+				else if ( ! pinned && n_pinned_before > 0 )
+					taskgraph_add_edge(graph,pinned_gate,node[obj->id]);
+				if ( next_all_gate != (size_t)-1 )
+				{
+					taskgraph_add_edge(graph,node[obj->id],next_all_gate);
+					if ( pinned )
+						taskgraph_add_edge(graph,node[obj->id],next_pinned_gate);
+				}
+			}
+			for ( n = 0 ; n < bucket->n_objects ; n++ )
+			{
+				obj = (OBJECT*)bucket->object[n];
+				if ( syncgraph_pinned(obj,implied) )
+					n_pinned_before++;
+			}
+			if ( next_all_gate != (size_t)-1 )
+			{
+				pinned_gate = next_pinned_gate;
+				all_gate = next_all_gate;
+			}
+		}
+
+		if ( ! taskgraph_compile(graph) )
+		{
+			output_error("sync graph for pass %d has a dependency loop", (int)pass);
+			/* TROUBLESHOOT
+				The dependency graph built from the object parents and ranks contains a cycle.
+				This should not happen when ranks are valid.  Disable sync_dag and report
+				the problem with the model that caused it.
+			 */
+			free(implied);
+			free(node);
+			return FAILED;
+		}
+		IN_MYCONTEXT output_verbose("sync graph for pass %d has %lu pinned object(s) and depth %lu over %lu rank(s)",
+			(int)pass, (unsigned long)n_pinned, (unsigned long)taskgraph_get_depth(graph), (unsigned long)n_rankbuckets[pass]);
+	}
+	free(implied);
+	free(node);
+	return SUCCESS;
+}
+
+void GldExec::free_syncgraph(void)
+{
+	size_t pass;
+	for ( pass = 0 ; pass < sizeof(syncgraph)/sizeof(syncgraph[0]) ; pass++ )
+	{
+		taskgraph_destroy(syncgraph[pass]);
+		syncgraph[pass] = NULL;
+	}
+}
+
+STATUS GldExec::setup_lazysync(void)
+{
+	OBJECT *obj;
+	CLASS *oclass;
+	size_t n, pass;
+
+	free_lazysync();
+	if ( ! global_lazy_sync )
+		return SUCCESS;
+
+	/* apply class list */
+	if ( strcmp(global_lazy_sync_classes,"") != 0 )
+	{
+		char list[1024], *name, *last = NULL;
+		strncpy(list,global_lazy_sync_classes,sizeof(list)-1);
+		list[sizeof(list)-1] = '\0';
+		for ( name = strtok_r(list,", ",&last) ; name != NULL ; name = strtok_r(NULL,", ",&last) )
+		{
+			bool found = false;
+			for ( oclass = class_get_first_class() ; oclass != NULL ; oclass = oclass->next )
+			{
+				if ( strcmp(name,"*") == 0 || strcmp(name,oclass->name) == 0 )
+				{
+					oclass->passconfig = (PASSCONFIG)(oclass->passconfig|PC_LAZYSYNC);
+					found = true;
+				}
+			}
+			if ( ! found )
+			{
+				output_warning("lazy_sync_classes: class '%s' not found", name);
+				/* TROUBLESHOOT
+					The lazy_sync_classes global variable lists a class that is not loaded.
+					Check the spelling of the class name and make sure the module that
+					implements it is loaded.
+				 */
+			}
+		}
+	}
+
+	/* size tables by largest object id */
+	for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		if ( obj->id >= n_lazy )
+			n_lazy = obj->id + 1;
+	}
+	for ( pass = 0 ; pass < sizeof(lazy_wake)/sizeof(lazy_wake[0]) ; pass++ )
+	{
+		/* zero means every object is due on the first iteration */
+		lazy_wake[pass] = (TIMESTAMP*)malloc(sizeof(TIMESTAMP)*n_lazy);
+		if ( lazy_wake[pass] == NULL )
+			return FAILED;
+		memset(lazy_wake[pass],0,sizeof(TIMESTAMP)*n_lazy);
+	}
+	lazy_dirty = (unsigned int*)malloc(sizeof(unsigned int)*n_lazy);
+	lazy_child_index = (size_t*)malloc(sizeof(size_t)*(n_lazy+1));
+	lazy_stats = (LAZYSTATS*)malloc(sizeof(LAZYSTATS)*(global_threadcount>0?global_threadcount:1));
+	if ( lazy_dirty == NULL || lazy_child_index == NULL || lazy_stats == NULL )
+		return FAILED;
+	memset(lazy_dirty,0,sizeof(unsigned int)*n_lazy);
+	memset(lazy_child_index,0,sizeof(size_t)*(n_lazy+1));
+	memset(lazy_stats,0,sizeof(LAZYSTATS)*(global_threadcount>0?global_threadcount:1));
+
+	/* build child lists grouped by parent id */
+	for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		if ( obj->parent != NULL )
+			lazy_child_index[obj->parent->id+1]++;
+	}
+	for ( n = 0 ; n < n_lazy ; n++ )
+		lazy_child_index[n+1] += lazy_child_index[n];
+	lazy_child = (OBJECT**)malloc(sizeof(OBJECT*)*(lazy_child_index[n_lazy]+1));
+	if ( lazy_child == NULL )
+		return FAILED;
+	{
+		size_t *fill = (size_t*)malloc(sizeof(size_t)*n_lazy);
+		if ( fill == NULL )
+			return FAILED;
+		memcpy(fill,lazy_child_index,sizeof(size_t)*n_lazy);
+		for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+		{
+			if ( obj->parent != NULL )
+				lazy_child[fill[obj->parent->id]++] = obj;
+		}
+		free(fill);
+	}
+	lazy_epoch = 1;
+	IN_MYCONTEXT output_verbose("lazy sync enabled for %lu objects with %lu parent links", (unsigned long)n_lazy, (unsigned long)lazy_child_index[n_lazy]);
+	return SUCCESS;
+}
+
+void GldExec::free_lazysync(void)
+{
+	size_t pass;
+	for ( pass = 0 ; pass < sizeof(lazy_wake)/sizeof(lazy_wake[0]) ; pass++ )
+	{
+		if ( lazy_wake[pass] ) free(lazy_wake[pass]);
+		lazy_wake[pass] = NULL;
+	}
+	if ( lazy_dirty ) free(lazy_dirty);
+	if ( lazy_child_index ) free(lazy_child_index);
+	if ( lazy_child ) free(lazy_child);
+	if ( lazy_stats ) free(lazy_stats);
+	lazy_dirty = NULL;
+	lazy_child_index = NULL;
+	lazy_child = NULL;
+	lazy_stats = NULL;
+	n_lazy = 0;
+}
+
+void GldExec::lazy_touch(OBJECT *obj)
+{
+	size_t n;
+	/* dependents must be synced during the rest of this iteration and all of the next */
+	if ( obj->parent != NULL && obj->parent->id < n_lazy )
+		__atomic_store_n(&lazy_dirty[obj->parent->id],lazy_epoch+1,__ATOMIC_RELAXED);
+	for ( n = lazy_child_index[obj->id] ; n < lazy_child_index[obj->id+1] ; n++ )
+		__atomic_store_n(&lazy_dirty[lazy_child[n]->id],lazy_epoch+1,__ATOMIC_RELAXED);
+}
+
 const char *GldExec::simtime(void)
 {
 	static char buffer[64];
@@ -696,6 +1034,61 @@ STATUS GldExec::show_progress(void)
 
 /***********************************************************************/
 /* CHECKPOINTS (DPC Apr 2011) */
+
+/* process writing the last checkpoint, if any */
+static pid_t checkpoint_writer = 0;
+
+/* write a checkpoint file, which only appears when it is complete */
+static STATUS write_checkpoint(const char *fn)
+{
+	char tmp[1024+5];
+	if ( snprintf(tmp,sizeof(tmp),"%s.tmp",fn) >= (int)sizeof(tmp) )
+	{
+		output_error("checkpoint file name '%s' is too long", fn);
+		/* TROUBLESHOOT
+			The name of the checkpoint file is too long to add the temporary
+			file extension.  Use a shorter checkpoint file name.
+		 */
+		return FAILED;
+	}
+	FILE *fp = fopen(tmp,"w");
+	if ( fp==NULL )
+	{
+		output_error("unable to open checkpoint file '%s' for writing", tmp);
+		return FAILED;
+	}
+	size_t len = stream(fp,SF_OUT);
+	if ( fclose(fp)!=0 || len==0 || len==(size_t)-1 )
+	{
+		output_error("checkpoint failure (stream context is %s)",stream_context());
+		unlink(tmp);
+		return FAILED;
+	}
+	if ( rename(tmp,fn)!=0 )
+	{
+		output_error("unable to rename checkpoint file '%s' to '%s'", tmp, fn);
+		return FAILED;
+	}
+	return SUCCESS;
+}
+
+/* wait for the process writing the last checkpoint to finish */
+static void wait_checkpoint(void)
+{
+	int status;
+	if ( checkpoint_writer > 0 && waitpid(checkpoint_writer,&status,0) == checkpoint_writer
+		&& ( ! WIFEXITED(status) || WEXITSTATUS(status) != 0 ) )
+	{
+		output_error("checkpoint writer process %d failed", checkpoint_writer);
+		/* TROUBLESHOOT
+			The process that was forked to write a checkpoint file did not complete successfully.
+			This is usually preceded by a more detailed message that explains why it failed.  You
+			can write checkpoints without forking by setting checkpoint_fork=FALSE.
+		 */
+	}
+	checkpoint_writer = 0;
+}
+
 void GldExec::do_checkpoint(void)
 {
 	/* last checkpoint value */
@@ -746,7 +1139,6 @@ void GldExec::do_checkpoint(void)
 		if ( last_checkpoint + global_checkpoint_interval <= now )
 		{
 			static char fn[1024] = "";
-			FILE *fp = NULL;
 
 			/* default checkpoint filename */
 			if ( strcmp(global_checkpoint_file,"")==0 )
@@ -762,27 +1154,49 @@ void GldExec::do_checkpoint(void)
 					*ext = '\0';
 			}
 
+			/* the last checkpoint must be complete before it is replaced */
+			wait_checkpoint();
+
 			/* delete old checkpoint file if not desired */
 			if ( global_checkpoint_keepall==0 && strcmp(fn,"")!=0 )
 				unlink(fn);
 
 			/* create current checkpoint save filename */
 			sprintf(fn,"%s.%d",global_checkpoint_file,global_checkpoint_seqnum++);
-			fp = fopen(fn,"w");
-			if ( fp==NULL )
-				output_error("unable to open checkpoint file '%s' for writing");
-			else
+
+			/* write from a copy-on-write image of the process so the simulation does not pause */
+			if ( global_checkpoint_fork )
 			{
-				if ( stream(fp,SF_OUT)<=0 )
-					output_error("checkpoint failure (stream context is %s)",stream_context());
-				fclose(fp);
-				last_checkpoint = now;
+				pid_t pid = fork();
+				if ( pid==0 )
+				{
+					_exit(write_checkpoint(fn)==SUCCESS ? 0 : 1);
+				}
+				else if ( pid>0 )
+				{
+					IN_MYCONTEXT output_verbose("checkpoint '%s' is being written by process %d", fn, pid);
+					checkpoint_writer = pid;
+					last_checkpoint = now;
+					return;
+				}
+				output_warning("unable to fork checkpoint writer (%s), writing checkpoint '%s' in the main process", strerror(errno), fn);
 			}
+			if ( write_checkpoint(fn)==SUCCESS )
+				last_checkpoint = now;
 		}
 	}
 
 }
 
+void GldExec::dag_do_object_sync(int thread, void *item)
+{
+	if ( sync_abort )
+		return;
+	ss_do_object_sync(thread,item);
+	if ( get_thread_data()->data[thread].status == FAILED )
+		sync_abort = true;
+}
+
 /***********************************************************************/
 // implement new ss_do_object_sync for pthreads
 void GldExec::ss_do_object_sync(int thread, void *item)
@@ -792,22 +1206,46 @@ void GldExec::ss_do_object_sync(int thread, void *item)
 	OBJECT *obj = (OBJECT *) item;
 	TIMESTAMP this_t;
 	char b[64];
+	bool lazy = ( n_lazy > 0 && obj->id < n_lazy );
+	bool lazy_due = lazy && absolute_timestamp(lazy_wake[pass][obj->id]) <= global_clock;
 
 	//printf("thread %d\t%d\t%s\n", thread, obj->rank, obj->name);
 	//this_t = object_sync(obj, global_clock, passtype[pass]);
 
+	/* lazy sync skips objects that have no event due and no dependent changes */
+	if ( lazy && ! lazy_due 
+		&& (obj->oclass->passconfig&PC_LAZYSYNC) == PC_LAZYSYNC
+		&& __atomic_load_n(&lazy_dirty[obj->id],__ATOMIC_RELAXED) < lazy_epoch )
+	{
+		this_t = lazy_wake[pass][obj->id];
+		lazy_stats[thread].n_skipped++;
+	}
+
 	/* check in and out-of-service dates */
-	if (global_clock<obj->in_svc)
+	else if (global_clock<obj->in_svc)
 		this_t = obj->in_svc; /* yet to go in service */
 	else if ((global_clock==obj->in_svc) && (obj->in_svc_micro != 0))	/* If our in service is a little higher, delay to next time */
 		this_t = obj->in_svc + 1;	/* Technically yet to go into service -- deltamode handled separately */
 	else if (global_clock<=obj->out_svc)
 	{
+		int64 t_trace = trace_active ? trace_now() : 0;
 		this_t = object_sync(obj, global_clock, passtype[pass]);
+		if ( trace_active )
+		{
+			trace_object(thread,obj,pass,t_trace,trace_now());
+		}
 		if (this_t == global_clock)
 		{
 			IN_MYCONTEXT output_verbose("%s: object %s calling for re-sync", simtime(), object_name(obj, b, 63));
 		}
+		if ( lazy )
+		{
+			/* an event or a re-sync request wakes the object's dependents */
+			lazy_wake[pass][obj->id] = this_t;
+			lazy_stats[thread].n_synced++;
+			if ( lazy_due || this_t == global_clock )
+				lazy_touch(obj);
+		}
 
 #ifdef _DEBUG
 		/* sync dumpfile */
@@ -908,25 +1346,23 @@ void GldExec::ss_do_object_sync(int thread, void *item)
 	}
 }
 
-// implement new ss_do_object_sync_list for pthreads
-void *GldExec::ss_do_object_sync_list(void *threadarg)
+/* warn about objects that should have a name but do not */
+static void check_object_names(void)
 {
-	LISTITEM *ptr;
-	int iPtr;
-
-	struct arg_data *mydata = (struct arg_data *) threadarg;
-	int thread = mydata->thread;
-	LISTITEM *item = (LISTITEM*)mydata->item;
-	int incr = mydata->incr;
-
-	iPtr = 0;
-	for (ptr = item; ptr != NULL; ptr=ptr->next) {
-		if (iPtr < incr) {
-			ss_do_object_sync(thread, ptr->data);
-			iPtr++;
+	for ( OBJECT *obj = object_get_first() ; obj != NULL ; obj = obj->next )
+	{
+		if ((obj->oclass->passconfig & PC_FORCE_NAME) == PC_FORCE_NAME)
+		{
+			if (0 == strcmp(obj->name, ""))
+			{
+				output_warning("init: object %s:%d should have a name, but doesn't", obj->oclass->name, obj->id);
+				/* TROUBLESHOOT
+				   The object indicated has been flagged by the module which implements its class as one which must be named
+				   to work properly.  Please provide the object with a name and try again.
+				 */
+			}
 		}
 	}
-	return NULL;
 }
 
 STATUS GldExec::init_by_creation(void)
@@ -1161,23 +1597,304 @@ STATUS GldExec::init_by_deferral()
 	free(def_array);
 	def_array = NULL;
 
-	obj = object_get_first();
-	while (obj != 0)
+	check_object_names();
+	return SUCCESS;
+}
+
+/* Initialization by dependency
+
+	Each object is a node of a task graph with an edge from its parent and
+	from each object named by its init_after header, so that those are
+	initialized first.  Objects whose init is deferred are retried in the
+	next round, but only when one of their dependencies was initialized
+	since the last attempt.  When a round makes no progress, all the
+	deferred objects are retried once more before giving up.  With a single
+	thread the graph is processed in the same order on every run.
+
+	Objects of classes that are not flagged PC_PARALLELINIT are initialized
+	one at a time, and so are objects that have an on_init event because
+	events set the environment of the process.  Objects of flagged classes
+	and objects that have no init at all may be initialized at the same time
+	as any other object.
+ */
+typedef enum {
+	IT_PENDING,		/**< not attempted yet */
+	IT_DONE,		/**< initialized */
+	IT_DEFERRED,	/**< init was deferred */
+	IT_FAILED,		/**< init failed */
+} INITSTATUS;
+typedef struct s_inittask {
+	OBJECT *obj;		/**< object to initialize */
+	OBJECT **after;		/**< objects initialized first (parent first) */
+	size_t n_after;		/**< number of objects initialized first */
+	size_t n_ready;		/**< number of those initialized at the last attempt */
+	size_t node;		/**< task graph node in the current round */
+	INITSTATUS status;	/**< result of the last attempt */
+} INITTASK;
+static pthread_mutex_t init_serial_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* resolve the dependencies of an object */
+static bool init_get_after(INITTASK *task)
+{
+	OBJECT *obj = task->obj;
+	const char *names = obj->cold->init_after;
+	size_t max = ( obj->parent ? 1 : 0 );
+	char *list, *item, *last = NULL;
+	if ( names != NULL )
+	{
+		for ( const char *c = names ; *c != '\0' ; c++ )
+		{
+			if ( *c == ',' )
+				max++;
+		}
+		max++;
+	}
+	if ( max == 0 )
+		return true;
+	task->after = (OBJECT**)malloc(sizeof(OBJECT*)*max);
+	if ( task->after == NULL )
 	{
-		if ((obj->oclass->passconfig & PC_FORCE_NAME) == PC_FORCE_NAME)
+		output_error("init_by_dependency(): memory allocation failed");
+		return false;
+	}
+	if ( obj->parent != NULL )
+		task->after[task->n_after++] = obj->parent;
+	if ( names == NULL )
+		return true;
+	list = strdup(names);
+	if ( list == NULL )
+	{
+		output_error("init_by_dependency(): memory allocation failed");
+		return false;
+	}
+	for ( item = strtok_r(list,", ",&last) ; item != NULL ; item = strtok_r(NULL,", ",&last) )
+	{
+		OBJECT *dep = object_find_name(item);
+		if ( dep == NULL )
 		{
-			if (0 == strcmp(obj->name, ""))
+			char b[64];
+			output_error("init_by_dependency(): object %s init_after object '%s' not found", object_name(obj,b,63), item);
+			/* TROUBLESHOOT
+				The init_after header of the named object lists an object that does not exist.
+				Check the spelling of the object name and try again.
+			 */
+			free(list);
+			return false;
+		}
+		if ( dep != obj && dep != obj->parent && task->n_after < max )
+			task->after[task->n_after++] = dep;
+	}
+	free(list);
+	return true;
+}
+
+void GldExec::dep_do_object_init(int thread, void *item)
+{
+	INITTASK *task = (INITTASK*)item;
+	OBJECT *obj = task->obj;
+	size_t n, n_ready = 0;
+	bool serial;
+	int rv;
+	if ( init_abort )
+		return;
+
+	/* deferred objects are not retried until a dependency changes */
+	for ( n = 0 ; n < task->n_after ; n++ )
+	{
+		if ( (task->after[n]->flags&OF_INIT) == OF_INIT )
+			n_ready++;
+	}
+	if ( task->status == IT_DEFERRED && ! init_retry_all && n_ready == task->n_ready && n_ready < task->n_after )
+		return;
+	task->n_ready = n_ready;
+
+	serial = ( (obj->oclass->passconfig&PC_PARALLELINIT) != PC_PARALLELINIT && obj->oclass->init != NULL )
+		|| obj->cold->events.init != NULL;
+	if ( serial )
+		pthread_mutex_lock(&init_serial_lock);
+	try
+	{
+		rv = object_init(obj);
+	}
+	catch (const char *msg)
+	{
+		output_error("init failure: %s", msg);
+		rv = 0;
+	}
+	if ( serial )
+		pthread_mutex_unlock(&init_serial_lock);
+
+	switch ( rv ) {
+	case 1:
+		wlock(&obj->lock);
+		obj->flags |= OF_INIT;
+		obj->flags &= ~OF_DEFERRED;
+		wunlock(&obj->lock);
+		task->status = IT_DONE;
+		break;
+	case 2:
+		wlock(&obj->lock);
+		obj->flags |= OF_DEFERRED;
+		wunlock(&obj->lock);
+		task->status = IT_DEFERRED;
+		break;
+	default:
+		task->status = IT_FAILED;
+		init_abort = true;
+		break;
+	}
+}
+
+STATUS GldExec::init_by_dependency(void)
+{
+	OBJECT *obj;
+	size_t n, m, n_tasks = 0, n_ids = 0, n_pending, n_done, round = 0;
+	size_t *index, *pending;
+	INITTASK *task;
+	TASKPOOL *pool = NULL;
+	STATUS rv = SUCCESS;
+	char b[64];
+
+	for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		n_tasks++;
+		if ( obj->id >= n_ids )
+			n_ids = obj->id+1;
+	}
+	task = (INITTASK*)calloc(n_tasks+1,sizeof(INITTASK));
+	index = (size_t*)malloc(sizeof(size_t)*(n_ids+1));
+	pending = (size_t*)malloc(sizeof(size_t)*(n_tasks+1));
+	if ( task == NULL || index == NULL || pending == NULL )
+	{
+		output_error("init_by_dependency(): memory allocation failed");
+		free(task);
+		free(index);
+		free(pending);
+		return FAILED;
+	}
+	for ( n = 0, obj = object_get_first() ; obj != NULL ; n++, obj = object_get_next(obj) )
+	{
+		task[n].obj = obj;
+		task[n].status = IT_PENDING;
+		index[obj->id] = n;
+		pending[n] = n;
+		if ( rv == SUCCESS && ! init_get_after(&task[n]) )
+			rv = FAILED;
+	}
+	n_pending = n_tasks;
+
+	/* independent inits run on the sync thread pool, otherwise the caller does them all in order */
+	if ( rv == SUCCESS && global_init_parallel && ! global_debug_mode )
+	{
+		unsigned int n_threads = ( global_threadcount == 0 ? processor_count() : global_threadcount );
+		if ( n_threads > 1 && taskpool == NULL )
+		{
+			taskpool = taskpool_create(n_threads);
+			IN_MYCONTEXT output_verbose("init thread pool started with %d thread(s)", taskpool_get_threadcount(taskpool));
+		}
+		pool = taskpool;
+	}
+	if ( pool == NULL )
+		pool = taskpool_create(1);
+
+	init_abort = false;
+	init_retry_all = false;
+	while ( rv == SUCCESS && n_pending > 0 )
+	{
+		TASKGRAPH *graph;
+		if ( round++ > (size_t)global_init_max_defer )
+		{
+			output_error("init_by_dependency(): exhausted initialization attempts");
+			rv = FAILED;
+			break;
+		}
+
+		/* link each pending object to its pending dependencies */
+		graph = taskgraph_create();
+		for ( n = 0 ; n < n_tasks ; n++ )
+			task[n].node = (size_t)-1;
+		for ( n = 0 ; n < n_pending ; n++ )
+			task[pending[n]].node = taskgraph_add_node(graph,&task[pending[n]]);
+		for ( n = 0 ; n < n_pending ; n++ )
+		{
+			INITTASK *t = &task[pending[n]];
+			for ( m = 0 ; m < t->n_after ; m++ )
 			{
-				output_warning("init: object %s:%d should have a name, but doesn't", obj->oclass->name, obj->id);
+				INITTASK *dep = &task[index[t->after[m]->id]];
+				if ( dep->node != (size_t)-1 )
+					taskgraph_add_edge(graph,dep->node,t->node);
+			}
+		}
+		if ( ! taskgraph_compile(graph) )
+		{
+			output_error("init_by_dependency(): the parent and init_after dependencies of the objects form a loop");
+			/* TROUBLESHOOT
+				The init_after headers of some objects, together with their parents,
+				require an object to be initialized before itself.  Check the init_after
+				headers of the objects and try again.
+			 */
+			taskgraph_destroy(graph);
+			rv = FAILED;
+			break;
+		}
+		taskpool_rungraph(pool,graph,exec_taskgraph_init,this,NULL);
+		taskgraph_destroy(graph);
+
+		/* keep the objects that are not done yet */
+		for ( n = m = n_done = 0 ; n < n_pending ; n++ )
+		{
+			INITTASK *t = &task[pending[n]];
+			if ( t->status == IT_DONE )
+			{
+				n_done++;
+			}
+			else if ( t->status == IT_FAILED )
+			{
+				output_error("init_by_dependency(): object %s initialization failed", object_name(t->obj,b,63));
 				/* TROUBLESHOOT
-				   The object indicated has been flagged by the module which implements its class as one which must be named
-				   to work properly.  Please provide the object with a name and try again.
+					The initialization of the named object has failed.  Make sure that the object's
+					requirements for initialization are satisfied and try again.
 				 */
+				rv = FAILED;
+			}
+			else
+			{
+				pending[m++] = pending[n];
 			}
 		}
-		obj = obj->next;
-	}
-	return SUCCESS;
+		IN_MYCONTEXT output_verbose("init_by_dependency(): round %d initialized %d object(s), %d remaining", (int)round, (int)n_done, (int)m);
+		if ( rv == FAILED )
+		{
+			break;
+		}
+		else if ( n_done > 0 )
+		{
+			init_retry_all = false;
+		}
+		else if ( ! init_retry_all )
+		{
+			init_retry_all = true;
+		}
+		else
+		{
+			output_error("init_by_dependency(): all uninitialized objects deferred, model is unable to initialize");
+			rv = FAILED;
+		}
+		n_pending = m;
+	}
+
+	/* the sync thread pool is started again by exec_start after any scenarios are forked */
+	if ( pool == taskpool )
+		taskpool = NULL;
+	taskpool_destroy(pool);
+	for ( n = 0 ; n < n_tasks ; n++ )
+		free(task[n].after);
+	free(task);
+	free(index);
+	free(pending);
+	if ( rv == SUCCESS )
+		check_object_names();
+	return rv;
 }
 
 STATUS GldExec::init_all(void)
@@ -1218,6 +1935,9 @@ STATUS GldExec::init_all(void)
 		case IS_DEFERRED:
 			rv = init_by_deferral();
 			break;
+		case IS_DEPENDENCY:
+			rv = init_by_dependency();
+			break;
 		case IS_BOTTOMUP:
 			output_fatal("Bottom-up rank-based initialization mode not yet supported");
 			rv = FAILED;
@@ -1280,272 +2000,270 @@ STATUS GldExec::init_all(void)
  */
 
 /**************************************************************************
- ** PRECOMMIT ITERATOR
+ ** DISPATCH TABLES
+ 
+	The objects that implement precommit, commit, or finalize are kept in
+	arrays that are rebuilt only when the object generation changes (see
+	object_get_generation()).  The commit arrays are grouped by class so 
+	that consecutive calls go to the same function, and the in-service 
+	window of the whole array is kept so that the in-service test of each 
+	object can be skipped when all of them are in service.  The precommit 
+	and finalize arrays keep the reverse order of creation and are run 
+	serially, as they always have been, because models may depend on that
+	order.
  **************************************************************************/
-STATUS GldExec::precommit_all(TIMESTAMP t0)
+static bool dispatch_precommit(OBJECT *obj)
 {
-	STATUS rv=SUCCESS;
-	static int first=1;
-	/* TODO implement this multithreaded */
-	static SIMPLELINKLIST *precommit_list = NULL;
-	SIMPLELINKLIST *item;
-	if ( first )
-	{
-		OBJECT *obj;
-		for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+	return obj->oclass->precommit != NULL || obj->cold->events.precommit != NULL;
+}
+static bool dispatch_commit(OBJECT *obj)
+{
+	return ( obj->oclass->commit != NULL || obj->cold->events.commit != NULL )
+		&& (obj->oclass->passconfig&PC_OBSERVER) != PC_OBSERVER;
+}
+static bool dispatch_commit_observer(OBJECT *obj)
+{
+	return ( obj->oclass->commit != NULL || obj->cold->events.commit != NULL )
+		&& (obj->oclass->passconfig&PC_OBSERVER) == PC_OBSERVER;
+}
+static bool dispatch_finalize(OBJECT *obj)
+{
+	return obj->oclass->finalize != NULL || obj->cold->events.finalize != NULL;
+}
+static int dispatchtable_compare(const void *a, const void *b)
+{
+	const OBJECT *obj_a = *(const OBJECT**)a, *obj_b = *(const OBJECT**)b;
+	if ( obj_a->oclass->id != obj_b->oclass->id )
+		return obj_a->oclass->id < obj_b->oclass->id ? -1 : 1;
+	return obj_a->id < obj_b->id ? -1 : ( obj_a->id > obj_b->id ? 1 : 0 );
+}
+
+/* rebuild a dispatch table if objects have changed since it was built */
+static STATUS dispatchtable_update(DISPATCHTABLE *table, bool (*select)(OBJECT*), bool grouped)
+{
+	unsigned long long generation = object_get_generation();
+	OBJECT *obj;
+	size_t n = 0;
+	if ( table->generation == generation )
+		return SUCCESS;
+	table->in_svc = TS_ZERO;
+	table->out_svc = TS_NEVER;
+	table->in_svc_micro = false;
+	for ( obj = object_get_first() ; obj != NULL ; obj = object_get_next(obj) )
+	{
+		if ( ! select(obj) )
+			continue;
+		if ( n == table->max_objects )
 		{
-			if ( obj->oclass->precommit!=NULL || obj->events.precommit!=NULL )
+			size_t size = table->max_objects > 0 ? table->max_objects*2 : 64;
+			void **object = (void**)realloc(table->object,size*sizeof(void*));
+			if ( object == NULL )
 			{
-				item = (SIMPLELINKLIST*)malloc(sizeof(SIMPLELINKLIST));
-				if ( item==NULL )
-				{
-					char name[64];
-					output_error("object %s precommit memory allocation failed", object_name(obj,name,sizeof(name)-1));
-					/* TROUBLESHOOT
-					   Insufficient memory remains to perform the precommit operation.
-					   Free up memory and try again.
-					 */
-					return FAILED;
-				}
-				item->data = (void*)obj;
-				item->next = precommit_list;
-				precommit_list = item;
+				output_error("dispatch table memory allocation failed");
+				/* TROUBLESHOOT
+				   Insufficient memory remains to list the objects that implement the
+				   precommit, commit, or finalize operation.  Free up memory and try again.
+				 */
+				return FAILED;
 			}
+			table->object = object;
+			table->max_objects = size;
 		}
-		first = 0;
+		table->object[n++] = (void*)obj;
+		if ( obj->in_svc > table->in_svc ) table->in_svc = obj->in_svc;
+		if ( obj->out_svc < table->out_svc ) table->out_svc = obj->out_svc;
+		if ( obj->in_svc_micro != 0 || obj->out_svc_micro != 0 ) table->in_svc_micro = true;
 	}
+	table->n_objects = n;
+	if ( grouped )
+	{
+		qsort(table->object,n,sizeof(void*),dispatchtable_compare);
+	}
+	else
+	{
+		/* reverse order of creation */
+		for ( size_t i = 0 ; i < n/2 ; i++ )
+		{
+			void *swap = table->object[i];
+			table->object[i] = table->object[n-1-i];
+			table->object[n-1-i] = swap;
+		}
+	}
+	table->generation = generation;
+	return SUCCESS;
+}
 
-	try 
+TIMESTAMP GldExec::run_dispatchtable(TASKPOOL *pool, DISPATCHTABLE *table, TASKCALL call, TIMESTAMP t0, TIMESTAMP t2)
+{
+	unsigned int n, n_threads = taskpool_get_threadcount(pool);
+	TIMESTAMP next = TS_NEVER;
+	if ( table->n_objects == 0 )
+		return TS_NEVER;
+	if ( n_dispatch_results < n_threads )
 	{
-		for ( item=precommit_list ; item!=NULL ; item=item->next )
+		DISPATCHRESULT *result = (DISPATCHRESULT*)realloc(dispatch_result,n_threads*sizeof(DISPATCHRESULT));
+		if ( result == NULL )
 		{
-			OBJECT *obj = (OBJECT*)item->data;
-			if ((obj->in_svc <= t0 && obj->out_svc >= t0) && (obj->in_svc_micro >= obj->out_svc_micro))
-			{
-				if ( object_precommit(obj, t0)==FAILED )
-				{
-					char name[64];
-					output_error("object %s precommit failed", object_name(obj,name,sizeof(name)-1));
-					/* TROUBLESHOOT
-						The precommit function of the named object has failed.  Make sure that the object's
-						requirements for precommit'ing are satisfied and try again.  (likely internal state aberations)
-					 */
-					rv=FAILED;
-					break;
-				}
-			}
+			output_error("dispatch result memory allocation failed");
+			return TS_INVALID;
 		}
-	} 
-	catch (const char *msg)
+		dispatch_result = result;
+		n_dispatch_results = n_threads;
+	}
+	for ( n = 0 ; n < n_threads ; n++ )
 	{
-		output_error("precommit_all() failure: %s", msg);
-		/* TROUBLESHOOT
-			The precommit'ing procedure failed.  This is usually preceded 
-			by a more detailed message that explains why it failed.  Follow
-			the guidance for that message and try again.
-		 */
-		rv=FAILED;
+		dispatch_result[n].next = TS_NEVER;
+		dispatch_result[n].status = SUCCESS;
 	}
-	return ( rv && module_precommitall(t0) ) ? SUCCESS : FAILED;
+	dispatch_t0 = t0;
+	dispatch_t2 = t2;
+	dispatch_inservice = ( t0 > table->in_svc && t0 <= table->out_svc && ! table->in_svc_micro );
+
+	if ( pool != NULL && table->n_objects > 1 )
+	{
+		taskpool_run(pool,table->object,table->n_objects,call,this,NULL);
+	}
+	else
+	{
+		for ( size_t i = 0 ; i < table->n_objects ; i++ )
+		{
+			call(this,0,table->object[i]);
+			if ( dispatch_result[0].status == FAILED )
+				break;
+		}
+	}
+
+	/* reduce the per-thread results */
+	for ( n = 0 ; n < n_threads ; n++ )
+	{
+		if ( dispatch_result[n].status == FAILED )
+			return TS_INVALID;
+		if ( dispatch_result[n].next < next )
+			next = dispatch_result[n].next;
+	}
+	return next;
 }
 
 /**************************************************************************
- ** COMMIT ITERATOR
+ ** PRECOMMIT ITERATOR
  **************************************************************************/
-/* initialize commit_list - must be called only once */
-int GldExec::commit_init(void)
+void GldExec::dt_do_object_precommit(int thread, void *item)
 {
-	int n_commits = 0;
-	OBJECT *obj;
-	SIMPLELINKLIST *item;
-
-	/* build commit list */
-	for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+	OBJECT *obj = (OBJECT*)item;
+	DISPATCHRESULT *result = &dispatch_result[thread];
+	TIMESTAMP t0 = dispatch_t0;
+	if ( result->status == FAILED )
+		return;
+	if ( ! dispatch_inservice && ! ( (obj->in_svc <= t0 && obj->out_svc >= t0) && (obj->in_svc_micro >= obj->out_svc_micro) ) )
+		return;
+	try
 	{
-		if ( obj->oclass->commit!=NULL || obj->events.commit!=NULL )
+		if ( object_precommit(obj,t0) == FAILED )
 		{
-			/* separate observers */
-			unsigned int pc = ((obj->oclass->passconfig&PC_OBSERVER)==PC_OBSERVER)?1:0;
-			item = (SIMPLELINKLIST*)malloc(sizeof(SIMPLELINKLIST));
-			if ( item==NULL ) 
-				throw_exception("commit_init memory allocation failure");
-			item->data = (void*)obj;
-			item->next = commit_list[pc];
-			commit_list[pc] = item;
-			n_commits++;
+			char name[64];
+			output_error("object %s precommit failed", object_name(obj,name,sizeof(name)-1));
+			/* TROUBLESHOOT
+				The precommit function of the named object has failed.  Make sure that the object's
+				requirements for precommit'ing are satisfied and try again.  (likely internal state aberations)
+			 */
+			result->status = FAILED;
 		}
 	}
-	return n_commits;
-}
-/* commit_list iterator */
-MTIITEM GldExec::commit_get0(MTIITEM item)
-{
-	if ( item==NULL )
-		return (MTIITEM)commit_list[0];
-	else
-		return (MTIITEM)(((SIMPLELINKLIST*)item)->next);
-}
-MTIITEM GldExec::commit_get1(MTIITEM item)
-{
-	if ( item==NULL )
-		return (MTIITEM)commit_list[1];
-	else
-		return (MTIITEM)(((SIMPLELINKLIST*)item)->next);
-}
-/* commit function call */
-void GldExec::commit_call(MTIDATA output, MTIITEM item, MTIDATA input)
-{
-	OBJECT *obj = (OBJECT*)(((SIMPLELINKLIST*)item)->data);
-	TIMESTAMP *t2 = (TIMESTAMP*)output;
-	TIMESTAMP *t0 = (TIMESTAMP*)input;
-	if ( *t0<obj->in_svc )
-		*t2 = obj->in_svc;
-	else if ((*t0 == obj->in_svc) && (obj->in_svc_micro != 0))
-		*t2 = obj->in_svc + 1;
-	else if ( obj->out_svc>=*t0 )
-		*t2 = object_commit(obj,*t0,*t2);
-	else
-		*t2 = TS_NEVER;
+	catch (const char *msg)
+	{
+		output_error("precommit_all() failure: %s", msg);
+		/* TROUBLESHOOT
+			The precommit'ing procedure failed.  This is usually preceded 
+			by a more detailed message that explains why it failed.  Follow
+			the guidance for that message and try again.
+		 */
+		result->status = FAILED;
+	}
 }
-/* commit data set accessor */
-MTIDATA GldExec::commit_set(MTIDATA to, MTIDATA from)
-{
-	/* allocation request */
-	// TODO: it's not clear how this malloc is freed
-	if ( to==NULL ) to = (MTIDATA)malloc(sizeof(TIMESTAMP));
-
-	/* clear request (may follow allocation request) */
-	if ( from==NULL ) *(TIMESTAMP*)to = TS_NEVER;
-	
-	/* copy request */ 
-	else memcpy(to,from,sizeof(TIMESTAMP));	
 
-	return to;
-}
-/* commit data compare accessor */
-int GldExec::commit_compare(MTIDATA a, MTIDATA b)
-{
-	TIMESTAMP t0 = (a?*(TIMESTAMP*)a:TS_NEVER);
-	TIMESTAMP t1 = (b?*(TIMESTAMP*)b:TS_NEVER);
-	if ( t0>t1  ) return 1;
-	if ( t0<t1 ) return -1;
-	return 0;
-}
-/* commit data gather accessor */
-void GldExec::commit_gather(MTIDATA a, MTIDATA b)
-{
-	TIMESTAMP *t0 = (TIMESTAMP*)a;
-	TIMESTAMP *t1 = (TIMESTAMP*)b;
-	if ( a==NULL || b==NULL ) return;
-	if ( *t1<*t0 ) *t0 = *t1;
-}
-/* commit iterator reject test */
-int GldExec::commit_reject(MTI *mti, MTIDATA value)
+STATUS GldExec::precommit_all(TIMESTAMP t0)
 {
-	TIMESTAMP *t1 = (TIMESTAMP*)value;
-	TIMESTAMP *t2 = (TIMESTAMP*)mti->output;
-	if ( value==NULL ) return 0;
-	return ( *t2>*t1 && *t2<TS_NEVER ) ? 1 : 0;
+	STATUS rv = SUCCESS;
+	if ( dispatchtable_update(&precommit_table,dispatch_precommit,false) == FAILED
+		|| run_dispatchtable(NULL,&precommit_table,exec_taskpool_precommit,t0,TS_NEVER) == TS_INVALID )
+	{
+		rv = FAILED;
+	}
+	return ( rv && module_precommitall(t0) ) ? SUCCESS : FAILED;
 }
-/* single threaded version of commit_all */
-TIMESTAMP GldExec::commit_all_st(TIMESTAMP t0, TIMESTAMP t2)
+
+/**************************************************************************
+ ** COMMIT ITERATOR
+ **************************************************************************/
+void GldExec::dt_do_object_commit(int thread, void *item)
 {
-	TIMESTAMP result = TS_NEVER;
-	SIMPLELINKLIST *item;
-	unsigned int pc;
-	for ( pc=0 ; pc<2 ; pc ++ )
+	OBJECT *obj = (OBJECT*)item;
+	DISPATCHRESULT *result = &dispatch_result[thread];
+	TIMESTAMP t0 = dispatch_t0, next;
+	if ( result->status == FAILED )
+		return;
+	if ( ! dispatch_inservice && t0 < obj->in_svc )
+	{
+		next = obj->in_svc;
+	}
+	else if ( ! dispatch_inservice && t0 == obj->in_svc && obj->in_svc_micro != 0 )
 	{
-		for ( item=commit_list[pc] ; item!=NULL ; item=item->next )
+		next = obj->in_svc + 1;
+	}
+	else if ( dispatch_inservice || obj->out_svc >= t0 )
+	{
+		try
 		{
-			OBJECT *obj = (OBJECT*)item->data;
-			if ( t0<obj->in_svc )
-			{
-				if ( obj->in_svc<result ) result = obj->in_svc;
-			}
-			else if ((t0 == obj->in_svc) && (obj->in_svc_micro != 0))
-			{
-				if (obj->in_svc == result)
-					result = obj->in_svc + 1;
-			}
-			else if ( obj->out_svc>=t0 )
-			{
-				TIMESTAMP next = object_commit(obj,t0,t2);
-				if ( next==TS_INVALID )
-				{
-					char name[64];
-					throw_exception("object %s commit failed", object_name(obj,name,sizeof(name)-1));
-					/* TROUBLESHOOT
-						The commit function of the named object has failed.  Make sure that the object's
-						requirements for committing are satisfied and try again.  (likely internal state aberations)
-					 */
-				}
-				if ( next<result ) result = next;
-			}
+			next = object_commit(obj,t0,dispatch_t2);
+		}
+		catch (const char *msg)
+		{
+			output_error("commit_all() failure: %s", msg);
+			/* TROUBLESHOOT
+				The commit'ing procedure failed.  This is usually preceded 
+				by a more detailed message that explains why it failed.  Follow
+				the guidance for that message and try again.
+			 */
+			next = TS_INVALID;
 		}
+		if ( next == TS_INVALID )
+		{
+			char name[64];
+			output_error("object %s commit failed", object_name(obj,name,sizeof(name)-1));
+			/* TROUBLESHOOT
+				The commit function of the named object has failed.  Make sure that the object's
+				requirements for committing are satisfied and try again.  (likely internal state aberations)
+			 */
+			result->status = FAILED;
+			return;
+		}
+	}
+	else
+	{
+		next = TS_NEVER;
 	}
-	return result;
+	if ( next < result->next )
+		result->next = next;
 }
-/* multi-threaded version of commit_all */
+
 TIMESTAMP GldExec::commit_all(TIMESTAMP t0, TIMESTAMP t2)
 {
-	static int n_commits = -1;
-	static MTI *mti[] = {NULL,NULL};
-	static int init_tried = FALSE;
-	MTIDATA input = (MTIDATA)&t0;
-	MTIDATA output = (MTIDATA)&t2;
 	TIMESTAMP result = TS_NEVER;
+	unsigned int pc;
+	static bool (*select[])(OBJECT*) = {dispatch_commit,dispatch_commit_observer};
 
-	try 
+	/* observers are committed after all the other objects */
+	for ( pc = 0 ; pc < 2 ; pc++ )
 	{
-		unsigned int pc;
-
-		/* build commit list */
-		if ( n_commits==-1 ) n_commits = commit_init();
-
-		/* if no commits found, stop here */
-		if ( n_commits==0 )
-		{
-			result = TS_NEVER;
-		}
-		else
+		TIMESTAMP next;
+		if ( dispatchtable_update(&commit_table[pc],select[pc],true) == FAILED )
 		{
-			/* initialize MTI */
-			for ( pc=0 ; pc<2 ; pc++ )
-			{
-				if ( mti[pc]==NULL && global_threadcount!=1 && !init_tried )
-				{
-					/* build mti */
-					static MTIFUNCTIONS fns[] = {
-						{exec_commit_get0, exec_commit_call, exec_commit_set, exec_commit_compare, exec_commit_gather, exec_commit_reject},
-						{exec_commit_get1, exec_commit_call, exec_commit_set, exec_commit_compare, exec_commit_gather, exec_commit_reject},
-					};
-					mti[pc] = mti_init("commit",&fns[pc],8);
-					if ( mti[pc]==NULL )
-					{
-						output_warning("commit_all multi-threaded iterator initialization failed - using single-threaded iterator as fallback");
-						init_tried = TRUE;
-					}
-				}
-
-				/* attempt to run multithreaded iterator */
-				if ( mti[pc]!=NULL && mti_run(output,mti[pc],input) )
-					result = *(TIMESTAMP*)output;
-
-				/* resort to single threaded iterator (which handles both passes) */
-				else if ( pc==0 )
-					result = commit_all_st(t0,t2);
-			}
+			result = TS_INVALID;
+			break;
 		}
-	}
-	catch (const char *msg)
-	{
-		output_error("commit_all() failure: %s", msg);
-		/* TROUBLESHOOT
-			The commit'ing procedure failed.  This is usually preceded 
-			by a more detailed message that explains why it failed.  Follow
-			the guidance for that message and try again.
-		 */
-		result = TS_INVALID;
+		next = run_dispatchtable(taskpool,&commit_table[pc],exec_taskpool_commit,t0,t2);
+		if ( next < result )
+			result = next;
 	}
 	return result && module_commitall(t0) ? TS_NEVER : TS_INVALID;
 }
@@ -1553,57 +2271,25 @@ TIMESTAMP GldExec::commit_all(TIMESTAMP t0, TIMESTAMP t2)
 /**************************************************************************
  ** FINALIZE ITERATOR
  **************************************************************************/
-STATUS GldExec::finalize_all()
+void GldExec::dt_do_object_finalize(int thread, void *item)
 {
-	STATUS rv=SUCCESS;
-	static int first=1;
-	/* TODO implement this multithreaded */
-	static SIMPLELINKLIST *finalize_list = NULL;
-	SIMPLELINKLIST *item;
-	if ( first )
+	OBJECT *obj = (OBJECT*)item;
+	DISPATCHRESULT *result = &dispatch_result[thread];
+	if ( result->status == FAILED )
+		return;
+	try
 	{
-		OBJECT *obj;
-		for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+		if ( object_finalize(obj) == FAILED )
 		{
-			if ( obj->oclass->finalize!=NULL || obj->events.finalize!=NULL )
-			{
-				item = (SIMPLELINKLIST*)malloc(sizeof(SIMPLELINKLIST));
-				if ( item==NULL )
-				{
-					char name[64];
-					output_error("object %s finalize memory allocation failed", object_name(obj,name,sizeof(name)-1));
-					/* TROUBLESHOOT
-					   Insufficient memory remains to perform the finalize operation.
-					   Free up memory and try again.
-					 */
-					return FAILED;
-				}
-				item->data = (void*)obj;
-				item->next = finalize_list;
-				finalize_list = item;
-			}
+			char name[64];
+			output_error("object %s finalize failed", object_name(obj,name,sizeof(name)-1));
+			/* TROUBLESHOOT
+				The finalize function of the named object has failed.  Make sure that the object's
+				requirements for finalizing are satisfied and try again.  (likely internal state aberations)
+			 */
+			result->status = FAILED;
 		}
-		first = 0;
 	}
-
-	try 
-	{
-		for ( item=finalize_list ; item!=NULL ; item=item->next )
-		{
-			OBJECT *obj = (OBJECT*)item->data;
-			if ( object_finalize(obj)==FAILED )
-			{
-				char name[64];
-				output_error("object %s finalize failed", object_name(obj,name,sizeof(name)-1));
-				/* TROUBLESHOOT
-					The finalize function of the named object has failed.  Make sure that the object's
-					requirements for finalizing are satisfied and try again.  (likely internal state aberations)
-				 */
-				rv=FAILED;
-				break;
-			}
-		}
-	} 
 	catch (const char *msg)
 	{
 		output_error("finalize_all() failure: %s", msg);
@@ -1612,9 +2298,17 @@ STATUS GldExec::finalize_all()
 			by a more detailed message that explains why it failed.  Follow
 			the guidance for that message and try again.
 		 */
-		rv=FAILED;
+		result->status = FAILED;
 	}
-	return rv;
+}
+
+STATUS GldExec::finalize_all()
+{
+	if ( dispatchtable_update(&finalize_table,dispatch_finalize,false) == FAILED )
+		return FAILED;
+
+	/* objects may finalize data used by objects created before them, so this is done in order */
+	return run_dispatchtable(NULL,&finalize_table,exec_taskpool_finalize,global_clock,TS_NEVER) == TS_INVALID ? FAILED : SUCCESS;
 }
 
 STATUS GldExec::t_sync_all(PASSCONFIG pass)
@@ -1715,49 +2409,6 @@ void GldExec::sleep(unsigned int usec)
 #endif
 }
 
-void *GldExec::obj_syncproc(OBJSYNCDATA *data)
-{
-	LISTITEM *s;
-	unsigned int n;
-	int i = data->i;
-
-	// begin processing loop
-	while (data->ok)
-	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock[i]);
-
-		// wait for thread start condition)
-		while (data->t0 == next_t1[i]) 
-			pthread_cond_wait(&start[i], &startlock[i]);
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock[i]);
-
-		// process the list for this thread
-		for ( s = data->ls, n = 0 ; s != NULL || n < data->nObj ; s = s->next, n++ ) 
-		{
-			my_instance->get_exec()->ss_do_object_sync(data->n, s->data);
-		}
-
-		// signal completed condition
-		data->t0 = next_t1[i];
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock[i]);
-
-		// signal thread is done for now
-		donecount[i] --; 
-
-		// signal change in done condition
-		pthread_cond_broadcast(&done[i]);
-
-		//unlock access to done count
-		pthread_mutex_unlock(&donelock[i]);
-	}
-	pthread_exit((void*)0);
-	return (void*)0;
-}
-
 /** MAIN LOOP CONTROL ******************************************************************/
 void GldExec::mls_create(void)
 {
@@ -2208,22 +2859,6 @@ void GldExec::wunlock_sync(void)
 	wunlock(&sync_lock);
 }
 
-void GldExec::create_lockdata(int nObjRankList)
-{
-	size_t k;
-	startlock = (pthread_mutex_t*)malloc(sizeof(startlock[0])*nObjRankList);
-	donelock = (pthread_mutex_t*)malloc(sizeof(donelock[0])*nObjRankList);
-	start = (pthread_cond_t*)malloc(sizeof(start[0])*nObjRankList);
-	done = (pthread_cond_t*)malloc(sizeof(done[0])*nObjRankList);
-	for ( k = 0 ; k < (size_t)nObjRankList ; k++ ) 
-	{
-		pthread_mutex_init(&startlock[k], NULL);
-		pthread_mutex_init(&donelock[k], NULL);
-		pthread_cond_init(&start[k], NULL);
-		pthread_cond_init(&done[k], NULL);
-	}
-}
-
 /******************************************************************
  *  MAIN EXEC LOOP
  ******************************************************************/
@@ -2238,19 +2873,9 @@ STATUS GldExec::exec_start(void)
 	int pc_rv = 0; // precommit return value
 	STATUS fnl_rv = FAILED; // finalize all return value
 	time_t started_at = realtime_now(); // for profiler
-	int j, k;
-	LISTITEM *ptr;
-	int incr;
+	int j;
 	INDEX **ranks = getranks();
 
-	// Only setup threadpool for each object rank list at the first iteration;
-	// After the first iteration, setTP = false;
-	bool setTP = true; 
-	//int n_threads; //number of thread used in the threadpool of an object rank list
-	OBJSYNCDATA *thread = NULL;
-
-	int nObjRankList, iObjRankList;
-
 	/* run create scripts, if any */
 	if ( run_createscripts()!=XC_SUCCESS )
 	{
@@ -2262,6 +2887,7 @@ STATUS GldExec::exec_start(void)
 	mls_init();
 
 	/* perform object initialization */
+	clock_t init_time = clock();
 	if ( init_all() == FAILED )
 	{
 		output_error("model initialization failed");
@@ -2272,6 +2898,22 @@ STATUS GldExec::exec_start(void)
 		 */
 		return FAILED;
 	}
+	init_time = clock() - init_time;
+
+	/* no more classes or properties are added once the model is initialized */
+	class_free_retired_property_indexes();
+
+	/* fill property columns, if any */
+	if ( column_init() == FAILED )
+	{
+		output_error("property columns setup failed");
+		/* TROUBLESHOOT
+			The property columns could not be created.  This is usually preceded
+			by a more detailed message that explains why it failed.  Follow
+			the guidance for that message and try again.
+		 */
+		return FAILED;
+	}
 
 	/* establish rank index if necessary */
 	if ( ranks == NULL && setup_ranks() == FAILED )
@@ -2289,6 +2931,17 @@ STATUS GldExec::exec_start(void)
 		ranks = getranks();
 	}
 
+	/* copy rank lists into arrays for the sync loop */
+	if ( setup_rankbuckets() == FAILED )
+	{
+		output_error("rank bucket setup failed");
+		/* TROUBLESHOOT
+			The rank lists could not be copied into the arrays used by the main loop.
+			This is usually caused by a lack of memory.  Free up memory and try again.
+		 */
+		return FAILED;
+	}
+
 	/* run checks */
 	if ( global_runchecks )
 	{
@@ -2301,6 +2954,45 @@ STATUS GldExec::exec_start(void)
 		return SUCCESS;
 	}
 
+	/* restore simulation state from a checkpoint */
+	if ( strcmp(global_checkpoint_restore,"")!=0 && stream_restore(global_checkpoint_restore)==FAILED )
+	{
+		output_error("checkpoint restore failed");
+		/* TROUBLESHOOT
+			The simulation state could not be restored from the checkpoint file.  This is
+			usually preceded by a more detailed message that explains why it failed.  Follow
+			the guidance for that message and try again.
+		 */
+		return FAILED;
+	}
+
+	/* run scenarios in forked copies of the initialized model */
+	if ( strcmp(global_scenario_file,"")!=0 && global_scenario==0 )
+	{
+		/* scenarios must be forked from a single-threaded process */
+		if ( taskpool != NULL )
+		{
+			taskpool_destroy(taskpool);
+			taskpool = NULL;
+		}
+		int scenario = job_scenarios(global_scenario_file);
+		if ( scenario<0 )
+		{
+			output_error("scenarios failed");
+			/* TROUBLESHOOT
+				The scenarios could not be run or at least one of them failed.  This is
+				usually preceded by a more detailed message that explains why it failed.
+				Follow the guidance for that message and try again.
+			 */
+			return FAILED;
+		}
+		else if ( scenario==0 )
+		{
+			/* all scenarios are done */
+			return SUCCESS;
+		}
+	}
+
 	/* enable non-determinism check, if any */
 	if ( global_randomseed != 0 && global_threadcount > 1 )
 	{
@@ -2322,9 +3014,6 @@ STATUS GldExec::exec_start(void)
 			IN_MYCONTEXT output_verbose("using %d helper thread(s)", global_threadcount);
 		}
 
-		/* allocate arg_data_array to store pthreads creation argument */
-		arg_data_array = create_argdata(global_threadcount);
-
 		/* allocate thread synchronization data */
 		init_thread_data();
 		struct thread_data * thread_data = get_thread_data();
@@ -2343,6 +3032,46 @@ STATUS GldExec::exec_start(void)
 		{ 
 			thread_data->data[j].status = SUCCESS;
 		}
+
+		/* start the persistent thread pool (caller is one of the threads) */
+		if ( global_threadcount > 1 && taskpool == NULL )
+		{
+			taskpool = taskpool_create(global_threadcount);
+			IN_MYCONTEXT output_verbose("sync thread pool started with %d thread(s)", taskpool_get_threadcount(taskpool));
+		}
+
+		/* start the sync tracer, if any */
+		if ( trace_init(taskpool ? taskpool_get_threadcount(taskpool) : 1) == FAILED )
+		{
+			output_error("sync tracer setup failed");
+			/* TROUBLESHOOT
+				The buffers needed by the sync tracer could not be allocated.
+				Free up memory or clear profiler_trace and try again.
+			 */
+			return FAILED;
+		}
+
+		/* prepare lazy sync tables */
+		if ( setup_lazysync() == FAILED )
+		{
+			output_error("lazy sync setup failed");
+			/* TROUBLESHOOT
+				The tables needed to run lazy sync could not be allocated.
+				Free up memory or disable lazy_sync and try again.
+			 */
+			return FAILED;
+		}
+
+		/* prepare dependency graphs */
+		if ( setup_syncgraph() == FAILED )
+		{
+			output_error("sync graph setup failed");
+			/* TROUBLESHOOT
+				The dependency graphs needed to run sync_dag could not be built.
+				Follow the guidance for the preceding message or disable sync_dag and try again.
+			 */
+			return FAILED;
+		}
 	}
 	else
 	{
@@ -2409,39 +3138,6 @@ STATUS GldExec::exec_start(void)
 	     */
 	}
 
-	// count how many object rank list in one iteration
-	nObjRankList = 0;
-	/* scan the ranks of objects */
-	for ( pass = 0 ; ranks[pass] != NULL ; pass++ )
-	{
-		int i;
-		/* process object in order of rank using index */
-		for ( i = PASSINIT(pass) ; PASSCMP(i, pass) ; i += PASSINC(pass) )
-		{
-			/* skip empty lists */
-			if (ranks[pass]->ordinal[i] == NULL)
-			{
-				continue;
-			}
-			nObjRankList++; // count how many object rank list in one iteration
-		}
-	}
-
-	/* allocate and initialize thread data */
-	IN_MYCONTEXT output_debug("nObjRankList=%d ",nObjRankList);
-
-	next_t1 = (unsigned int*)malloc(sizeof(next_t1[0])*nObjRankList);
-	memset(next_t1,0,sizeof(next_t1[0])*nObjRankList);
-
-	donecount = (unsigned int*)malloc(sizeof(donecount[0])*nObjRankList);
-	memset(donecount,0,sizeof(donecount[0])*nObjRankList);
-
-	n_threads = (unsigned int*)malloc(sizeof(n_threads[0])*nObjRankList);
-	memset(n_threads,0,sizeof(n_threads[0])*nObjRankList);
-
-	// allocation and nitialize mutex and cond for object rank lists
-	create_lockdata(nObjRankList);
-
 	// global test mode
 	if ( global_test_mode == TRUE )
 	{
@@ -2627,6 +3323,12 @@ STATUS GldExec::exec_start(void)
 			}
 			sync_set(NULL,internal_synctime,false);
 
+			/* dirty flags from the previous iteration expire */
+			if ( n_lazy > 0 )
+			{
+				lazy_epoch++;
+			}
+
 			/* prepare multithreading */
 			if ( ! global_debug_mode )
 			{
@@ -2639,6 +3341,7 @@ STATUS GldExec::exec_start(void)
 			}
 
 			/* run precommit only on first iteration */
+			int64 t_iteration = trace_active ? trace_now() : 0;
 			if ( iteration_counter == global_iteration_limit )
 			{
 				/* run commit scripts, if any */
@@ -2652,13 +3355,16 @@ STATUS GldExec::exec_start(void)
 				{
 					throw("precommit failure");
 				}
+				if ( trace_active )
+				{
+					trace_span(0,"precommit","pass",t_iteration,trace_now());
+				}
 			}
-			iObjRankList = -1;
-
 			/* scan the ranks of objects for each pass */
 			for ( pass = 0 ; ranks[pass] != NULL; pass++ )
 			{
-				int i;
+				size_t i;
+				int64 t_pass = trace_active ? trace_now() : 0;
 
 				/* top-down module events */
 				if ( pass == 0 )
@@ -2680,146 +3386,88 @@ STATUS GldExec::exec_start(void)
 					sync_set(NULL,mt,false);
 				}
 
-				/* process object in order of rank using index */
-				for ( i = PASSINIT(pass) ; PASSCMP(i, pass) ; i += PASSINC(pass) )
-				{
-					/* skip empty lists */
-					if (ranks[pass]->ordinal[i] == NULL) 
-					{
-						continue;
-					}
+				/* property columns are copied again when first read by the objects of this pass */
+				column_pass_begin();
 
-					iObjRankList ++;
+				/* process objects as soon as their dependencies are done */
+				if ( syncgraph[pass] != NULL && ! global_debug_mode )
+				{
+					TASKSTATS stats;
+					sync_abort = false;
+					taskpool_rungraph(taskpool,syncgraph[pass],exec_taskgraph_sync,this,&stats);
+					taskpool_addstats(&pass_stats[pass],&stats);
 
-					if ( global_debug_mode )
+					struct thread_data * thread_data = get_thread_data();
+					for ( j = 0 ; j < thread_data->count ; j++ ) 
 					{
-						LISTITEM *item;
-						for ( item=ranks[pass]->ordinal[i]->first ; item!=NULL ; item=item->next )
+						if ( thread_data->data[j].status == FAILED ) 
 						{
-							OBJECT *obj = (OBJECT*)(item->data);
-							// @todo change debug so it uses sync API
-							if ( exec_debug(&main_sync,passtype[pass],i,obj) == FAILED )
-							{
-								throw("debugger quit");
-							}
+							sync_set(NULL,TS_INVALID,false);
+							throw("synchronization failed");
 						}
 					}
-					else
+				}
+				else
+				{
+					/* process object in order of rank using rank buckets */
+					for ( i = 0 ; i < n_rankbuckets[pass] ; i++ )
 					{
-						//sjin: if global_threadcount == 1, no pthread multhreading
-						if ( global_threadcount == 1 ) 
+						RANKBUCKET *bucket = &rankbucket[pass][i];
+						size_t n;
+						int64 t_rank = trace_active ? trace_now() : 0;
+
+						if ( global_debug_mode )
 						{
-							for ( ptr = ranks[pass]->ordinal[i]->first ; ptr != NULL ; ptr=ptr->next ) 
+							for ( n = 0 ; n < bucket->n_objects ; n++ )
 							{
-								OBJECT *obj = (OBJECT*)(ptr->data);
-								ss_do_object_sync(0, ptr->data);					
-								
-								if (obj->valid_to == TS_INVALID)
+								OBJECT *obj = (OBJECT*)(bucket->object[n]);
+								// @todo change debug so it uses sync API
+								if ( exec_debug(&main_sync,passtype[pass],bucket->rank,obj) == FAILED )
 								{
-									//Get us out of the loop so others don't exec on bad status
-									break;
+									throw("debugger quit");
 								}
-								///printf("%d %s %d\n", obj->id, obj->name, obj->rank);
 							}
-							//printf("\n");
-						} 
-						else 
-						{ 
-							//sjin: implement pthreads
-							unsigned int n_items,objn=0,n;
-							unsigned int n_obj = ranks[pass]->ordinal[i]->size;
-
-							// Only create threadpool for each object rank list at the first iteration. 
-							// Reuse the threadppol of each object rank list at all other iterations.
-							if ( setTP == true ) 
-							{ 
-								incr = (int)ceil((float) n_obj / global_threadcount);
-								// if the number of objects is less than or equal to the number of threads, each thread process one object 
-								if (incr <= 1) {
-									n_threads[iObjRankList] = n_obj;
-									n_items = 1;
-								// if the number of objects is greater than the number of threads, each thread process the same number of 
-								// objects (incr), except that the last thread may process less objects 
-								} 
-								else 
-								{
-									n_threads[iObjRankList] = (int)ceil((float) n_obj / incr);
-									n_items = incr;
-								}
-								if ( (int)n_threads[iObjRankList] > global_threadcount ) 
+						}
+						else
+						{
+							if ( taskpool == NULL ) 
+							{
+								for ( n = 0 ; n < bucket->n_objects ; n++ ) 
 								{
-									throw("Running threads > global_threadcount");
-								}
+									OBJECT *obj = (OBJECT*)(bucket->object[n]);
+									ss_do_object_sync(0, obj);
 
-								// allocate thread list
-								thread = (OBJSYNCDATA*)malloc(sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								memset(thread,0,sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								// assign starting obj for each thread
-								for ( ptr = ranks[pass]->ordinal[i]->first ; ptr != NULL ; ptr = ptr->next )
-								{
-									if (thread[objn].nObj==n_items)
+									if (obj->valid_to == TS_INVALID)
 									{
-										objn++;
+										//Get us out of the loop so others don't exec on bad status
+										break;
 									}
-									if (thread[objn].nObj==0) 
-									{
-										thread[objn].ls=ptr;
-									}
-									thread[objn].nObj++;
 								}
-								// create threads
-								for ( n=0 ; n < n_threads[iObjRankList] ; n++ ) 
+							} 
+							else 
+							{ 
+								TASKSTATS stats;
+								taskpool_run(taskpool,bucket->object,bucket->n_objects,exec_taskpool_sync,this,&stats);
+								taskpool_addstats(&pass_stats[pass],&stats);
+							}
+
+							struct thread_data * thread_data = get_thread_data();
+							for ( j = 0 ; j < thread_data->count ; j++ ) 
+							{
+								if ( thread_data->data[j].status == FAILED ) 
 								{
-									thread[n].ok = true;
-									thread[n].i = iObjRankList;
-									thread[n].main = &instance;
-									if ( pthread_create(&(thread[n].pt),NULL,exec_obj_syncproc,&(thread[n])) != 0 ) 
-									{
-										output_fatal("obj_sync thread creation failed");
-										thread[n].ok = false;
-									} 
-									else
-									{
-										thread[n].n = n;
-									}
+									sync_set(NULL,TS_INVALID,false);
+									throw("synchronization failed");
 								}
 							}
-														
-							// lock access to done count
-							pthread_mutex_lock(&donelock[iObjRankList]);
-							
-							// initialize wait count
-							donecount[iObjRankList] = n_threads[iObjRankList];
-
-							// lock access to start condition
-							pthread_mutex_lock(&startlock[iObjRankList]);
-
-							// update start condition
-							next_t1[iObjRankList] ++;
-
-							// signal all the threads
-							pthread_cond_broadcast(&start[iObjRankList]);
-							// unlock access to start count
-							pthread_mutex_unlock(&startlock[iObjRankList]);
-
-							// begin wait
-							while (donecount[iObjRankList]>0)
-								pthread_cond_wait(&done[iObjRankList],&donelock[iObjRankList]);
-							// unlock done count
-							pthread_mutex_unlock(&donelock[iObjRankList]);
 						}
-
-						struct thread_data * thread_data = get_thread_data();
-						for ( j = 0 ; j < thread_data->count ; j++ ) 
+						if ( trace_active )
 						{
-							if ( thread_data->data[j].status == FAILED ) 
-							{
-								sync_set(NULL,TS_INVALID,false);
-								throw("synchronization failed");
-							}
+							trace_span(0,"rank","rank",t_rank,trace_now(),bucket->rank);
 						}
 					}
 				}
+				column_pass_end();
 
 				/* bottom-up module event */
 				if ( pass == 1 )
@@ -2835,9 +3483,11 @@ STATUS GldExec::exec_start(void)
 				/* run all non-schedule transforms */
 				TIMESTAMP st = transform_syncall(global_clock,(TRANSFORMSOURCE)(XS_ALL&(~(XS_SCHEDULE|XS_LOADSHAPE))));
 				sync_set(NULL,st,false);
+				if ( trace_active )
+				{
+					trace_span(0,trace_passname(pass),"pass",t_pass,trace_now());
+				}
 			}
-			setTP = false;
-
 			if ( ! global_debug_mode )
 			{
 				struct thread_data * thread_data = get_thread_data();
@@ -2883,7 +3533,12 @@ STATUS GldExec::exec_start(void)
 			{
 				OBJECT *obj;
 				TIMESTAMP commit_time = TS_NEVER;
+				int64 t_commit = trace_active ? trace_now() : 0;
 				commit_time = commit_all(global_clock, sync_get(NULL));
+				if ( trace_active )
+				{
+					trace_span(0,"commit","pass",t_commit,trace_now());
+				}
 				if ( absolute_timestamp(commit_time) <= global_clock )
 				{
 					// commit cannot force reiterations, and any event where the time is less than the global clock
@@ -2909,6 +3564,10 @@ STATUS GldExec::exec_start(void)
 
 				/* count number of timesteps */
 				tsteps++;
+				if ( trace_active )
+				{
+					trace_span(0,"iteration","clock",t_iteration,trace_now(),global_clock);
+				}
 			}
 
 			/* check iteration limit */
@@ -3000,6 +3659,9 @@ STATUS GldExec::exec_start(void)
 	//sjin: GetMachineCycleCount
 	cend = (clock_t)clock();
 
+	/* last checkpoint must be complete before exit */
+	wait_checkpoint();
+
 	fnl_rv = finalize_all();
 	if(FAILED == fnl_rv)
 	{
@@ -3019,15 +3681,6 @@ STATUS GldExec::exec_start(void)
 		output_error("termcall %d failed", rc);
 	}
 
-	// Destroy mutex and cond
-	for ( k = 0 ; k < nObjRankList ; k++ ) 
-	{
-		pthread_mutex_destroy(&startlock[k]);
-		pthread_mutex_destroy(&donelock[k]);
-		pthread_cond_destroy(&start[k]);
-		pthread_cond_destroy(&done[k]);
-	}
-
 	/* report performance */
 	if ( global_profiler && ! sync_isinvalid(NULL) )
 	{
@@ -3061,6 +3714,7 @@ STATUS GldExec::exec_start(void)
 		output_profile("Total time              %8.1f seconds", elapsed_wall);
 		output_profile("  Core time             %8.1f seconds (%.1f%%)", (elapsed_wall-sync_time-delta_runtime),(elapsed_wall-sync_time-delta_runtime)/elapsed_wall*100);
 		output_profile("    Compiler            %8.1f seconds (%.1f%%)", (double)loader_time/CLOCKS_PER_SEC,((double)loader_time/CLOCKS_PER_SEC)/elapsed_wall*100);
+		output_profile("    Initialization      %8.1f seconds (%.1f%%)", (double)init_time/CLOCKS_PER_SEC,((double)init_time/CLOCKS_PER_SEC)/elapsed_wall*100);
 		output_profile("    Instances           %8.1f seconds (%.1f%%)", (double)instance_synctime/CLOCKS_PER_SEC,((double)instance_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
 		output_profile("    Random variables    %8.1f seconds (%.1f%%)", (double)randomvar_synctime/CLOCKS_PER_SEC,((double)randomvar_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
 		output_profile("    Schedules           %8.1f seconds (%.1f%%)", (double)schedule_synctime/CLOCKS_PER_SEC,((double)schedule_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
@@ -3084,6 +3738,33 @@ STATUS GldExec::exec_start(void)
 		output_profile("Read lock contention    %7.01lf%%", (my_instance->rlock_spin>0 ? (1-(double)my_instance->rlock_count/(double)my_instance->rlock_spin)*100 : 0));
 		output_profile("Write lock contention   %7.01lf%%", (my_instance->wlock_spin>0 ? (1-(double)my_instance->wlock_count/(double)my_instance->wlock_spin)*100 : 0));
 #endif
+		if ( taskpool != NULL )
+		{
+			const char *passname[] = {"Presync","Sync","Postsync"};
+			for ( pass = 0 ; pass < sizeof(pass_stats)/sizeof(pass_stats[0]) ; pass++ )
+			{
+				TASKSTATS *ps = &pass_stats[pass];
+				char label[64];
+				if ( ps->n_runs == 0 || ps->t_busy_mean <= 0 )
+					continue;
+				snprintf(label,sizeof(label),"%s imbalance",passname[pass]);
+				output_profile("%-24s%8.2lf max/mean (%.1f%% idle, %lu steals)",
+					label, ps->t_busy_max/ps->t_busy_mean, 
+					(1-ps->t_busy_mean/ps->t_busy_max)*100, (unsigned long)ps->n_steals);
+			}
+		}
+		if ( lazy_stats != NULL )
+		{
+			int64 n_synced = 0, n_skipped = 0;
+			for ( j = 0 ; j < global_threadcount ; j++ )
+			{
+				n_synced += lazy_stats[j].n_synced;
+				n_skipped += lazy_stats[j].n_skipped;
+			}
+			output_profile("Lazy sync skipped       %7.1lf%% (%" FMT_INT64 "d of %" FMT_INT64 "d syncs)", 
+				n_synced+n_skipped>0 ? (double)n_skipped/(double)(n_synced+n_skipped)*100 : 0.0,
+				n_skipped, n_synced+n_skipped);
+		}
 		output_profile("Average timestep        %7.0lf seconds/timestep", (double)(global_clock-global_starttime)/tsteps);
 		output_profile("Simulation rate         %7.0lf x realtime", (double)(global_clock-global_starttime)/elapsed_wall);
 		if ( dp->t_count>0 )
@@ -3105,15 +3786,17 @@ STATUS GldExec::exec_start(void)
 			output_profile("Total deltamode runtime %8.1lf s (100%%)", delta_runtime);
 			output_profile("Simulation rate         %8.1lf x realtime", delta_simtime/delta_runtime/1000);
 		}
+		trace_profile();
 		output_profile("\n");
 		object_synctime_profile_dump(NULL);
 	}
 
-	/* terminate links */
-	if ( thread ) 
+	/* save sync trace, if any */
+	if ( strcmp(global_profiler_trace,"") != 0 )
 	{
-		free(thread);
+		trace_save(global_profiler_trace);
 	}
+
 	return sync_getstatus(NULL);
 }
 
@@ -12,6 +12,7 @@
 #include "index.h"
 #include "threadpool.h"
 
+#include <atomic>
 #include <list>
 
 
@@ -128,63 +129,71 @@ DEPRECATED typedef struct s_simplelist
 	struct s_simplelist *next;
 } SIMPLELIST;
 
-/* Typedef: SIMPLELINKLIST
-	See s_simplelinklist
+/*	Structure: s_rankbucket
+		Array of objects in a single rank of a single pass
 
-	Structure: s_simplelinklist
-		A simple link list data structure
+	Fields:
+	rank - the rank of the objects in the bucket
+	n_objects - number of objects in the bucket
+	object - array of objects (as items for the task pool)
+ */
+typedef struct s_rankbucket
+{
+	int rank;
+	size_t n_objects;
+	void **object;
+} RANKBUCKET;
 
-	Todo: Replace with C++ std list
-*/
-DEPRECATED typedef struct s_simplelinklist 
-{ 
-	/* Field: data
-		Reference to the data 
-	 */
-	void *data;
+/*	Structure: s_lazystats
+		Per-thread lazy sync counters
 
-	/* Field: next
-		Reference to the next list item
-	 */
-	struct s_simplelinklist *next;
-} SIMPLELINKLIST;
+	Fields:
+	n_synced - number of object syncs performed
+	n_skipped - number of object syncs skipped
+ */
+typedef struct s_lazystats
+{
+	int64 n_synced;
+	int64 n_skipped;
+	char pad[48];
+} LAZYSTATS;
 
-/*	Structure: s_objsyncdata
+/*	Structure: s_dispatchtable
+		Array of the objects that implement a precommit, commit, or finalize callback
 
 	Fields:
-	main - main instance
-	n - thread id 0~n_threads for this object rank list
-	pt - thread data
-	ok - thread status
-	ls - list
-	nOjb - number of obj in this object rank list
-	t0 - start time
-	i - index of mutex or cond this object rank list uses
+	n_objects - number of objects in the table
+	max_objects - capacity of the object array
+	object - array of objects grouped by class (as items for the task pool)
+	in_svc - latest in-service time of the objects
+	out_svc - earliest out-of-service time of the objects
+	in_svc_micro - flag that some object has an in-service or out-of-service time with microseconds
+	generation - object generation when the table was built
  */
-DEPRECATED typedef struct s_objsyncdata 
+typedef struct s_dispatchtable
 {
-	GldMain *main;
-	unsigned int n; 
-	pthread_t pt;
-	bool ok;
-	LISTITEM *ls;
-	unsigned int nObj; 
-	unsigned int t0;
-	int i; 
-} OBJSYNCDATA;
-
-/*	Structure: arg_data
+	size_t n_objects;
+	size_t max_objects;
+	void **object;
+	TIMESTAMP in_svc;
+	TIMESTAMP out_svc;
+	bool in_svc_micro;
+	unsigned long long generation;
+} DISPATCHTABLE;
+
+/*	Structure: s_dispatchresult
+		Per-thread result of a dispatch table run
 
 	Fields:
-	thread - thread id
-	item - reference to object data
-	incr - increment
+	next - earliest time returned by the objects
+	status - FAILED if an object failed
  */
-DEPRECATED struct arg_data {
-	int thread;
-	void *item;
-	int incr;
-};
+typedef struct s_dispatchresult
+{
+	TIMESTAMP next;
+	STATUS status;
+	char pad[52];
+} DISPATCHRESULT;
 
 /* 	Class: GldExec
 	
@@ -228,11 +237,6 @@ private:
 	 */
 	clock_t cend;
 
-	/* Field: arg_data_array
-		Reference to multithreading argument data
-	 */
-	struct arg_data *arg_data_array;
-
 	/* Field: object_heartbeats
 		Object heartbeat working data
 	 */
@@ -248,10 +252,45 @@ private:
 	 */
 	unsigned int max_object_heartbeats;
 
-	/* Field: commit_list
-		Commit pass data lists
+	/* Field: precommit_table
+		Objects that implement precommit
 	 */
-	SIMPLELINKLIST *commit_list[2];
+	DISPATCHTABLE precommit_table;
+
+	/* Field: commit_table
+		Objects that implement commit (observers are in the second table)
+	 */
+	DISPATCHTABLE commit_table[2];
+
+	/* Field: finalize_table
+		Objects that implement finalize (in reverse order of creation)
+	 */
+	DISPATCHTABLE finalize_table;
+
+	/* Field: dispatch_result
+		Per-thread results of the current dispatch table run
+	 */
+	DISPATCHRESULT *dispatch_result;
+
+	/* Field: n_dispatch_results
+		Number of per-thread results allocated
+	 */
+	unsigned int n_dispatch_results;
+
+	/* Field: dispatch_t0
+		Time passed to the objects by the current dispatch table run
+	 */
+	TIMESTAMP dispatch_t0;
+
+	/* Field: dispatch_t2
+		Next time passed to the objects by the current commit run
+	 */
+	TIMESTAMP dispatch_t2;
+
+	/* Field: dispatch_inservice
+		Flag that all the objects of the current dispatch table run are in service
+	 */
+	bool dispatch_inservice;
 
 	/* Field: create_scripts
 		Create script call list
@@ -308,40 +347,80 @@ private:
 	 */
 	int mls_destroyed;
 
-	/* Field: startlock
-		Execution startup lock variable
+	/* Field: taskpool
+		Persistent thread pool used by the main sync loop
+	 */
+	TASKPOOL *taskpool;
+
+	/* Field: rankbucket
+		Object arrays for each rank of each pass in the order they are processed
+	 */
+	RANKBUCKET *rankbucket[3];
+
+	/* Field: n_rankbuckets
+		Number of rank buckets for each pass
+	 */
+	size_t n_rankbuckets[3];
+
+	/* Field: syncgraph
+		Dependency graph of each pass used when sync_dag is enabled
+	 */
+	TASKGRAPH *syncgraph[3];
+
+	/* Field: sync_abort
+		Flag to stop processing the dependency graph after a sync failure
+	 */
+	std::atomic<bool> sync_abort;
+
+	/* Field: init_abort
+		Flag to stop processing the init dependency graph after an init failure
 	 */
-	pthread_mutex_t *startlock;
+	std::atomic<bool> init_abort;
 
-	/* Field: donelock
-		Execution done lock variable
+	/* Field: init_retry_all
+		Flag to retry deferred objects even if none of their dependencies has changed
 	 */
-	pthread_mutex_t *donelock;
+	bool init_retry_all;
 
-	/* Field: start
-		Mutex condition for start lock
+	/* Field: pass_stats
+		Thread pool load balance statistics for each pass
 	 */
-	pthread_cond_t *start;
+	TASKSTATS pass_stats[3];
 
-	/* Field: done
-		Mutex condition for done lock
+	/* Field: lazy_wake
+		Event time last returned by each object in each pass (indexed by object id)
 	 */
-	pthread_cond_t *done;
+	TIMESTAMP *lazy_wake[3];
 
-	/* Field: next_t1
-		Reference to timestamp values for threads
+	/* Field: lazy_dirty
+		Iteration through which each object must be synced regardless of its event time
 	 */
-	unsigned int *next_t1;
+	unsigned int *lazy_dirty;
 
-	/* Field: donecount
-		Reference to counters for threads
+	/* Field: lazy_child_index
+		Start of each object's children in lazy_child (indexed by object id)
 	 */
-	unsigned int *donecount;
+	size_t *lazy_child_index;
 
-	/* Field: n_threads
-		Reference to number of threads
+	/* Field: lazy_child
+		Children of all objects, grouped by parent
 	 */
-	unsigned int *n_threads;
+	OBJECT **lazy_child;
+
+	/* Field: n_lazy
+		Size of lazy sync arrays
+	 */
+	size_t n_lazy;
+
+	/* Field: lazy_epoch
+		Main loop iteration counter used to expire dirty flags
+	 */
+	unsigned int lazy_epoch;
+
+	/* Field: lazy_stats
+		Lazy sync counters for each thread
+	 */
+	LAZYSTATS *lazy_stats;
 
 	/* Field: main_sync
 		Main time synchronization data
@@ -413,11 +492,6 @@ public:
 	 */
 	DEPRECATED void free_simplelist(SIMPLELIST *list);
 
-	/*	Method: free_simplelinklist
-			Free a simple link list
-	 */
-	DEPRECATED void free_simplelinklist(SIMPLELINKLIST *list);
-
 	/*	Method: create_threaddata
 			Create thread data needed for multithreaded operation
 
@@ -426,13 +500,6 @@ public:
 	*/
 	struct thread_data *create_threaddata(size_t count);
 
-	/*	Method: 
-			
-		Returns:
-
-	*/
-	struct arg_data *create_argdata(size_t count);
-
 	/*	Method: 
 			
 		Returns:
@@ -548,12 +615,10 @@ public:
 	*/
 	void ss_do_object_sync(int thread, void *item);
 
-	/*	Method: 
-			
-		Returns:
-
+	/*	Method: dag_do_object_sync
+			Sync an object released by the dependency graph unless a sync already failed
 	*/
-	void *ss_do_object_sync_list(void *threadarg);
+	void dag_do_object_sync(int thread, void *item);
 
 	/*	Method: 
 			
@@ -576,89 +641,62 @@ public:
 	*/
 	STATUS init_by_deferral();
 
-	/*	Method: 
-			
+	/*	Method: init_by_dependency
+			Initialize the objects after their parents and init_after objects,
+			running independent inits concurrently when init_parallel is enabled
 		Returns:
-
+			SUCCESS or FAILED
 	*/
-	STATUS init_all(void);
-
-	/*	Method: 
-			
-		Returns:
+	STATUS init_by_dependency(void);
 
+	/*	Method: dep_do_object_init
+			Initialize an object released by the init dependency graph
 	*/
-	STATUS precommit_all(TIMESTAMP t0);
+	void dep_do_object_init(int thread, void *item);
 
 	/*	Method: 
 			
 		Returns:
 
 	*/
-	int commit_init(void);
-
-	/*	Method: 
-			
-		Returns:
-
-	*/
-	MTIITEM commit_get0(MTIITEM item);
-
-	/*	Method: 
-			
-		Returns:
-
-	*/
-	MTIITEM commit_get1(MTIITEM item);
+	STATUS init_all(void);
 
 	/*	Method: 
 			
 		Returns:
 
 	*/
-	MTIDATA commit_set(MTIDATA to, MTIDATA from);
+	STATUS precommit_all(TIMESTAMP t0);
 
 	/*	Method: 
 			
 		Returns:
 
 	*/
-	void commit_call(MTIDATA output, MTIITEM item, MTIDATA input);
+	TIMESTAMP commit_all(TIMESTAMP t0, TIMESTAMP t2);
 
-	/*	Method: 
-			
+	/*	Method: run_dispatchtable
+			Call a pass function for each object of a dispatch table, on the
+			thread pool if one is given, otherwise in table order
 		Returns:
-
+			The earliest time returned by the objects, or TS_INVALID if an object failed
 	*/
-	int commit_compare(MTIDATA a, MTIDATA b);
-
-	/*	Method: 
-			
-		Returns:
+	TIMESTAMP run_dispatchtable(TASKPOOL *pool, DISPATCHTABLE *table, TASKCALL call, TIMESTAMP t0, TIMESTAMP t2);
 
+	/*	Method: dt_do_object_precommit
+			Precommit an object of the precommit table
 	*/
-	void commit_gather(MTIDATA a, MTIDATA b);
-
-	/*	Method: 
-			
-		Returns:
+	void dt_do_object_precommit(int thread, void *item);
 
+	/*	Method: dt_do_object_commit
+			Commit an object of a commit table
 	*/
-	int commit_reject(MTI *mti, MTIDATA value);
-
-	/*	Method: 
-			
-		Returns:
+	void dt_do_object_commit(int thread, void *item);
 
+	/*	Method: dt_do_object_finalize
+			Finalize an object of the finalize table
 	*/
-	TIMESTAMP commit_all_st(TIMESTAMP t0, TIMESTAMP t2);
-
-	/*	Method: 
-			
-		Returns:
-
-	*/
-	TIMESTAMP commit_all(TIMESTAMP t0, TIMESTAMP t2);
+	void dt_do_object_finalize(int thread, void *item);
 
 	/*	Method: 
 			
@@ -695,13 +733,6 @@ public:
 	*/
 	void sleep(unsigned int usec);
 
-	/*	Method: 
-			
-		Returns:
-
-	*/
-	void *obj_syncproc(OBJSYNCDATA *data);
-
 	/*	Method: 
 			
 		Returns:
@@ -856,12 +887,60 @@ public:
 	*/
 	void wunlock_sync(void);
 
-	/*	Method: 
-			
+	/*	Method: setup_rankbuckets
+			Copy the rank index lists into arrays used by the sync loop
+
 		Returns:
+			SUCCESS - Rank buckets are ready
+			FAILED - Memory allocation failed
+	*/
+	STATUS setup_rankbuckets(void);
+
+	/*	Method: free_rankbuckets
+			Free the rank bucket arrays
+	*/
+	void free_rankbuckets(void);
 
+	/*	Method: setup_syncgraph
+			Build the dependency graph of each pass from the rank buckets
+
+		Returns:
+			SUCCESS - Dependency graphs are ready (or not enabled)
+			FAILED - A dependency graph could not be built
+	*/
+	STATUS setup_syncgraph(void);
+
+	/*	Method: free_syncgraph
+			Free the dependency graphs
+	*/
+	void free_syncgraph(void);
+
+	/*	Method: setup_lazysync
+			Allocate the event and dependency tables used by lazy sync
+
+		Returns:
+			SUCCESS - Lazy sync is ready (or not enabled)
+			FAILED - Lazy sync could not be setup
+	*/
+	STATUS setup_lazysync(void);
+
+	/*	Method: free_lazysync
+			Free the lazy sync tables
+	*/
+	void free_lazysync(void);
+
+	/*	Method: lazy_touch
+			Mark the parent and children of an object for sync in this and the next iteration
+	*/
+	void lazy_touch(OBJECT *obj);
+
+	/*	Method: get_taskpool
+			Get the persistent thread pool used by the main sync loop
+
+		Returns:
+			Reference to the task pool, or NULL if not running multithreaded
 	*/
-	void create_lockdata(int nObjRankList);
+	inline TASKPOOL *get_taskpool(void) { return taskpool; };
 
 	/*	Method: exec_start
 			Start the execution flow control system
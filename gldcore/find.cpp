@@ -5,6 +5,12 @@
 
 #include "gldcore.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 //SET_MYCONTEXT(DMC_FIND) // 
 
 int compare_int(int64 a, FINDOP op, int64 b)
@@ -160,7 +166,7 @@ int compare(OBJECT *obj, FINDTYPE ftype, FINDOP op, void *value, char *propname)
 	case FT_CLASS: return obj->oclass->module!=NULL && compare_string((char*)obj->oclass->name,op,(char*)value);
 	case FT_ISA: return object_isa(obj,(char*)value);
 	case FT_MODULE: return ( obj->oclass->module!=NULL && compare_string((char*)obj->oclass->module->name,op,(char*)value) );
-	case FT_GROUPID: return compare_string((char*)obj->groupid,op,(char*)value);
+	case FT_GROUPID: return compare_string((char*)obj->cold->groupid,op,(char*)value);
 	case FT_RANK: return compare_int((int64)obj->rank,op,(int64)*(int*)value);
 	case FT_CLOCK: return compare_int((int64)obj->clock,op,(int64)*(TIMESTAMP*)value);
 	//case FT_PROPERTY: return compare_property_alt(obj,propname,op,value);
@@ -201,6 +207,82 @@ FINDLIST *new_list(unsigned int n)
 #define ADDALL(L) ((L).hit_count=object_get_count(),memset((L).result,0xff,(L).result_size))
 #define DELALL(L) ((L).hit_count=object_get_count(),memset((L).result,0x00,(L).result_size))
 
+/* Secondary indexes used to plan find programs (see global_find_index).
+   The indexes are rebuilt whenever the object generation changes (see object_get_generation()).
+ */
+typedef std::vector<OBJECT*> FINDINDEXLIST;
+static struct s_findindex {
+	bool valid;
+	bool ordered; // object ids increase along the object list
+	unsigned long long generation;
+	std::shared_ptr<FINDINDEXLIST> by_id; // replaced on rebuild so scans can keep using the old one
+	std::unordered_map<CLASS*,FINDINDEXLIST> by_class;
+	std::unordered_map<std::string,FINDINDEXLIST> by_groupid;
+	std::unordered_map<OBJECT*,FINDINDEXLIST> by_parent;
+} find_index;
+static LOCKVAR find_index_lock = 0;
+
+static void find_index_build(void)
+{
+	find_index.by_id = std::make_shared<FINDINDEXLIST>();
+	FINDINDEXLIST &by_id = *find_index.by_id;
+	find_index.by_class.clear();
+	find_index.by_groupid.clear();
+	find_index.by_parent.clear();
+	find_index.ordered = true;
+	for ( OBJECT *obj = object_get_first() ; obj != NULL ; obj = obj->next )
+	{
+		if ( obj->id < by_id.size() )
+		{
+			find_index.ordered = false;
+		}
+		else
+		{
+			by_id.resize(obj->id+1,NULL);
+		}
+		by_id[obj->id] = obj;
+		find_index.by_class[obj->oclass].push_back(obj);
+		find_index.by_groupid[(const char*)obj->cold->groupid].push_back(obj);
+		find_index.by_parent[obj->parent].push_back(obj);
+	}
+	find_index.valid = true;
+}
+
+/** Obtain a read lock on the find indexes, rebuilding them if they are stale
+	@return true if the indexes are usable (the caller must call runlock(&find_index_lock)), false if disabled
+ **/
+static bool find_index_acquire(void)
+{
+	if ( ! global_find_index )
+	{
+		return false;
+	}
+	unsigned long long generation = object_get_generation();
+	rlock(&find_index_lock);
+	if ( ! find_index.valid || find_index.generation != generation )
+	{
+		runlock(&find_index_lock);
+		wlock(&find_index_lock);
+		if ( ! find_index.valid || find_index.generation != generation )
+		{
+			find_index_build();
+			find_index.generation = generation;
+		}
+		wunlock(&find_index_lock);
+		rlock(&find_index_lock);
+	}
+	return true;
+}
+
+/* the object id index used by the scans of each thread, which is reused
+   while the object generation does not change so that find_next() only
+   locks the indexes on the first call of a scan after a change */
+static thread_local struct {
+	bool valid;
+	unsigned long long generation;
+	std::shared_ptr<const FINDINDEXLIST> by_id; // NULL if the object ids are not ordered
+} find_scan = {false};
+
 /** Search for objects that match criteria
 	\p start may be a previous search result, or \p FT_NEW.
 	\p FT_NEW starts a new search (starting with all objects)
@@ -265,11 +347,6 @@ FINDLIST *find_objects(FINDLIST *start, ...)
 	double rval;
 	OBJECT *obj;
 	FINDLIST *result = start;
-	if (start==FL_NEW || start==FL_GROUP)
-	{
-		result=new_list(object_get_count());
-		ADDALL(*result);
-	}
 	/* FL_GROUP is something of an interrupt option that constructs a program by parsing string input. */
 	if (start==FL_GROUP)
 	{
@@ -277,14 +354,20 @@ FINDLIST *find_objects(FINDLIST *start, ...)
 		va_list(ptr);
 		va_start(ptr,start);
 		pgm = find_pgm_new(va_arg(ptr,char*));
+		va_end(ptr);
 		if (pgm!=NULL){
-			return find_pgm_run(result,pgm);
+			return find_pgm_run(NULL,pgm); /* a new search can be planned using the find indexes */
 		} else {
-			va_end(ptr);
+			result=new_list(object_get_count());
 			DELALL(*result); /* pgm == NULL */
 			return result;
 		}
 	}
+	if (start==FL_NEW)
+	{
+		result=new_list(object_get_count());
+		ADDALL(*result);
+	}
 	/* if we're not using FL_GROUP, we break apart the va_arg list, taking data inputs in the "correct" type. */
 	for (obj=object_get_first(); obj!=NULL; obj=obj->next)
 	{
@@ -431,6 +514,52 @@ OBJECT *find_first(FINDLIST *list) /**< the search list to scan */
 OBJECT *find_next(FINDLIST *list, /**< the search list to scan */
 				  OBJECT *obj) /**< the current object */
 {
+	/* scan the result bits directly when the object ids are ordered */
+	if ( global_find_index )
+	{
+		unsigned long long generation = object_get_generation();
+		if ( ! find_scan.valid || find_scan.generation != generation )
+		{
+			find_scan.by_id.reset();
+			if ( find_index_acquire() )
+			{
+				if ( find_index.ordered )
+				{
+					find_scan.by_id = find_index.by_id;
+				}
+				runlock(&find_index_lock);
+			}
+			find_scan.generation = generation;
+			find_scan.valid = true;
+		}
+		if ( find_scan.by_id )
+		{
+			const FINDINDEXLIST &by_id = *find_scan.by_id;
+			size_t id = ( obj == NULL ? 0 : obj->id+1 );
+			size_t end = (size_t)list->result_size*8;
+			if ( end > by_id.size() )
+			{
+				end = by_id.size();
+			}
+			while ( id < end )
+			{
+				unsigned int bits = (unsigned char)list->result[id>>3] >> (id&0x7);
+				if ( bits == 0 )
+				{
+					id = (id|0x7)+1;
+					continue;
+				}
+				id += __builtin_ctz(bits);
+				if ( id < end && by_id[id] != NULL )
+				{
+					return by_id[id];
+				}
+				id++;
+			}
+			return NULL;
+		}
+	}
+
 	if (obj==NULL)
 		obj = object_get_first();
 	else
@@ -497,7 +626,7 @@ int compare_isa(void *a, FINDVALUE b)
 /* NOTE: this only works with short-circuiting logic! */
 int compare_string_eq(void *a, FINDVALUE b) 
 {
-	return (char *)a != NULL && strcmp((char*)a,b.string)==0;
+	return *(char **)a != NULL && strcmp(*(char**)a,b.string)==0;
 }
 int compare_string_ne(void *a, FINDVALUE b) 
 { 
@@ -520,6 +649,16 @@ int compare_string_ge(void *a, FINDVALUE b)
 	return *(char **)a != NULL && strcmp(*(char**)a,b.string)>=0;
 }
 
+/* groupid comparisons (the target is the object's cold header data) */
+#define GROUPID(A) ((const char*)(*(OBJECTCOLD**)(A))->groupid)
+int compare_groupid_eq(void *a, FINDVALUE b) { return strcmp(GROUPID(a),b.string)==0; }
+int compare_groupid_ne(void *a, FINDVALUE b) { return strcmp(GROUPID(a),b.string)!=0; }
+int compare_groupid_lt(void *a, FINDVALUE b) { return strcmp(GROUPID(a),b.string)<0; }
+int compare_groupid_gt(void *a, FINDVALUE b) { return strcmp(GROUPID(a),b.string)>0; }
+int compare_groupid_le(void *a, FINDVALUE b) { return strcmp(GROUPID(a),b.string)<=0; }
+int compare_groupid_ge(void *a, FINDVALUE b) { return strcmp(GROUPID(a),b.string)>=0; }
+int compare_groupid_li(void *a, FINDVALUE b) { return match(b.string,GROUPID(a)); }
+
 int compare_pointer_li(void *a, FINDVALUE b) 
 {
 	return 0;
@@ -543,7 +682,7 @@ int compare_real_li(void *a, FINDVALUE b)
 
 int compare_string_li(void *a, FINDVALUE b) 
 {
-	return match(b.string, (char *)a);
+	return *(char **)a != NULL && match(b.string, *(char **)a);
 }
 
 int compare_integer16_li(void *a, FINDVALUE b) 
@@ -698,8 +837,11 @@ FINDPGM *add_pgm(FINDPGM **pgm, COMPAREFUNC op, unsigned short target, FINDVALUE
 	return item;
 }
 
-/** Runs a search engine built by find_pgm_new **/
-FINDLIST *find_pgm_run(FINDLIST *list, FINDPGM *pgm)
+/** Runs a search engine built by find_pgm_new one step at a time
+
+	This is used when the program cannot be compiled (see find_pgm_compile()).
+ **/
+static FINDLIST *find_pgm_interpret(FINDLIST *list, FINDPGM *pgm)
 {
 	if (list==NULL)
 	{
@@ -716,7 +858,248 @@ FINDLIST *find_pgm_run(FINDLIST *list, FINDPGM *pgm)
 			else
 			{	if (pgm->neg) (*pgm->neg)(list,obj); }
 		}
-		find_pgm_run(list,pgm->next);
+		find_pgm_interpret(list,pgm->next);
+	}
+	return list;
+}
+
+/**************************************************************
+ * FIND INDEXES AND COMPILED FIND PROGRAMS
+ **************************************************************/
+
+/* Compiled find program steps
+   The common comparisons are evaluated inline by the filter instead of calling
+   the comparison function with a copy of the find value.
+ */
+typedef enum e_findcode {
+	FC_CALL = 0,
+	FC_POINTER_EQ, FC_POINTER_NE,
+	FC_INTEGER_EQ, FC_INTEGER_NE, FC_INTEGER_LT, FC_INTEGER_GT, FC_INTEGER_LE, FC_INTEGER_GE,
+	FC_REAL_EQ, FC_REAL_NE, FC_REAL_LT, FC_REAL_GT, FC_REAL_LE, FC_REAL_GE,
+	FC_STRING_EQ, FC_GROUPID_EQ,
+} FINDCODE;
+typedef struct s_findstep {
+	FINDCODE code;
+	unsigned short target;
+	COMPAREFUNC call;
+	const FINDVALUE *value;
+} FINDSTEP;
+static struct s_findcodemap {
+	COMPAREFUNC op;
+	FINDCODE code;
+} findcodemap[] = {
+	{compare_pointer_eq, FC_POINTER_EQ}, {compare_pointer_ne, FC_POINTER_NE},
+	{compare_integer_eq, FC_INTEGER_EQ}, {compare_integer_ne, FC_INTEGER_NE},
+	{compare_integer_lt, FC_INTEGER_LT}, {compare_integer_gt, FC_INTEGER_GT},
+	{compare_integer_le, FC_INTEGER_LE}, {compare_integer_ge, FC_INTEGER_GE},
+	{compare_real_eq, FC_REAL_EQ}, {compare_real_ne, FC_REAL_NE},
+	{compare_real_lt, FC_REAL_LT}, {compare_real_gt, FC_REAL_GT},
+	{compare_real_le, FC_REAL_LE}, {compare_real_ge, FC_REAL_GE},
+	{compare_string_eq, FC_STRING_EQ}, {compare_groupid_eq, FC_GROUPID_EQ},
+};
+
+/** Compile a find program into a list of filter steps
+	@return true if the program can be compiled, false if it must be interpreted
+ **/
+static bool find_pgm_compile(FINDPGM *pgm, std::vector<FINDSTEP> &steps)
+{
+	for ( ; pgm != NULL ; pgm = pgm->next )
+	{
+		/* only programs that remove the objects that fail each comparison can be compiled */
+		if ( pgm->pos != NULL || pgm->neg != findlist_del )
+		{
+			return false;
+		}
+		FINDSTEP step = {FC_CALL, pgm->target, pgm->op, &pgm->value};
+		for ( size_t n = 0 ; n < sizeof(findcodemap)/sizeof(findcodemap[0]) ; n++ )
+		{
+			if ( findcodemap[n].op == pgm->op )
+			{
+				step.code = findcodemap[n].code;
+				break;
+			}
+		}
+		steps.push_back(step);
+	}
+	return true;
+}
+
+/** Apply the compiled filter steps to an object
+	@return true if the object satisfies all the steps
+ **/
+static inline bool find_filter(const FINDSTEP *step, size_t n, OBJECT *obj)
+{
+	for ( ; n > 0 ; n--, step++ )
+	{
+		void *a = (void*)((char*)obj+step->target);
+		const FINDVALUE &b = *step->value;
+		bool ok;
+		switch ( step->code ) {
+		case FC_POINTER_EQ: ok = *(void**)a == b.pointer; break;
+		case FC_POINTER_NE: ok = *(void**)a != b.pointer; break;
+		case FC_INTEGER_EQ: ok = *(int32*)a == (int32)b.integer; break;
+		case FC_INTEGER_NE: ok = *(int32*)a != (int32)b.integer; break;
+		case FC_INTEGER_LT: ok = *(int32*)a < (int32)b.integer; break;
+		case FC_INTEGER_GT: ok = *(int32*)a > (int32)b.integer; break;
+		case FC_INTEGER_LE: ok = *(int32*)a <= (int32)b.integer; break;
+		case FC_INTEGER_GE: ok = *(int32*)a >= (int32)b.integer; break;
+		case FC_REAL_EQ: ok = *(double*)a == b.real; break;
+		case FC_REAL_NE: ok = *(double*)a != b.real; break;
+		case FC_REAL_LT: ok = *(double*)a < b.real; break;
+		case FC_REAL_GT: ok = *(double*)a > b.real; break;
+		case FC_REAL_LE: ok = *(double*)a <= b.real; break;
+		case FC_REAL_GE: ok = *(double*)a >= b.real; break;
+		case FC_STRING_EQ: ok = *(char**)a != NULL && strcmp(*(char**)a,b.string) == 0; break;
+		case FC_GROUPID_EQ: ok = strcmp(GROUPID(a),b.string) == 0; break;
+		default: ok = (*step->call)(a,b) != 0; break;
+		}
+		if ( ! ok )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Choose the smallest index list that contains all the objects that can satisfy the steps
+	@return the candidate list, or NULL if no index applies (the index read lock must be held)
+ **/
+static const FINDINDEXLIST *find_plan(const std::vector<FINDSTEP> &steps)
+{
+	static const FINDINDEXLIST none;
+	const FINDINDEXLIST *best = NULL;
+	for ( std::vector<FINDSTEP>::const_iterator step = steps.begin() ; step != steps.end() ; step++ )
+	{
+		const FINDINDEXLIST *candidates = NULL;
+		if ( step->code == FC_POINTER_EQ && step->target == offsetof(OBJECT,oclass) )
+		{
+			std::unordered_map<CLASS*,FINDINDEXLIST>::const_iterator item = find_index.by_class.find((CLASS*)step->value->pointer);
+			candidates = ( item == find_index.by_class.end() ? &none : &(item->second) );
+		}
+		else if ( step->code == FC_POINTER_EQ && step->target == offsetof(OBJECT,parent) )
+		{
+			std::unordered_map<OBJECT*,FINDINDEXLIST>::const_iterator item = find_index.by_parent.find((OBJECT*)step->value->pointer);
+			candidates = ( item == find_index.by_parent.end() ? &none : &(item->second) );
+		}
+		else if ( step->code == FC_GROUPID_EQ )
+		{
+			std::unordered_map<std::string,FINDINDEXLIST>::const_iterator item = find_index.by_groupid.find(step->value->string);
+			candidates = ( item == find_index.by_groupid.end() ? &none : &(item->second) );
+		}
+		if ( candidates != NULL && ( best == NULL || candidates->size() < best->size() ) )
+		{
+			best = candidates;
+		}
+	}
+	return best;
+}
+
+/** List the objects that can satisfy a name step using the object name index
+	@return true if a step compares the object name, false if the name index does not apply
+ **/
+static bool find_plan_name(const std::vector<FINDSTEP> &steps, std::vector<OBJECT*> &candidates)
+{
+	for ( std::vector<FINDSTEP>::const_iterator step = steps.begin() ; step != steps.end() ; step++ )
+	{
+		if ( step->target != offsetof(OBJECT,name) )
+		{
+			continue;
+		}
+		if ( step->code == FC_STRING_EQ )
+		{
+			OBJECT *obj = object_find_name(step->value->string);
+			if ( obj != NULL )
+			{
+				candidates.push_back(obj);
+			}
+			return true;
+		}
+		if ( step->code == FC_CALL && step->call == compare_string_li )
+		{
+			size_t n = object_find_names(step->value->string,NULL,0);
+			candidates.resize(n);
+			if ( n > 0 )
+			{
+				n = object_find_names(step->value->string,&candidates[0],n);
+				candidates.resize(std::min(n,candidates.size()));
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Runs a search engine built by find_pgm_new **/
+FINDLIST *find_pgm_run(FINDLIST *list, FINDPGM *pgm)
+{
+	std::vector<FINDSTEP> steps;
+	if ( ! find_pgm_compile(pgm,steps) )
+	{
+		return find_pgm_interpret(list,pgm);
+	}
+	const FINDSTEP *step = steps.size() > 0 ? &steps[0] : NULL;
+	size_t n_steps = steps.size();
+
+	/* refine an existing result */
+	if ( list != NULL )
+	{
+		for ( OBJECT *obj = find_first(list) ; obj != NULL ; obj = find_next(list,obj) )
+		{
+			if ( ! find_filter(step,n_steps,obj) )
+			{
+				DELOBJ(*list,obj->id);
+			}
+		}
+		return list;
+	}
+
+	/* new search */
+	OBJECT *last = object_get_last();
+	unsigned int size = object_get_count();
+	if ( last != NULL && last->id >= size )
+	{
+		size = last->id+1;
+	}
+	list = new_list(size);
+	if ( list == NULL )
+	{
+		return NULL;
+	}
+	std::vector<OBJECT*> named;
+	if ( find_plan_name(steps,named) )
+	{
+		for ( std::vector<OBJECT*>::const_iterator obj = named.begin() ; obj != named.end() ; obj++ )
+		{
+			if ( (*obj)->id < size && find_filter(step,n_steps,*obj) )
+			{
+				ADDOBJ(*list,(*obj)->id);
+			}
+		}
+		return list;
+	}
+	if ( find_index_acquire() )
+	{
+		const FINDINDEXLIST *candidates = find_plan(steps);
+		if ( candidates != NULL )
+		{
+			for ( FINDINDEXLIST::const_iterator obj = candidates->begin() ; obj != candidates->end() ; obj++ )
+			{
+				if ( (*obj)->id < size && find_filter(step,n_steps,*obj) )
+				{
+					ADDOBJ(*list,(*obj)->id);
+				}
+			}
+			runlock(&find_index_lock);
+			return list;
+		}
+		runlock(&find_index_lock);
+	}
+	for ( OBJECT *obj = object_get_first() ; obj != NULL ; obj = obj->next )
+	{
+		if ( obj->id < size && find_filter(step,n_steps,obj) )
+		{
+			ADDOBJ(*list,obj->id);
+		}
 	}
 	return list;
 }
@@ -920,6 +1303,7 @@ struct s_comparemap {
 	{compare_pointer_li, compare_integer_li, compare_real_li, compare_string_li}, // 
 	{compare_pointer_nl, compare_integer_nl, compare_real_nl, compare_string_nl},
 };
+COMPAREFUNC comparegroupid[] = {compare_groupid_eq, compare_groupid_lt, compare_groupid_gt, compare_groupid_ne, compare_groupid_le, compare_groupid_ge, compare_groupid_li};
 
 int expression(PARSER, FINDPGM **pgm)
 {
@@ -983,7 +1367,7 @@ int expression(PARSER, FINDPGM **pgm)
 			FINDVALUE v;
 			strcpy(v.string, pvalue);
 			//printf("find(): v.string=\"%s\", pvalue=\"%s\"\n", v.string, pvalue);
-			add_pgm(pgm, comparemap[op%7].string, OFFSET(groupid), v, NULL, findlist_del);
+			add_pgm(pgm, comparegroupid[op%7], OFFSET(cold), v, NULL, findlist_del);
 			(*pgm)->constflags = PGMCONSTFLAGS((*pgm)->constflags|CF_GROUPID);
 			ACCEPT;
 			DONE;
@@ -1029,7 +1413,7 @@ int expression(PARSER, FINDPGM **pgm)
 			/* Accept implicitly.  If it's bad, it's bad. -MH */
 			FINDVALUE v;
 			strcpy(v.string, pvalue);
-			add_pgm(pgm, comparemap[op].string, OFFSET(name), v, NULL, findlist_del);
+			add_pgm(pgm, comparemap[op==LIKE?6:(op==UNLIKE?7:op)].string, OFFSET(name), v, NULL, findlist_del);
 			(*pgm)->constflags = PGMCONSTFLAGS((*pgm)->constflags|CF_NAME);
 			ACCEPT;
 			DONE;
@@ -1536,4 +1920,168 @@ int objlist_apply(OBJLIST *list, /**< object list */
 		return n;
 }
 
+/* check that a find program selects the expected objects with and without the find indexes */
+static int find_index_check(const char *label, FINDPGM *pgm, std::vector<OBJECT*> expected, int *ok)
+{
+	int failed = 0;
+	bool use_index = global_find_index;
+	std::sort(expected.begin(),expected.end(),[](OBJECT *a, OBJECT *b){return a->id < b->id;});
+	for ( int n = 0 ; n < 2 ; n++ )
+	{
+		global_find_index = ( n == 1 );
+		FINDLIST *list = find_pgm_run(NULL,pgm);
+		std::vector<OBJECT*> found;
+		for ( OBJECT *obj = find_first(list) ; obj != NULL ; obj = find_next(list,obj) )
+		{
+			found.push_back(obj);
+		}
+		if ( list == NULL || found != expected || list->hit_count != expected.size() )
+		{
+			output_test("%s %s find_index found %d objects instead of %d", label, global_find_index ? "with" : "without", (int)found.size(), (int)expected.size());
+			failed++;
+		}
+		else
+		{
+			(*ok)++;
+		}
+		free(list);
+	}
+	global_find_index = use_index;
+	return failed;
+}
+
+/* check that an aggregation follows the objects selected by its group */
+static int find_index_check_aggregate(const char *label, GldAggregator &aggr, double expected, int *ok)
+{
+	double value = aggr.get_value();
+	if ( value != expected )
+	{
+		output_test("%s aggregate is %g instead of %g", label, value, expected);
+		return 1;
+	}
+	(*ok)++;
+	return 0;
+}
+
+/** Test the find indexes.  The same find programs and aggregations are
+	rerun after the objects of a test class are renamed, reparented,
+	regrouped, created and removed, and must follow each change with and
+	without the find indexes.
+	@return the number of failed tests
+ **/
+int find_index_test(void)
+{
+	int failed = 0, ok = 0;
+	bool use_index = global_find_index;
+	CLASS *oclass = class_get_class_from_classname("find_index_test");
+	OBJECT *p1, *p2, *obj[6], *created;
+	FINDPGM *group_a = NULL, *parent_p2 = NULL, *group_a_p1 = NULL, *renamed = NULL;
+	size_t n;
+
+	output_test("\nBEGIN: find index tests");
+	if ( oclass == NULL )
+	{
+		oclass = class_register(NULL,"find_index_test",sizeof(double),PC_NOSYNC);
+		if ( oclass == NULL || class_define_map(oclass,PT_double,"x",(PROPERTYADDR)0,NULL) < 1 )
+		{
+			output_test("unable to register class 'find_index_test'");
+			failed++;
+			goto Done;
+		}
+	}
+
+	/* p1 has children 0-2 in group A, p2 has children 3-4 in group B, 5 has no parent */
+	p1 = object_create_single(oclass);
+	p2 = object_create_single(oclass);
+	object_set_name(p1,"find_index_test_p1");
+	object_set_name(p2,"find_index_test_p2");
+	for ( n = 0 ; n < sizeof(obj)/sizeof(obj[0]) ; n++ )
+	{
+		obj[n] = object_create_single(oclass);
+		*(double*)(obj[n]+1) = n+1;
+		if ( n < 5 )
+		{
+			object_set_parent(obj[n],n<3?p1:p2);
+			object_set_value_by_name(obj[n],"groupid",n<3?"A":"B");
+		}
+	}
+	group_a = find_pgm_new("class=find_index_test and groupid=A");
+	parent_p2 = find_pgm_new("class=find_index_test and parent=find_index_test_p2");
+	group_a_p1 = find_pgm_new("groupid=A and parent=find_index_test_p1");
+	renamed = find_pgm_new("name=find_index_test_renamed");
+	if ( group_a == NULL || parent_p2 == NULL || group_a_p1 == NULL || renamed == NULL )
+	{
+		output_test("unable to compile the find programs");
+		failed++;
+		goto Done;
+	}
+	{
+		GldAggregator sum_a("sum(x)","class=find_index_test and groupid=A");
+		failed += find_index_check("initial groupid",group_a,{obj[0],obj[1],obj[2]},&ok);
+		failed += find_index_check("initial parent",parent_p2,{obj[3],obj[4]},&ok);
+		failed += find_index_check("initial groupid and parent",group_a_p1,{obj[0],obj[1],obj[2]},&ok);
+		failed += find_index_check("initial name",renamed,{},&ok);
+		failed += find_index_check_aggregate("initial",sum_a,1+2+3,&ok);
+
+		/* rename an unnamed object and then a named one */
+		object_set_name(obj[5],"find_index_test_renamed");
+		failed += find_index_check("name after naming",renamed,{obj[5]},&ok);
+		object_set_name(obj[5],"find_index_test_renamed_again");
+		failed += find_index_check("name after renaming",renamed,{},&ok);
+		if ( object_find_name("find_index_test_renamed") != NULL || object_find_name("find_index_test_renamed_again") != obj[5] )
+		{
+			output_test("renamed object is not found by its new name only");
+			failed++;
+		}
+		else
+			ok++;
+
+		/* reparent */
+		object_set_parent(obj[3],p1);
+		failed += find_index_check("parent after reparenting",parent_p2,{obj[4]},&ok);
+		failed += find_index_check("groupid and parent after reparenting",group_a_p1,{obj[0],obj[1],obj[2]},&ok);
+
+		/* change groupid */
+		object_set_value_by_name(obj[3],"groupid","A");
+		object_set_value_by_name(obj[1],"groupid","B");
+		failed += find_index_check("groupid after regrouping",group_a,{obj[0],obj[2],obj[3]},&ok);
+		failed += find_index_check("groupid and parent after regrouping",group_a_p1,{obj[0],obj[2],obj[3]},&ok);
+		failed += find_index_check_aggregate("after regrouping",sum_a,1+3+4,&ok);
+
+		/* create */
+		created = object_create_single(oclass);
+		*(double*)(created+1) = 100;
+		object_set_parent(created,p2);
+		object_set_value_by_name(created,"groupid","A");
+		failed += find_index_check("groupid after creating",group_a,{obj[0],obj[2],obj[3],created},&ok);
+		failed += find_index_check("parent after creating",parent_p2,{obj[4],created},&ok);
+		failed += find_index_check_aggregate("after creating",sum_a,1+3+4+100,&ok);
+
+		/* remove */
+		object_remove_by_id(obj[2]->id);
+		failed += find_index_check("groupid after removing",group_a,{obj[0],obj[3],created},&ok);
+		failed += find_index_check("groupid and parent after removing",group_a_p1,{obj[0],obj[3]},&ok);
+		failed += find_index_check_aggregate("after removing",sum_a,1+4+100,&ok);
+	}
+
+Done:
+	if ( group_a ) find_pgm_delete(group_a);
+	if ( parent_p2 ) find_pgm_delete(parent_p2);
+	if ( group_a_p1 ) find_pgm_delete(group_a_p1);
+	if ( renamed ) find_pgm_delete(renamed);
+	global_find_index = use_index;
+	if ( failed )
+	{
+		output_error("findindextest: %d find index tests failed--see test.txt for more information",failed);
+		output_test("!!! %d find index tests failed",failed);
+	}
+	else
+	{
+		output_verbose("%d find index tests completed with no errors--see test.txt for details",ok);
+		output_test("findindextest: %d find index tests completed with no errors",ok);
+	}
+	output_test("END: find index tests");
+	return failed;
+}
+
 /**@}*/
@@ -278,6 +278,9 @@ const char *find_file(const char *name, const char *path=NULL, int mode=R_OK, ch
 // Function: find_make_invariant
 FINDPGM *find_make_invariant(FINDPGM *pgm, int mode);
 
+// Function: find_index_test
+int find_index_test(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -77,9 +77,11 @@
 typedef enum e_status {FAILED=FALSE, SUCCESS=TRUE} STATUS;
 
 #include "aggregate.h"
+#include "batch.h"
 #include "build.h"
 #include "class.h"
 #include "cmdarg.h"
+#include "column.h"
 #include "compare.h"
 #include "complex.h"
 #include "console.h"
@@ -95,6 +97,7 @@ typedef enum e_status {FAILED=FALSE, SUCCESS=TRUE} STATUS;
 #include "find.h"
 #include "globals.h"
 #include "gui.h"
+#include "hash.h"
 #include "http_client.h"
 #include "index.h"
 #include "instance.h"
@@ -134,6 +137,7 @@ typedef enum e_status {FAILED=FALSE, SUCCESS=TRUE} STATUS;
 #include "test.h"
 #include "threadpool.h"
 #include "timestamp.h"
+#include "trace.h"
 #include "transform.h"
 #include "ufile.h"
 #include "unit.h"
@@ -12,6 +12,58 @@ SET_MYCONTEXT(DMC_GLOBALS)
 
 DEPRECATED static GLOBALVAR *global_varlist = NULL, *lastvar = NULL;
 
+/* Global variable index
+
+	Variables created by global_create() are indexed by name in an open
+	addressed hash table.  Variables pushed by #include using(...) are put 
+	in front of the list to shadow the created ones and are not indexed, 
+	so find() scans that (usually empty) prefix of the list first.
+ */
+typedef struct s_globalslot {
+	unsigned int hash;
+	GLOBALVAR *var;
+} GLOBALSLOT;
+static GLOBALSLOT *global_index = NULL;
+static size_t global_index_size = 0; /* power of 2 */
+static size_t global_index_count = 0;
+static GLOBALVAR *global_created = NULL; /* first variable created */
+static LOCKVAR global_index_lock = 0;
+
+static void global_index_insert(GLOBALSLOT *slot, size_t size, unsigned int hash, GLOBALVAR *var)
+{
+	size_t n;
+	for ( n = hash&(size-1) ; slot[n].hash != 0 ; n = (n+1)&(size-1) );
+	slot[n].hash = hash;
+	slot[n].var = var;
+}
+
+/* add a created variable to the index, call with global_index_lock held */
+static bool global_index_add(GLOBALVAR *var)
+{
+	if ( (global_index_count+1)*2 > global_index_size )
+	{
+		size_t size = global_index_size ? global_index_size*2 : 1024;
+		GLOBALSLOT *slot = (GLOBALSLOT*)calloc(size,sizeof(GLOBALSLOT));
+		if ( slot == NULL )
+		{
+			return false;
+		}
+		for ( size_t n = 0 ; n < global_index_size ; n++ )
+		{
+			if ( global_index[n].hash != 0 )
+			{
+				global_index_insert(slot,size,global_index[n].hash,global_index[n].var);
+			}
+		}
+		free(global_index);
+		global_index = slot;
+		global_index_size = size;
+	}
+	global_index_insert(global_index,global_index_size,hash_name(var->prop->name),var);
+	global_index_count++;
+	return true;
+}
+
 DEPRECATED static KEYWORD df_keys[] = {
 	{"ISO", DF_ISO, df_keys+1},
 	{"US", DF_US, df_keys+2},
@@ -66,7 +118,8 @@ DEPRECATED static KEYWORD isc_keys[] = {
 	{"CREATION", IS_CREATION, isc_keys+1},
 	{"DEFERRED", IS_DEFERRED, isc_keys+2},
 	{"BOTTOMUP", IS_BOTTOMUP, isc_keys+3},
-	{"TOPDOWN", IS_TOPDOWN, NULL}
+	{"TOPDOWN", IS_TOPDOWN, isc_keys+4},
+	{"DEPENDENCY", IS_DEPENDENCY, NULL}
 };
 
 DEPRECATED static KEYWORD mcf_keys[] = {
@@ -152,7 +205,8 @@ DEPRECATED static KEYWORD dmc_keys[] = {
 		{"VERSION", 	DMC_VERSION, 		dmc_keys+50},
 		{"XCORE", 		DMC_XCORE, 			dmc_keys+51},
 		{"MAIN",		DMC_MAIN,			dmc_keys+52},
-		{"CMDARG",		DMC_CMDARG,			NULL},
+		{"CMDARG",		DMC_CMDARG,			dmc_keys+54},
+		{"COLUMN",		DMC_COLUMN,			NULL},
 };
 DEPRECATED static KEYWORD vtc_keys[] = {
 	{"SYNC",		VTC_SYNC,		vtc_keys+1},
@@ -225,6 +279,8 @@ DEPRECATED static struct s_varmap {
 	{"runchecks", PT_bool, &global_runchecks, PA_PUBLIC, "runchecks enable flag"},
 	{"threadcount", PT_int32, &global_threadcount, PA_PUBLIC, "number of threads to use while using multicore"},
 	{"profiler", PT_bool, &global_profiler, PA_PUBLIC, "profiler enable flag"},
+	{"profiler_trace", PT_char1024, &global_profiler_trace, PA_PUBLIC, "Chrome trace file of the sync spans"},
+	{"profiler_trace_sample", PT_int32, &global_profiler_trace_sample, PA_PUBLIC, "object sync span sampling interval"},
 	{"pauseatexit", PT_bool, &global_pauseatexit, PA_PUBLIC, "pause at exit flag"},
 	{"testoutputfile", PT_char1024, &global_testoutputfile, PA_PUBLIC, "filename for test output"},
 	{"xml_encoding", PT_int32, &global_xml_encoding, PA_PUBLIC, "XML data encoding"},
@@ -280,6 +336,11 @@ DEPRECATED static struct s_varmap {
 	{"checkpoint_seqnum", PT_int32, &global_checkpoint_seqnum, PA_PUBLIC, "checkpoint sequence number"},
 	{"checkpoint_interval", PT_int32, &global_checkpoint_interval, PA_PUBLIC, "checkpoint interval"},
 	{"checkpoint_keepall", PT_bool, &global_checkpoint_keepall, PA_PUBLIC, "checkpoint file keep enable flag"},
+	{"checkpoint_fork", PT_bool, &global_checkpoint_fork, PA_PUBLIC, "checkpoint files are written by a forked process"},
+	{"checkpoint_restore", PT_char1024, &global_checkpoint_restore, PA_PUBLIC, "checkpoint file from which the simulation state is restored"},
+	{"scenario_file", PT_char1024, &global_scenario_file, PA_PUBLIC, "CSV file of scenarios run from the initialized model"},
+	{"scenario_jobs", PT_int32, &global_scenario_jobs, PA_PUBLIC, "maximum number of scenarios run at the same time"},
+	{"scenario", PT_int32, &global_scenario, PA_REFERENCE, "number of the scenario run by this process"},
 	{"check_version", PT_bool, &global_check_version, PA_PUBLIC, "check version enable flag"},
 	{"random_number_generator", PT_enumeration, &global_randomnumbergenerator, PA_PUBLIC, "random number generator version control flag", rng_keys},
 	{"mainloop_state", PT_enumeration, &global_mainloopstate, PA_PUBLIC, "main sync loop state flag", mls_keys},
@@ -346,6 +407,18 @@ DEPRECATED static struct s_varmap {
 	{"rusage_file",PT_char1024,&global_rusage_file,PA_PUBLIC,"file in which resource usage data is collected"},
 	{"rusage_rate",PT_int64,&global_rusage_rate,PA_PUBLIC,"rate at which resource usage data is collected (in seconds)"},
 	{"rusage",PT_char1024,&global_rusage_data,PA_PUBLIC,"rusage data"},
+	{"lazy_sync",PT_bool,&global_lazy_sync,PA_PUBLIC,"enable skipping sync of objects whose next event is not due"},
+	{"lazy_sync_classes",PT_char1024,&global_lazy_sync_classes,PA_PUBLIC,"comma-separated list of classes that may use lazy sync (* for all classes)"},
+	{"sync_dag",PT_bool,&global_sync_dag,PA_PUBLIC,"enable running sync passes using the object dependency graph instead of rank barriers"},
+	{"object_arena",PT_bool,&global_object_arena,PA_PUBLIC,"enable allocating objects of the same class contiguously in per-class slabs"},
+	{"object_arena_rankorder",PT_bool,&global_object_arena_rankorder,PA_PUBLIC,"enable processing objects in each rank in memory order"},
+	{"deltamode_parallel",PT_bool,&global_deltamode_parallel,PA_PUBLIC,"enable running deltamode object updates of each rank on the sync thread pool"},
+	{"find_index",PT_bool,&global_find_index,PA_PUBLIC,"enable planning find programs using secondary indexes on class, groupid, and parent"},
+	{"property_columns",PT_char1024,&global_property_columns,PA_PUBLIC,"comma-separated list of class.property values copied into contiguous columns in each sync pass"},
+	{"init_parallel",PT_bool,&global_init_parallel,PA_PUBLIC,"enable running independent object inits on the thread pool when init_sequence is DEPENDENCY"},
+	{"loadshape_batch",PT_bool,&global_loadshape_batch,PA_PUBLIC,"enable updating loadshapes in batches grouped by machine type"},
+	{"enduse_batch",PT_bool,&global_enduse_batch,PA_PUBLIC,"enable accumulating enduse energy and heat gain in batches"},
+	{"schedule_cache",PT_char1024,&global_schedule_cache,PA_PUBLIC,"folder in which compiled schedules are saved and from which later runs map them"},
 
 	/* add new global variables here */
 };
@@ -437,12 +510,32 @@ GLOBALVAR *GldGlobals::find(const char *name) /**< name of global variable to fi
 	GLOBALVAR *var = NULL;
 	if ( name==NULL ) /* get first global in list */
 			return global_getnext(NULL);
-	for(var = global_getnext(NULL); var != NULL; var = global_getnext(var)){
-		if(strcmp(var->prop->name, name) == 0){
+
+	/* pushed variables shadow created ones */
+	for ( var = global_getnext(NULL) ; var != NULL && var != global_created ; var = global_getnext(var) )
+	{
+		if ( strcmp(var->prop->name, name) == 0 )
+		{
 			return var;
 		}
 	}
-	return NULL;
+
+	unsigned int hash = hash_name(name);
+	rlock(&global_index_lock);
+	var = NULL;
+	if ( global_index_size > 0 )
+	{
+		for ( size_t n = hash&(global_index_size-1) ; global_index[n].hash != 0 ; n = (n+1)&(global_index_size-1) )
+		{
+			if ( global_index[n].hash == hash && strcmp(global_index[n].var->prop->name,name) == 0 )
+			{
+				var = global_index[n].var;
+				break;
+			}
+		}
+	}
+	runlock(&global_index_lock);
+	return var;
 }
 
 /** Get global variable list
@@ -686,10 +779,19 @@ GLOBALVAR *GldGlobals::create_v(const char *name, va_list arg)
 		}
 	}
 
+	wlock(&global_index_lock);
+	if ( ! global_index_add(var) )
+	{
+		wunlock(&global_index_lock);
+		throw_exception("global_create(char *name='%s',...): unable to allocate memory for global variable index", name);
+		/* TROUBLESHOOT
+			There is insufficient memory to index the global variable.  Try freeing up memory and try again.
+		 */
+	}
 	if ( lastvar == NULL )
 	{
 		/* first variable */
-		global_varlist = lastvar = var;
+		global_varlist = lastvar = global_created = var;
 	}
 	else
 	{	
@@ -697,6 +799,7 @@ GLOBALVAR *GldGlobals::create_v(const char *name, va_list arg)
 		lastvar->next = var;
 		lastvar = var;
 	}
+	wunlock(&global_index_lock);
 
 	return var;
 }
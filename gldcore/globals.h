@@ -143,6 +143,7 @@ typedef enum e_dateformat {
 		IS_DEFERRED = 1 - Initialization may be deferred by objects (default)
 		IS_BOTTOMUP = 2 - Initialization performed by rank bottom-up
 		IS_TOPDOWN = 3 - Initialization performed by rank top-down
+		IS_DEPENDENCY = 4 - Initialization performed after parents and init_after objects
 
 	See Also:
 	- global_init_sequence
@@ -152,6 +153,7 @@ typedef enum e_initseq {
 	IS_DEFERRED=1, 
 	IS_BOTTOMUP=2, 
 	IS_TOPDOWN=3,
+	IS_DEPENDENCY=4,
 } INITSEQ;
 
 /* Typedef CHECKPOINTTYPE
@@ -263,6 +265,12 @@ GLOBAL int global_threadcount INIT(1); /**< the maximum thread limit, zero means
 /* Variable: global_profiler */
 GLOBAL int global_profiler INIT(0); /**< Flags the profiler to process class performance data */
 
+/* Variable: global_profiler_trace */
+GLOBAL char global_profiler_trace[1024] INIT(""); /**< Chrome trace file to which the sync spans are saved */
+
+/* Variable: global_profiler_trace_sample */
+GLOBAL int32 global_profiler_trace_sample INIT(0); /**< object sync spans are recorded for one of every this many objects (0 for none) */
+
 /* Variable: global_pauseatexit */
 GLOBAL int global_pauseatexit INIT(0); /**< Enable a pause for user input after exit */
 
@@ -476,6 +484,21 @@ GLOBAL int global_checkpoint_interval INIT(0); /** checkpoint interval (default
 /* Variable: global_checkpoint_keepall */
 GLOBAL int global_checkpoint_keepall INIT(0); /** determines whether all checkpoint files are kept, non-zero keeps files, zero delete all but last */
 
+/* Variable: global_checkpoint_fork */
+GLOBAL bool global_checkpoint_fork INIT(TRUE); /**< checkpoints are written by a forked copy of the process so the simulation does not pause */
+
+/* Variable: global_checkpoint_restore */
+GLOBAL char global_checkpoint_restore[1024] INIT(""); /**< checkpoint file from which the simulation state is restored after initialization */
+
+/* Variable: global_scenario_file */
+GLOBAL char global_scenario_file[1024] INIT(""); /**< CSV file of scenarios that are run from the initialized model */
+
+/* Variable: global_scenario_jobs */
+GLOBAL int32 global_scenario_jobs INIT(0); /**< maximum number of scenarios run at the same time (0 uses the processor count) */
+
+/* Variable: global_scenario */
+GLOBAL int32 global_scenario INIT(0); /**< number of the scenario run by this process (0 when not running a scenario) */
+
 /* Variable: global_check_version */
 GLOBAL int global_check_version INIT(0); /**< check version flag */
 
@@ -732,8 +755,9 @@ typedef enum {
 	DMC_VALIDATE	= 0x0001000000000000,
 	DMC_VERSION		= 0x0002000000000000,
 	DMC_XCORE		= 0x0004000000000000,
+	DMC_COLUMN		= 0x0008000000000000,
 	DMC_NONE		=  0, /**< no messages allowed */
-	DMC_ALL			= 0x0007ffffffffffff, /**< all messages allowed */
+	DMC_ALL			= 0x000fffffffffffff, /**< all messages allowed */
 } GLOBALMESSAGECONTEXT;
 
 /* Variable:  */
@@ -810,6 +834,42 @@ GLOBAL char1024 global_rusage_file INIT("gridlabd-rusage.csv");
 
 GLOBAL char1024 global_rusage_data INIT("{}");
 
+/* Variable: global_lazy_sync */
+GLOBAL bool global_lazy_sync INIT(FALSE); /**< skip sync of objects whose next event is not due */
+
+/* Variable: global_lazy_sync_classes */
+GLOBAL char1024 global_lazy_sync_classes INIT(""); /**< classes that may be skipped by lazy sync in addition to those flagged PC_LAZYSYNC */
+
+/* Variable: global_sync_dag */
+GLOBAL bool global_sync_dag INIT(FALSE); /**< run the sync passes using the object dependency graph instead of rank barriers */
+
+/* Variable: global_object_arena */
+GLOBAL bool global_object_arena INIT(FALSE); /**< allocate objects of the same class contiguously in per-class slabs */
+
+/* Variable: global_object_arena_rankorder */
+GLOBAL bool global_object_arena_rankorder INIT(FALSE); /**< process the objects in each rank in memory order instead of shuffled order */
+
+/* Variable: global_find_index */
+GLOBAL bool global_find_index INIT(FALSE); /**< plan find programs using secondary indexes on class, groupid, and parent */
+
+/* Variable: global_property_columns */
+GLOBAL char1024 global_property_columns INIT(""); /**< class properties copied into contiguous columns in each sync pass */
+
+/* Variable: global_deltamode_parallel */
+GLOBAL bool global_deltamode_parallel INIT(FALSE); /**< run the deltamode object updates of each rank on the sync thread pool */
+
+/* Variable: global_init_parallel */
+GLOBAL bool global_init_parallel INIT(FALSE); /**< run independent object inits on the thread pool when init_sequence is DEPENDENCY */
+
+/* Variable: global_loadshape_batch */
+GLOBAL bool global_loadshape_batch INIT(FALSE); /**< update loadshapes in batches grouped by machine type */
+
+/* Variable: global_enduse_batch */
+GLOBAL bool global_enduse_batch INIT(FALSE); /**< accumulate enduse energy and heat gain in batches */
+
+/* Variable: global_schedule_cache */
+GLOBAL char1024 global_schedule_cache INIT(""); /**< folder in which compiled schedules are saved and mapped by later runs */
+
 #undef GLOBAL
 #undef INIT
 
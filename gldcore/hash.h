@@ -0,0 +1,48 @@
+/* File: hash.h
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file hash.h
+	@addtogroup hash String hashes
+	@ingroup core
+
+	The core name indexes (globals, properties, objects) and the schedule
+	body table hash strings with the 64-bit FNV-1a hash.  Indexes that keep
+	32-bit hashes fold the upper half into the lower half.
+
+ @{
+ **/
+
+#ifndef _HASH_H
+#define _HASH_H
+
+#if ! defined _GLDCORE_H && ! defined _GRIDLABD_H
+#error "this header may only be included from gldcore.h or gridlabd.h"
+#endif
+
+#define HASH_FNV1A_OFFSET 0xcbf29ce484222325ULL
+#define HASH_FNV1A_PRIME 0x100000001b3ULL
+
+/** Hash a string with FNV-1a, continuing from a previous hash if given
+	@return the 64-bit hash
+ **/
+static inline unsigned long long hash_string(const char *str, unsigned long long hash = HASH_FNV1A_OFFSET)
+{
+	for ( const unsigned char *p = (const unsigned char*)str ; *p != '\0' ; p++ )
+	{
+		hash = (hash ^ *p) * HASH_FNV1A_PRIME;
+	}
+	return hash;
+}
+
+/** Hash a name for an index that uses 0 to mark empty slots
+	@return the 32-bit folded hash, never 0
+ **/
+static inline unsigned int hash_name(const char *name)
+{
+	unsigned long long hash = hash_string(name);
+	return (unsigned int)(hash ^ (hash >> 32)) | 1;
+}
+
+#endif
+
+/**@}**/
@@ -3,6 +3,10 @@
 //
 
 #include "gldcore.h"
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
 
 SET_MYCONTEXT(DMC_JOB)
 
@@ -381,3 +385,327 @@ int job(void *main, int argc, const char *argv[])
 
 	exit(final_result==0 ? XC_SUCCESS : XC_TSTERR);
 }
+
+/** Scenario fan-out
+
+	The scenario file is a CSV file whose first row names the global
+	variables or object properties (given as <i>object</i>.<i>property</i>)
+	that are changed by each scenario, and whose remaining rows give the
+	values used by each scenario.  A column named "name" is not applied
+	and instead gives the name of the directory in which the scenario runs,
+	otherwise the directory is named "scenario_<i>n</i>".
+
+	The model is loaded and initialized only once.  Each scenario is run by a
+	child process forked from the initialized model, so the children share
+	the memory of the model until they change it.
+ **/
+typedef std::vector<std::string> SCENARIOROW;
+
+/* split a line of CSV into trimmed and unquoted fields */
+static void scenario_split(char *line, SCENARIOROW &fields)
+{
+	fields.clear();
+	char *next = line;
+	while ( next!=NULL )
+	{
+		char *item = next;
+		next = strchr(item,',');
+		if ( next!=NULL ) *next++ = '\0';
+		while ( isspace(*item) ) item++;
+		char *end = item+strlen(item);
+		while ( end>item && isspace(end[-1]) ) *--end = '\0';
+		if ( end-item>1 && item[0]=='"' && end[-1]=='"' )
+		{
+			end[-1] = '\0';
+			item++;
+		}
+		fields.push_back(item);
+	}
+}
+
+/* check that a scenario column refers to a global or an object property */
+static bool scenario_check(const char *name)
+{
+	if ( strcmp(name,"name")==0 )
+		return true;
+	const char *dot = strchr(name,'.');
+	if ( dot==NULL )
+		return global_find(name)!=NULL;
+	char objname[1024];
+	snprintf(objname,sizeof(objname),"%.*s",(int)(dot-name),name);
+	OBJECT *obj = object_find_name(objname);
+	char buffer[1024];
+	return obj!=NULL && ( class_find_property(obj->oclass,dot+1)!=NULL || object_get_header_string(obj,dot+1,buffer,sizeof(buffer))!=NULL );
+}
+
+/* apply a scenario value to a global or an object property */
+static bool scenario_apply(const char *name, const char *value)
+{
+	if ( strcmp(name,"name")==0 )
+		return true;
+	const char *dot = strchr(name,'.');
+	if ( dot==NULL )
+		return global_setvar(name,value)==SUCCESS;
+	char objname[1024];
+	snprintf(objname,sizeof(objname),"%.*s",(int)(dot-name),name);
+	OBJECT *obj = object_find_name(objname);
+	return obj!=NULL && object_set_value_by_name(obj,dot+1,value)>0;
+}
+
+/* load the scenario file */
+static bool scenario_load(const char *filename, SCENARIOROW &header, std::vector<SCENARIOROW> &rows)
+{
+	FILE *fp = fopen(filename,"r");
+	if ( fp==NULL )
+	{
+		output_error("unable to open scenario file '%s': %s", filename, strerror(errno));
+		/* TROUBLESHOOT
+			The scenario file could not be opened.  Check that the file exists and
+			is readable, and try again.
+		 */
+		return false;
+	}
+	char line[65536];
+	int linenum = 0;
+	while ( fgets(line,sizeof(line),fp)!=NULL )
+	{
+		linenum++;
+		char *eol = line+strcspn(line,"\r\n");
+		*eol = '\0';
+		if ( line[0]=='\0' || line[0]=='#' )
+			continue;
+		SCENARIOROW fields;
+		scenario_split(line,fields);
+		if ( header.size()==0 )
+		{
+			header = fields;
+			for ( SCENARIOROW::iterator item=header.begin() ; item!=header.end() ; item++ )
+			{
+				if ( !scenario_check(item->c_str()) )
+				{
+					output_error("%s(%d): '%s' is not a global variable or object property", filename, linenum, item->c_str());
+					/* TROUBLESHOOT
+						The header row of the scenario file names a global variable or object
+						property that does not exist in the model.  Object properties are
+						given as <i>object</i>.<i>property</i>, using the name of the object.
+						Correct the header and try again.
+					 */
+					fclose(fp);
+					return false;
+				}
+			}
+		}
+		else if ( fields.size()!=header.size() )
+		{
+			output_error("%s(%d): scenario has %d values but the header has %d columns", filename, linenum, (int)fields.size(), (int)header.size());
+			/* TROUBLESHOOT
+				Each scenario in the scenario file must give one value for each
+				column in the header row.  Correct the scenario and try again.
+			 */
+			fclose(fp);
+			return false;
+		}
+		else
+		{
+			rows.push_back(fields);
+		}
+	}
+	fclose(fp);
+	return true;
+}
+
+/* give the child its own open file descriptions so file positions are not shared with its siblings */
+static void scenario_unshare_files(void)
+{
+#ifdef __linux__
+	DIR *dirp = opendir("/proc/self/fd");
+	if ( dirp==NULL )
+		return;
+	struct dirent *dp;
+	while ( (dp=readdir(dirp))!=NULL )
+	{
+		int fd = atoi(dp->d_name);
+		struct stat info;
+		if ( dp->d_name[0]=='.' || fd<=STDERR_FILENO || fd==dirfd(dirp) || fstat(fd,&info)!=0 || !S_ISREG(info.st_mode) )
+			continue;
+		int mode = fcntl(fd,F_GETFL);
+		off_t pos = lseek(fd,0,SEEK_CUR);
+		char path[64];
+		snprintf(path,sizeof(path),"/proc/self/fd/%d",fd);
+		int copy = open(path,mode&~(O_CREAT|O_TRUNC|O_EXCL));
+		if ( copy<0 )
+			continue;
+		if ( lseek(copy,pos,SEEK_SET)==pos )
+			dup2(copy,fd);
+		close(copy);
+	}
+	closedir(dirp);
+#endif
+}
+
+/* start the child process for a scenario, returns the pid in the parent */
+static pid_t scenario_start(int number, const char *dirname, SCENARIOROW &header, SCENARIOROW &values)
+{
+	fflush(stdout);
+	fflush(stderr);
+	pid_t pid = fork();
+	if ( pid!=0 )
+		return pid;
+
+	/* child runs the scenario in its own directory */
+	global_scenario = number;
+	scenario_unshare_files();
+	if ( ( mkdir(dirname,0755)!=0 && errno!=EEXIST ) || chdir(dirname)!=0 )
+	{
+		output_error("unable to use scenario directory '%s': %s", dirname, strerror(errno));
+		/* TROUBLESHOOT
+			The directory in which a scenario is run could not be created.  Check
+			that the working directory is writable and try again.
+		 */
+		_exit(XC_IOERR);
+	}
+	if ( freopen("gridlabd.out","w",stdout)==NULL || freopen("gridlabd.err","w",stderr)==NULL )
+	{
+		_exit(XC_IOERR);
+	}
+	for ( size_t n=0 ; n<header.size() ; n++ )
+	{
+		if ( !scenario_apply(header[n].c_str(),values[n].c_str()) )
+		{
+			output_error("scenario %d: unable to set %s to '%s'", number, header[n].c_str(), values[n].c_str());
+			/* TROUBLESHOOT
+				A value given in the scenario file could not be applied to the model.
+				Check that the value is valid for the global variable or property
+				and try again.
+			 */
+			_exit(XC_INIERR);
+		}
+	}
+	IN_MYCONTEXT output_verbose("scenario %d running in directory '%s'", number, dirname);
+	return 0;
+}
+
+/** Run the scenarios given in a scenario file
+
+	Called after the model is initialized and before the simulation starts.
+
+	The scenarios are forked from a single-threaded process, because a
+	child process only gets a copy of the thread that forked it.  The
+	caller must stop its thread pool first, and any deferred schedule
+	creations are finished before the first scenario is forked.
+
+	@returns the scenario number in a child process, which must run the
+	simulation, 0 in the parent process after all the scenarios are done,
+	or -1 if the scenarios could not be started or a scenario failed.
+ **/
+int job_scenarios(const char *filename)
+{
+	SCENARIOROW header;
+	std::vector<SCENARIOROW> rows;
+	if ( !scenario_load(filename,header,rows) )
+		return -1;
+	if ( rows.size()==0 )
+	{
+		output_warning("scenario file '%s' has no scenarios", filename);
+		return 0;
+	}
+	if ( my_instance->get_exec()->get_taskpool()!=NULL )
+	{
+		output_error("scenarios cannot be forked while the thread pool is running");
+		/* TROUBLESHOOT
+			The scenarios were started while the sync thread pool was running.
+			The forked scenarios would not have the threads of the pool.  This is
+			a bug and should be reported.
+		 */
+		return -1;
+	}
+	if ( schedule_createwait()==FAILED )
+	{
+		output_error("deferred schedule creation failed before scenarios were forked");
+		/* TROUBLESHOOT
+			A schedule whose creation was deferred to a background thread could not
+			be created.  This is usually preceded by a more detailed message that
+			explains why it failed.  Follow the guidance for that message and try again.
+		 */
+		return -1;
+	}
+	size_t namecol;
+	for ( namecol=0 ; namecol<header.size() && header[namecol]!="name" ; namecol++ ) {}
+
+	unsigned int n_procs = global_scenario_jobs>0 ? global_scenario_jobs : processor_count();
+	IN_MYCONTEXT output_verbose("running %d scenarios from '%s' using %d processes", (int)rows.size(), filename, n_procs);
+
+	std::vector<pid_t> pids(rows.size(),0);
+	std::vector<int64> started(rows.size(),0);
+	size_t next = 0, running = 0, failed = 0;
+	while ( next<rows.size() || running>0 )
+	{
+		/* start as many scenarios as allowed */
+		while ( next<rows.size() && running<n_procs )
+		{
+			char dirname[1024];
+			if ( namecol<header.size() )
+				snprintf(dirname,sizeof(dirname),"%s",rows[next][namecol].c_str());
+			else
+				snprintf(dirname,sizeof(dirname),"scenario_%d",(int)next+1);
+			pid_t pid = scenario_start((int)next+1,dirname,header,rows[next]);
+			if ( pid==0 )
+				return (int)next+1;
+			else if ( pid<0 )
+			{
+				output_error("unable to start scenario %d: %s", (int)next+1, strerror(errno));
+				/* TROUBLESHOOT
+					The process for a scenario could not be started.  This is usually
+					caused by a lack of memory or a process limit.  Reduce the value
+					of scenario_jobs and try again.
+				 */
+				failed++;
+			}
+			else
+			{
+				pids[next] = pid;
+				started[next] = my_instance->get_exec()->clock();
+				running++;
+			}
+			next++;
+		}
+
+		/* wait for a scenario to finish */
+		if ( running>0 )
+		{
+			int status;
+			pid_t pid = waitpid(-1,&status,0);
+			if ( pid<0 )
+			{
+				if ( errno==EINTR ) continue;
+				output_error("unable to wait for scenarios: %s", strerror(errno));
+				return -1;
+			}
+			size_t n;
+			for ( n=0 ; n<pids.size() && pids[n]!=pid ; n++ ) {}
+			if ( n==pids.size() )
+				continue;
+			running--;
+			double dt = (double)(my_instance->get_exec()->clock()-started[n])/(double)CLOCKS_PER_SEC;
+			int code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+			if ( code!=0 )
+			{
+				if ( WIFSIGNALED(status) )
+					output_error("scenario %d stopped by signal %d", (int)n+1, WTERMSIG(status));
+				else
+					output_error("scenario %d failed with exit code %d", (int)n+1, code);
+				/* TROUBLESHOOT
+					A scenario did not complete successfully.  The output of the scenario
+					is found in the gridlabd.out and gridlabd.err files in its directory.
+				 */
+				failed++;
+			}
+			else
+			{
+				IN_MYCONTEXT output_verbose("scenario %d done in %.1f seconds", (int)n+1, dt);
+			}
+		}
+	}
+	output_message("%d of %d scenarios completed successfully", (int)(rows.size()-failed), (int)rows.size());
+	return failed>0 ? -1 : 0;
+}
@@ -21,6 +21,7 @@ typedef enum {
 } JOBOPTIONS;
 
 int job(void *main, int argc, const char *argv[]);
+int job_scenarios(const char *filename);
 
 #endif
 
@@ -417,8 +417,14 @@ int GldJsonWriter::write_schedules(FILE *fp)
 			if ( ! first )
 				len += write(",");
 			first = false;
-			char buffer[sizeof(sch->definition)*2];
-			len += write("\n\t\t\"%s\" : \"%s\"", sch->name, escape(sch->definition,buffer,sizeof(buffer)));
+			size_t size = strlen(sch->definition)*2+1;
+			char *buffer = (char*)malloc(size);
+			if ( buffer == NULL )
+			{
+				throw_exception("GldJsonWriter::write_schedules(): memory allocation failed");
+			}
+			len += write("\n\t\t\"%s\" : \"%s\"", sch->name, escape(sch->definition,buffer,size-1));
+			free(buffer);
 		}
 	}
 	len += write("\n\t}");
@@ -451,8 +457,11 @@ int GldJsonWriter::write_objects(FILE *fp)
 
 		/* handle special case for powerflow module handling of parent */
 		OBJECT **topological_parent = object_get_object_by_name(obj,"topological_parent");
-		if ( topological_parent != NULL )
+		if ( topological_parent != NULL && obj->parent != *topological_parent )
+		{
 			obj->parent = *topological_parent;
+			object_update_generation();
+		}
 
 		if ( obj->parent != NULL )
 		{
@@ -463,7 +472,7 @@ int GldJsonWriter::write_objects(FILE *fp)
 		}
 		if ( ! isnan(obj->latitude) ) TUPLE("latitude","%f",obj->latitude);
 		if ( ! isnan(obj->longitude) ) TUPLE("longitude","%f",obj->longitude);
-		if ( obj->groupid[0] != '\0' ) TUPLE("groupid","%s",(const char*)obj->groupid);
+		if ( obj->cold->groupid[0] != '\0' ) TUPLE("groupid","%s",(const char*)obj->cold->groupid);
 		TUPLE("rank","%u",(unsigned int)obj->rank);
 		if ( convert_from_timestamp(obj->clock,buffer,buffer_size) )
 			TUPLE("clock","%s",buffer);
@@ -473,8 +482,10 @@ int GldJsonWriter::write_objects(FILE *fp)
 		if ( obj->out_svc > TS_ZERO && obj->out_svc < TS_NEVER ) TUPLE("out","%llu",(int64)(obj->out_svc));
 		TUPLE("rng_state","%llu",(int64)(obj->rng_state));
 		if ( obj->heartbeat != 0 ) TUPLE("heartbeat","%llu",(int64)(obj->heartbeat));
+		if ( obj->delta_substep > 0 ) TUPLE("delta_substep","%g s",obj->delta_substep);
+		if ( obj->cold->init_after != NULL ) TUPLE("init_after","%s",obj->cold->init_after);
 		(len += write(",\n\t\t\t\"%s\" : \"%llX%llX\"","guid",(int64)(obj->guid[0]),(int64)(obj->guid[1])));
-		TUPLE("flags","0x%llx",(int64)(obj->flags));
+		TUPLE("flags","0x%llx",(int64)(obj->flags&~OF_UNSAVED));
 		for ( prop = object_get_first_property(obj) ; prop != NULL ; prop = object_get_next_property(prop) )
 		{
             size_t sz = object_property_getsize(obj,prop)+1;
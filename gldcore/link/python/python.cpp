@@ -1350,9 +1350,9 @@ static PyObject *gridlabd_get_object(PyObject *self, PyObject *args)
     {
         PyDict_SetItemString(data,"longitude",obj->longitude);
     }
-    if ( obj->groupid[0] != '\0' ) 
+    if ( obj->cold->groupid[0] != '\0' ) 
     {
-        PyDict_SetItemString(data,"groupid",(const char*)obj->groupid);
+        PyDict_SetItemString(data,"groupid",(const char*)obj->cold->groupid);
     }
     PyDict_SetItemString(data,"rank",(unsigned long long)obj->rank);
     char buffer[1024];
@@ -1437,15 +1437,16 @@ static PyObject *gridlabd_get_schedule(PyObject *self, PyObject *args)
     for ( calendar = 0 ; calendar < 14 ; calendar++ )
     {
         PyObject *values = PyDict_New();
-        size_t minute;
+        SCHEDULECALENDAR *cal = &(sch->body->calendar[calendar]);
+        size_t run;
         double last = NaN;
-        for ( minute = 0 ; minute < sizeof(sch->index[calendar])/sizeof(sch->index[calendar][0]) ; minute++ )
+        for ( run = 0 ; run < cal->runs ; run++ )
         {
-            double value = sch->data[sch->index[calendar][minute]];
+            double value = sch->body->data[cal->index[run]];
             if ( last != value )
             {
                 char key[64];
-                snprintf(key,63,"%ld",minute);
+                snprintf(key,63,"%ld",(long)cal->start[run]);
                 PyDict_SetItemString(values,key,value);
                 last = value;
             }
@@ -1044,6 +1044,7 @@ STATUS GldLoader::load_resolve_all(void)
 {
 	STATUS result = resolve_list(first_unresolved);
 	first_unresolved = NULL;
+	object_update_generation(); // resolved references may have changed object parents
 	return result;
 }
 
@@ -4545,43 +4546,43 @@ int GldLoader::object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					}
 					else if (strcmp(propname,"on_init")==0 )
 					{
-						obj->events.init = strdup(propval);
+						object_get_cold(obj)->events.init = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
 					else if (strcmp(propname,"on_precommit")==0 )
 					{
-						obj->events.precommit = strdup(propval);
+						object_get_cold(obj)->events.precommit = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
 					else if (strcmp(propname,"on_presync")==0 )
 					{
-						obj->events.presync = strdup(propval);
+						object_get_cold(obj)->events.presync = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
 					else if (strcmp(propname,"on_sync")==0 )
 					{
-						obj->events.sync = strdup(propval);
+						object_get_cold(obj)->events.sync = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
 					else if (strcmp(propname,"on_postsync")==0 )
 					{
-						obj->events.postsync = strdup(propval);
+						object_get_cold(obj)->events.postsync = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
 					else if (strcmp(propname,"on_commit")==0 )
 					{
-						obj->events.commit = strdup(propval);
+						object_get_cold(obj)->events.commit = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
 					else if (strcmp(propname,"on_finalize")==0 )
 					{
-						obj->events.finalize = strdup(propval);
+						object_get_cold(obj)->events.finalize = strdup(propval);
 						SAVETERM;
 						ACCEPT;
 					}
@@ -4604,8 +4605,35 @@ int GldLoader::object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 						SAVETERM;
 						ACCEPT;
 					}
+					else if ( strcmp(propname,"delta_substep")==0 )
+					{
+						if ( object_set_delta_substep(obj,propval) == FAILED )
+						{
+							syntax_error(filename,linenum,"unable to set delta_substep to %s", propval);
+							REJECT;
+						}
+						else
+						{
+							SAVETERM;
+							ACCEPT;
+						}
+					}
+					else if ( strcmp(propname,"init_after")==0 )
+					{
+						if ( object_set_init_after(obj,propval) == FAILED )
+						{
+							syntax_error(filename,linenum,"unable to set init_after to %s", propval);
+							REJECT;
+						}
+						else
+						{
+							SAVETERM;
+							ACCEPT;
+						}
+					}
 					else if (strcmp(propname,"groupid")==0){
-						strncpy(obj->groupid, propval, sizeof(obj->groupid));
+						strncpy(object_get_cold(obj)->groupid, propval, sizeof(obj->cold->groupid));
+						object_update_generation();
 					}
 					else if (strcmp(propname,"flags")==0)
 					{
@@ -4903,6 +4931,7 @@ int GldLoader::object_block(PARSER, OBJECT *parent, OBJECT **subobj)
 	nameobj.name = classname;
 #endif
 	if ( id2 == -1 ) id2=id+1; /* create singleton */
+	object_reserve(oclass,id==-1?id2+1:id2-id);
 	BEGIN_REPEAT;
 	while ( id < id2 )
 	{
@@ -7925,6 +7954,12 @@ STATUS GldLoader::loadall_glm(const char *fname) /**< a pointer to the first cha
 	IN_MYCONTEXT output_verbose("file '%s' is %d bytes long", file,fsize);
 	add_depend(filename,file);
 
+	/* size the name index for large models up front (about one name per kB) */
+	if ( object_name_reserve(fsize/1024) == FAILED )
+	{
+		output_warning("unable to reserve the name index for '%s'", file);
+	}
+
 	/* removed malloc check since it doesn't malloc any more */
 	buffer[0] = '\0';
 
@@ -34,6 +34,7 @@ SET_MYCONTEXT(DMC_LOADSHAPE)
 
 static loadshape *loadshape_list = NULL;
 static unsigned int n_shapes = 0;
+static unsigned int loadshape_generation = 0; /* changes when a shape is created or converted */
 
 static void sync_analog(loadshape *ls, double dt)
 {
@@ -540,6 +541,7 @@ int loadshape_create(void *ptr)
 	data->next = loadshape_list;
 	loadshape_list = data;
 	n_shapes++;
+	loadshape_generation++;
 	return 1;
 }
 
@@ -1002,6 +1004,141 @@ void *loadshape_syncproc(void *ptr)
 	pthread_exit((void*)0);
 	return (void*)0;
 }
+/* Loadshape batches (see the loadshape_batch global and batch.h)
+
+   The shapes are grouped into batches by machine type.  The loads of the
+   analog shapes are computed by a branch-free loop.  The other machine
+   types carry queue and random state from one update to the next, so their
+   shapes are updated one at a time by loadshape_sync(), but still one
+   machine type per batch.
+ */
+typedef struct s_loadshapebatch {
+	BATCH head; /**< batch header */
+	bool vector; /**< batch is updated by the analog kernel */
+	loadshape *shape[BATCH_CHUNK]; /**< shapes in the batch */
+	double value[BATCH_CHUNK]; /**< schedule values */
+	double energy[BATCH_CHUNK]; /**< analog energy scales */
+	double power[BATCH_CHUNK]; /**< analog power scales */
+	double load[BATCH_CHUNK]; /**< shape loads */
+	double dt[BATCH_CHUNK]; /**< hours since the last update */
+	double update[BATCH_CHUNK]; /**< 1 if the load is updated, 0 if not */
+} LOADSHAPEBATCH;
+
+/* analog shapes with a schedule are updated by the analog kernel */
+static bool loadshape_batch_vector(loadshape *ls)
+{
+	return ls->type == MT_ANALOG && ls->schedule != NULL;
+}
+
+/* group the shapes into batches by machine type */
+static bool loadshape_batch_build(BATCHLIST *list)
+{
+	int type;
+	loadshape *ls;
+	for ( type = MT_UNKNOWN ; type <= MT_SCHEDULED ; type++ )
+	{
+		int vector;
+		for ( vector = 1 ; vector >= 0 ; vector-- )
+		{
+			LOADSHAPEBATCH *batch = NULL;
+			for ( ls = loadshape_list ; ls != NULL ; ls = ls->next )
+			{
+				if ( ls->type != type || loadshape_batch_vector(ls) != (vector==1) )
+					continue;
+				batch = (LOADSHAPEBATCH*)batch_next(list,(BATCH*)batch);
+				if ( batch == NULL )
+					return false;
+				batch->vector = (vector==1);
+				batch->shape[batch->head.n++] = ls;
+			}
+		}
+	}
+	IN_MYCONTEXT output_debug("loadshape_batch_build(): %u shapes grouped into %u batches", n_shapes, (unsigned int)list->n_batches);
+	return true;
+}
+
+/* compute the loads of analog shapes */
+BATCH_KERNEL static void loadshape_batch_load(size_t n, 
+	const double *value, const double *energy, const double *power, const double *dt, const double *update, 
+	double *load)
+{
+	size_t i;
+	for ( i = 0 ; i < n ; i++ )
+	{
+		double v = value[i], e = energy[i], p = power[i], h = dt[i], old = load[i];
+		double by_energy = v * e / ( h > 0.0 ? h : 1.0 );
+		double by_power = v * p;
+		double energy_load = h > 0.0 ? by_energy : old;
+		double power_load = p > 0 ? by_power : v;
+		double scaled = e > 0 ? energy_load : power_load;
+		load[i] = update[i] > 0 ? scaled : old;
+	}
+}
+
+/* update analog shapes the same way loadshape_sync() does */
+static void loadshape_batch_analog(LOADSHAPEBATCH *batch, TIMESTAMP t1)
+{
+	size_t i, n = batch->head.n;
+	TIMESTAMP t2 = TS_NEVER;
+
+	/* gather */
+	for ( i = 0 ; i < n ; i++ )
+	{
+		loadshape *ls = batch->shape[i];
+		batch->value[i] = ls->schedule->value;
+		batch->energy[i] = ls->params.analog.energy;
+		batch->power[i] = ls->params.analog.power;
+		batch->load[i] = ls->load;
+		batch->dt[i] = ls->t0 > 0 ? (double)(t1 - ls->t0)/3600 : 0.0;
+		batch->update[i] = ( t1 > ls->t0 && ls->schedule->duration > 0 ) ? 1.0 : 0.0;
+	}
+
+	/* update loads */
+	loadshape_batch_load(n,batch->value,batch->energy,batch->power,batch->dt,batch->update,batch->load);
+
+	/* scatter loads and find the earliest next event */
+	for ( i = 0 ; i < n ; i++ )
+	{
+		loadshape *ls = batch->shape[i];
+		TIMESTAMP t3;
+		ls->load = batch->load[i];
+		if ( batch->update[i] > 0 )
+			ls->t2 = ls->schedule->next_t;
+		if ( t1 > ls->t0 && ls->schedule->duration <= 0 )
+			t3 = TS_NEVER;
+		else
+			t3 = ls->t2 > 0 ? ls->t2 : TS_NEVER;
+		if ( t3 < t2 ) t2 = t3;
+		ls->t0 = t1;
+	}
+	batch->head.t2 = t2;
+}
+
+/* update the shapes of one machine type one at a time */
+static void loadshape_batch_scalar(LOADSHAPEBATCH *batch, TIMESTAMP t1)
+{
+	size_t i;
+	TIMESTAMP t2 = TS_NEVER;
+	for ( i = 0 ; i < batch->head.n ; i++ )
+	{
+		TIMESTAMP t3 = loadshape_sync(batch->shape[i],t1);
+		if ( t3 < t2 ) t2 = t3;
+	}
+	batch->head.t2 = t2;
+}
+
+static void loadshape_batch_update(void *arg, unsigned int thread, void *item)
+{
+	LOADSHAPEBATCH *batch = (LOADSHAPEBATCH*)item;
+	TIMESTAMP t1 = *(TIMESTAMP*)arg;
+	if ( batch->vector )
+		loadshape_batch_analog(batch,t1);
+	else
+		loadshape_batch_scalar(batch,t1);
+}
+
+static BATCHLIST loadshape_batches = {"loadshape",&global_loadshape_batch,sizeof(LOADSHAPEBATCH),loadshape_batch_build,loadshape_batch_update};
+
 TIMESTAMP loadshape_syncall(TIMESTAMP t1)
 {
 	static unsigned int n_threads_ls=0;
@@ -1013,8 +1150,8 @@ TIMESTAMP loadshape_syncall(TIMESTAMP t1)
 	if (n_shapes == 0)
 		return TS_NEVER;
 
-	// number of threads desired
-	if (n_threads_ls==0) 
+	// number of threads desired (batches use the sync thread pool instead)
+	if (n_threads_ls==0 && !global_loadshape_batch) 
 	{
 		loadshape *s;
 		size_t n_items, ln=0;
@@ -1075,8 +1212,15 @@ TIMESTAMP loadshape_syncall(TIMESTAMP t1)
 	if ( next_t2_ls>t1 && next_t2_ls<TS_NEVER )
 		return next_t2_ls;
 
+	// update by batch
+	if ( global_loadshape_batch && batch_ready(&loadshape_batches,loadshape_generation) )
+	{
+		t2 = batch_syncall(&loadshape_batches,t1);
+		next_t2_ls = t2;
+	}
+
 	// no threading required
-	if (n_threads_ls<2) 
+	else if (n_threads_ls<2) 
 	{
 		// process list directly
 		loadshape *s;
@@ -1199,6 +1343,9 @@ int convert_to_loadshape(const char *string, void *data, PROPERTY *prop)
 	char buffer[1024];
 	char *token = NULL;
 
+	/* the machine type may change so the batches must be rebuilt */
+	loadshape_generation++;
+
 	/* check string length before copying to buffer */
 	if (strlen(string)>sizeof(buffer)-1)
 	{
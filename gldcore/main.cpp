@@ -382,7 +382,8 @@ int GldMain::run_on_exit(int return_code)
 	IN_MYCONTEXT output_verbose("elapsed runtime %d seconds", realtime_runtime());
 	IN_MYCONTEXT output_verbose("exit code %d", exec.getexitcode());
 
-	for ( std::list<onexitcommand>::iterator cmd = exitcommands.begin() ; cmd != exitcommands.end() ; cmd++ )
+	/* scenarios leave the on_exit commands to the process that started them */
+	for ( std::list<onexitcommand>::iterator cmd = exitcommands.begin() ; global_scenario == 0 && cmd != exitcommands.end() ; cmd++ )
 	{
 		if ( cmd->get_exitcode() == return_code 
 			|| ( return_code != 0 && cmd->get_exitcode() == -1 ) 
@@ -240,6 +240,7 @@ static CALLBACKS callbacks = {
 	{version_major,version_minor,version_patch,version_build,version_branch},
 	call_external_callback,
 	{python_embed_import,python_embed_call},
+	{column_create,column_find,column_refresh},
 	MAGIC /* used to check structure */
 };
 CALLBACKS *module_callbacks(void) { return &callbacks; }
@@ -516,6 +517,8 @@ MODULE *module_load(const char *file, /**< module filename, searches \p PATH */
 	mod->subload = (MODULE *(*)(char *, MODULE **, CLASS **, int, const char *[]))DLSYM(hLib, "subload");
 	mod->test = (void(*)(int,char*[]))DLSYM(hLib,"test");
 	mod->stream = (STREAMCALL)DLSYM(hLib,"stream");
+	if ( (void*)mod->stream == (void*)(size_t(*)(FILE*,int))stream )
+		mod->stream = NULL; // symbol resolved to the core's own stream function
 	mod->globals = NULL;
 	mod->term = (void(*)(void))DLSYM(hLib,"term");
 	mod->on_init = NULL;
@@ -1654,17 +1657,17 @@ void module_profiles(void)
 			struct s_rankdata *rank = &rankdata[obj->rank];
 			if ( obj->oclass->passconfig&PC_PRETOPDOWN )
 			{
-				rank->t_presync += obj->synctime[0];
+				rank->t_presync += obj->cold->synctime[0];
 				rank->n_presync++;
 			}
 			if ( obj->oclass->passconfig&PC_BOTTOMUP )
 			{
-				rank->t_sync += obj->synctime[1];
+				rank->t_sync += obj->cold->synctime[1];
 				rank->n_sync++;
 			}
 			if ( obj->oclass->passconfig&PC_POSTTOPDOWN )
 			{
-				rank->t_postsync += obj->synctime[2];
+				rank->t_postsync += obj->cold->synctime[2];
 				rank->n_postsync++;
 			}
 		}
@@ -51,6 +51,7 @@ static OBJECT *first_object = NULL;
 static OBJECT *last_object = NULL;
 static OBJECTNUM object_array_size = 0;
 static OBJECT **object_array = NULL;
+static unsigned long long object_generation = 0;
 
 /* {name, val, next} */
 KEYWORD oflags[] = {
@@ -112,7 +113,7 @@ static const char *header_class_to_string(OBJECT *obj)
 
 static const char *header_groupid_to_string(OBJECT *obj)
 {
-	return snprintf(header_string,sizeof(header_string),"%s",(const char *)(obj->groupid)) > 0 ? header_string : NULL;
+	return snprintf(header_string,sizeof(header_string),"%s",(const char *)(obj->cold->groupid)) > 0 ? header_string : NULL;
 }
 
 static const char *header_name_to_string(OBJECT *obj)
@@ -193,6 +194,11 @@ static const char *header_heartbeat_to_string(OBJECT *obj)
 	return obj->heartbeat != 0 && snprintf(header_string,sizeof(header_string),"%llu",obj->heartbeat) > 0 ? header_string : NULL;
 }
 
+static const char *header_delta_substep_to_string(OBJECT *obj)
+{
+	return obj->delta_substep > 0 && snprintf(header_string,sizeof(header_string),"%g s",obj->delta_substep) > 0 ? header_string : NULL;
+}
+
 static const char *header_guid_to_string(OBJECT *obj)
 {
 	return snprintf(header_string,sizeof(header_string),"%llX%llX",obj->guid[0],obj->guid[1]) > 0 ? header_string : NULL;
@@ -200,82 +206,88 @@ static const char *header_guid_to_string(OBJECT *obj)
 
 static const char *header_profiler_presync_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_PRESYNC] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_PRESYNC]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_PRESYNC] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_PRESYNC]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_sync_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_SYNC] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_SYNC]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_SYNC] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_SYNC]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_postsync_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_POSTSYNC] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_POSTSYNC]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_POSTSYNC] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_POSTSYNC]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_init_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_INIT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_INIT]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_INIT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_INIT]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_heartbeat_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_HEARTBEAT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_HEARTBEAT]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_HEARTBEAT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_HEARTBEAT]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_precommit_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_PRECOMMIT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_PRECOMMIT]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_PRECOMMIT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_PRECOMMIT]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_commit_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_COMMIT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_COMMIT]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_COMMIT] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_COMMIT]) > 0 ? header_string : NULL;
 }
 
 static const char *header_profiler_finalize_to_string(OBJECT *obj)
 {
-	return obj->synctime[OPI_FINALIZE] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->synctime[OPI_FINALIZE]) > 0 ? header_string : NULL;
+	return obj->cold->synctime[OPI_FINALIZE] != 0 && snprintf(header_string,sizeof(header_string),"%lu",obj->cold->synctime[OPI_FINALIZE]) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_init_to_string(OBJECT *obj)
 {
-	return obj->events.init && snprintf(header_string,sizeof(header_string),"%s",obj->events.init) > 0 ? header_string : NULL;
+	return obj->cold->events.init && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.init) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_precommit_to_string(OBJECT *obj)
 {
-	return obj->events.precommit && snprintf(header_string,sizeof(header_string),"%s",obj->events.precommit) > 0 ? header_string : NULL;
+	return obj->cold->events.precommit && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.precommit) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_presync_to_string(OBJECT *obj)
 {
-	return obj->events.presync && snprintf(header_string,sizeof(header_string),"%s",obj->events.presync) > 0 ? header_string : NULL;
+	return obj->cold->events.presync && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.presync) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_sync_to_string(OBJECT *obj)
 {
-	return obj->events.sync && snprintf(header_string,sizeof(header_string),"%s",obj->events.sync) > 0 ? header_string : NULL;
+	return obj->cold->events.sync && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.sync) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_postsync_to_string(OBJECT *obj)
 {
-	return obj->events.postsync && snprintf(header_string,sizeof(header_string),"%s",obj->events.postsync) > 0 ? header_string : NULL;
+	return obj->cold->events.postsync && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.postsync) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_commit_to_string(OBJECT *obj)
 {
-	return obj->events.commit && snprintf(header_string,sizeof(header_string),"%s",obj->events.commit) > 0 ? header_string : NULL;
+	return obj->cold->events.commit && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.commit) > 0 ? header_string : NULL;
 }
 
 static const char *header_event_finalize_to_string(OBJECT *obj)
 {
-	return obj->events.finalize && snprintf(header_string,sizeof(header_string),"%s",obj->events.finalize) > 0 ? header_string : NULL;
+	return obj->cold->events.finalize && snprintf(header_string,sizeof(header_string),"%s",obj->cold->events.finalize) > 0 ? header_string : NULL;
+}
+
+static const char *header_init_after_to_string(OBJECT *obj)
+{
+	return obj->cold->init_after && snprintf(header_string,sizeof(header_string),"%s",obj->cold->init_after) > 0 ? header_string : NULL;
 }
 
 static const char *header_flags_to_string(OBJECT *obj)
 {
-	return obj->flags != 0 && snprintf(header_string,sizeof(header_string),"0x%llx",obj->flags) > 0 ? header_string : NULL;
+	unsigned long long flags = obj->flags&~OF_UNSAVED;
+	return flags != 0 && snprintf(header_string,sizeof(header_string),"0x%llx",flags) > 0 ? header_string : NULL;
 }
 
 #define HDATAX(X,T,S,N) {#X,T,"PROTECTED",S,N},
@@ -298,6 +310,7 @@ HEADERDATA headerdata[] = {
 	HDATA(out_svc,"timestamp")
 	HDATA(rng_state,"int32")
 	HDATA(heartbeat,"int64")
+	HDATA(delta_substep,"double")
 	HDATAX(guid,"int64",header_guid_to_string,2)
 	HDATAX(profiler.presync,"int32",header_profiler_presync_to_string,0)
 	HDATAX(profiler.sync,"int32",header_profiler_sync_to_string,0)
@@ -314,6 +327,7 @@ HEADERDATA headerdata[] = {
 	HDATAX(event.postsync,"string",header_event_postsync_to_string,0)
 	HDATAX(event.commit,"string",header_event_commit_to_string,0)
 	HDATAX(event.finalize,"string",header_event_finalize_to_string,0)
+	HDATA(init_after,"string")
 	HDATA(flags,"int64")
 	{NULL} // sentinal
 };
@@ -357,7 +371,7 @@ const char *object_headerdata_gettype(HEADERDATA *item)
 }
 
 /* prototypes */
-void object_tree_delete(OBJECT *obj, OBJECTNAME name);
+static void object_name_delete(OBJECT *obj, OBJECTNAME name);
 
 /** Get the number of objects defined 
 
@@ -367,6 +381,59 @@ unsigned int object_get_count(){
 	return next_object_id - deleted_object_count;
 }
 
+/** Get the object generation counter
+
+	The generation changes whenever an object is created or removed, or
+	when a header field that a find program can select on is changed
+	through the object API.  Cached object groups (e.g., aggregations)
+	use it to detect when they must be rebuilt.
+
+	@return the current object generation
+ **/
+unsigned long long object_get_generation(void)
+{
+	return __atomic_load_n(&object_generation,__ATOMIC_ACQUIRE);
+}
+
+/** Advance the object generation counter
+
+	Call this after changing an object header field directly, e.g., when
+	the loader sets the \p groupid or resolves a \p parent reference.
+ **/
+void object_update_generation(void)
+{
+	__atomic_add_fetch(&object_generation,1,__ATOMIC_RELEASE);
+}
+
+/* shared cold header data of objects that have none of their own (never changed) */
+static OBJECTCOLD object_cold_default;
+
+/** Get the cold header data of an object for changing it
+
+	Objects share a default record until one of its fields is set, so
+	the record must be obtained using this call before it is changed.
+
+	@return a pointer to the object's own record
+ **/
+OBJECTCOLD *object_get_cold(OBJECT *obj)
+{
+	if ( obj->cold == NULL || obj->cold == &object_cold_default )
+	{
+		OBJECTCOLD *cold = (OBJECTCOLD*)malloc(sizeof(OBJECTCOLD));
+		if ( cold == NULL )
+		{
+			throw_exception("object_get_cold(OBJECT *obj=<%s:%d>): memory allocation failed", obj->oclass->name, obj->id);
+			/* TROUBLESHOOT
+				The system has run out of memory and is unable to store the group id, event handlers,
+				or profile data of an object.  Try freeing up system memory and try again.
+			 */
+		}
+		*cold = obj->cold ? *obj->cold : object_cold_default;
+		obj->cold = cold;
+	}
+	return obj->cold;
+}
+
 /** Get a named property of an object.  
 
 	Note that you must use object_get_value_by_name to retrieve the value of
@@ -553,6 +620,336 @@ static void object_create_properties(OBJECT *obj,CLASS *oclass)
 	}
 }
 
+/*	Object arena
+
+	When the object_arena global is set, objects are allocated from slabs 
+	reserved for each class so that objects of the same class are contiguous 
+	in memory.  Each object is aligned on a cache line so that objects synced 
+	by different threads never share a line.  Slabs are never freed while
+	objects may still refer to them.  The slabs are also kept in a list 
+	sorted by address so that the slab that owns an object can be found 
+	by a binary search when the object is freed.
+ */
+#define OBJECTSLAB_ALIGN 64 /* cache line size */
+#define OBJECTSLAB_MINSIZE 16 /* minimum number of objects in a new slab */
+#define OBJECTSLAB_MAXSIZE 65536 /* maximum number of objects in a slab unless reserved */
+
+typedef struct s_objectslab {
+	struct s_objectslab *next;	/**< previous slab of the same class */
+	size_t stride;				/**< bytes per object */
+	size_t n_alloc;				/**< number of objects the slab can hold */
+	size_t n_used;				/**< number of objects allocated so far */
+	char *data;					/**< object memory */
+} OBJECTSLAB;
+static OBJECTSLAB **object_slab = NULL; /* current slab of each class (indexed by class id) */
+static size_t n_object_slabs = 0;
+static OBJECTSLAB **object_slab_index = NULL; /* all slabs sorted by data address */
+static size_t n_object_slab_index = 0;
+static size_t max_object_slab_index = 0;
+static LOCKVAR object_arena_lock = 0;
+
+/* add a slab to the sorted slab list */
+static bool object_arena_index(OBJECTSLAB *slab)
+{
+	size_t lo = 0, hi = n_object_slab_index;
+	if ( n_object_slab_index == max_object_slab_index )
+	{
+		size_t n = ( max_object_slab_index == 0 ? 64 : max_object_slab_index*2 );
+		OBJECTSLAB **list = (OBJECTSLAB**)realloc(object_slab_index,sizeof(OBJECTSLAB*)*n);
+		if ( list == NULL )
+			return false;
+		object_slab_index = list;
+		max_object_slab_index = n;
+	}
+	while ( lo < hi )
+	{
+		size_t mid = (lo+hi)/2;
+		if ( object_slab_index[mid]->data < slab->data )
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	memmove(object_slab_index+lo+1,object_slab_index+lo,sizeof(OBJECTSLAB*)*(n_object_slab_index-lo));
+	object_slab_index[lo] = slab;
+	n_object_slab_index++;
+	return true;
+}
+
+/* get the current slab of a class, creating one that has room for n_objects if needed (caller must hold object_arena_lock) */
+static OBJECTSLAB *object_arena_slab(CLASS *oclass, size_t n_objects)
+{
+	OBJECTSLAB *slab, *last;
+	size_t n_alloc;
+	if ( (size_t)oclass->id >= n_object_slabs )
+	{
+		size_t n = oclass->id + 16;
+		OBJECTSLAB **list = (OBJECTSLAB**)realloc(object_slab,sizeof(OBJECTSLAB*)*n);
+		if ( list == NULL )
+			return NULL;
+		memset(list+n_object_slabs,0,sizeof(OBJECTSLAB*)*(n-n_object_slabs));
+		object_slab = list;
+		n_object_slabs = n;
+	}
+	last = object_slab[oclass->id];
+	if ( last != NULL && last->n_used + n_objects <= last->n_alloc )
+		return last;
+
+	/* each new slab is twice the size of the last unless more are reserved */
+	n_alloc = ( last == NULL ? OBJECTSLAB_MINSIZE : last->n_alloc*2 );
+	if ( n_alloc > OBJECTSLAB_MAXSIZE )
+		n_alloc = OBJECTSLAB_MAXSIZE;
+	if ( n_alloc < n_objects )
+		n_alloc = n_objects;
+	slab = (OBJECTSLAB*)malloc(sizeof(OBJECTSLAB));
+	if ( slab == NULL )
+		return NULL;
+	slab->stride = (sizeof(OBJECT)+oclass->size+OBJECTSLAB_ALIGN-1)/OBJECTSLAB_ALIGN*OBJECTSLAB_ALIGN;
+	slab->n_alloc = n_alloc;
+	slab->n_used = 0;
+	if ( posix_memalign((void**)&slab->data,OBJECTSLAB_ALIGN,slab->stride*n_alloc) != 0 )
+	{
+		free(slab);
+		return NULL;
+	}
+	if ( ! object_arena_index(slab) )
+	{
+		free(slab->data);
+		free(slab);
+		return NULL;
+	}
+	slab->next = last;
+	object_slab[oclass->id] = slab;
+	IN_MYCONTEXT output_debug("object_arena_slab(oclass='%s', n_objects=%lu): new slab for %lu objects", 
+		oclass->name, (unsigned long)n_objects, (unsigned long)n_alloc);
+	return slab;
+}
+
+/* allocate an object from the current slab of its class */
+static OBJECT *object_arena_alloc(CLASS *oclass)
+{
+	OBJECT *obj = NULL;
+	OBJECTSLAB *slab;
+	wlock(&object_arena_lock);
+	slab = object_arena_slab(oclass,1);
+	if ( slab != NULL )
+		obj = (OBJECT*)(slab->data + slab->stride*slab->n_used++);
+	wunlock(&object_arena_lock);
+	return obj;
+}
+
+/* check whether an object was allocated from a slab */
+static bool object_arena_owns(OBJECT *obj)
+{
+	size_t lo = 0, hi;
+	bool owned = false;
+	wlock(&object_arena_lock);
+	hi = n_object_slab_index;
+	/* find the last slab that starts at or below the object */
+	while ( lo < hi )
+	{
+		size_t mid = (lo+hi)/2;
+		if ( object_slab_index[mid]->data <= (char*)obj )
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+	if ( lo > 0 )
+	{
+		OBJECTSLAB *slab = object_slab_index[lo-1];
+		owned = ( (char*)obj < slab->data + slab->stride*slab->n_alloc );
+	}
+	wunlock(&object_arena_lock);
+	return owned;
+}
+
+/* free an object unless it was allocated from a slab */
+static void object_free(OBJECT *obj)
+{
+	if ( obj->cold != NULL && obj->cold != &object_cold_default )
+	{
+		free(obj->cold->init_after);
+		free(obj->cold);
+	}
+	if ( n_object_slab_index == 0 || ! object_arena_owns(obj) )
+		free(obj);
+}
+
+/* free all the slabs (only when no objects remain) */
+static void object_arena_free(void)
+{
+	size_t n;
+	for ( n = 0 ; n < n_object_slabs ; n++ )
+	{
+		while ( object_slab[n] != NULL )
+		{
+			OBJECTSLAB *slab = object_slab[n];
+			object_slab[n] = slab->next;
+			free(slab->data);
+			free(slab);
+		}
+	}
+	free(object_slab);
+	object_slab = NULL;
+	n_object_slabs = 0;
+	free(object_slab_index);
+	object_slab_index = NULL;
+	n_object_slab_index = max_object_slab_index = 0;
+}
+
+/** Reserve memory for objects of a class.  When the object arena is
+	enabled, this ensures that the next \p n_objects objects created
+	in the class are contiguous in memory.
+	@return SUCCESS or FAILED if memory could not be reserved
+ **/
+STATUS object_reserve(CLASS *oclass, /**< the class of the objects */
+					  unsigned int n_objects) /**< the number of objects that will be created */
+{
+	OBJECTSLAB *slab;
+	if ( ! global_object_arena || n_objects < 2 )
+		return SUCCESS;
+	wlock(&object_arena_lock);
+	slab = object_arena_slab(oclass,n_objects);
+	wunlock(&object_arena_lock);
+	return slab == NULL ? FAILED : SUCCESS;
+}
+
+/** Test the object arena.  Objects are created in a test class from
+	slabs and from the heap in turn, and the slab that owns each one is
+	looked up the way object_free does.
+	@return the number of failed tests
+ **/
+int object_arena_test(void)
+{
+	int failed = 0, ok = 0;
+	bool arena = global_object_arena;
+	CLASS *oclass = class_get_class_from_classname("object_arena_test");
+	OBJECT *obj[256];
+	size_t n;
+
+	output_test("\nBEGIN: object arena tests");
+	if ( oclass == NULL )
+		oclass = class_register(NULL,"object_arena_test",sizeof(double),PC_NOSYNC);
+	if ( oclass == NULL )
+	{
+		output_test("unable to register class 'object_arena_test'");
+		failed++;
+		goto Done;
+	}
+
+	/* reserved objects are contiguous, aligned and owned by a slab */
+	global_object_arena = true;
+	if ( object_reserve(oclass,100) == FAILED )
+	{
+		output_test("unable to reserve 100 objects");
+		failed++;
+		goto Done;
+	}
+	for ( n = 0 ; n < 100 ; n++ )
+	{
+		obj[n] = object_create_single(oclass);
+		if ( ((size_t)obj[n])%OBJECTSLAB_ALIGN != 0 || ! object_arena_owns(obj[n]) )
+		{
+			output_test("reserved object %d at %p is not aligned or not owned by a slab", (int)n, obj[n]);
+			failed++;
+		}
+		else if ( n > 0 && (char*)obj[n]-(char*)obj[n-1] != (char*)obj[1]-(char*)obj[0] )
+		{
+			output_test("reserved object %d at %p is not contiguous with object %d at %p", (int)n, obj[n], (int)n-1, obj[n-1]);
+			failed++;
+		}
+		else
+			ok++;
+	}
+
+	/* objects created with and without the arena are told apart, including from new slabs */
+	for ( n = 100 ; n < sizeof(obj)/sizeof(obj[0]) ; n++ )
+	{
+		global_object_arena = ( n%2 == 0 );
+		obj[n] = object_create_single(oclass);
+	}
+	for ( n = 0 ; n < sizeof(obj)/sizeof(obj[0]) ; n++ )
+	{
+		bool expected = ( n < 100 || n%2 == 0 );
+		if ( object_arena_owns(obj[n]) != expected )
+		{
+			output_test("object %d at %p %s owned by a slab", (int)n, obj[n], expected ? "is not" : "is");
+			failed++;
+		}
+		else
+			ok++;
+	}
+
+	/* the binary search finds the same owner as a scan of every slab, including at the slab edges */
+	global_object_arena = true;
+	for ( n = 0 ; n < 1000 ; n++ )
+	{
+		if ( object_arena_alloc(oclass) == NULL )
+		{
+			output_test("slab allocation %d failed", (int)n);
+			failed++;
+			break;
+		}
+	}
+	for ( n = 0 ; n < n_object_slab_index ; n++ )
+	{
+		OBJECTSLAB *slab = object_slab_index[n];
+		char *probe[] = {slab->data-1, slab->data, slab->data+slab->stride*slab->n_alloc-1, slab->data+slab->stride*slab->n_alloc};
+		for ( size_t p = 0 ; p < sizeof(probe)/sizeof(probe[0]) ; p++ )
+		{
+			bool expected = false;
+			for ( size_t m = 0 ; m < n_object_slab_index ; m++ )
+			{
+				OBJECTSLAB *other = object_slab_index[m];
+				if ( probe[p] >= other->data && probe[p] < other->data+other->stride*other->n_alloc )
+					expected = true;
+			}
+			if ( object_arena_owns((OBJECT*)probe[p]) != expected )
+			{
+				output_test("address %p %s owned by a slab", probe[p], expected ? "is not" : "is");
+				failed++;
+			}
+			else
+				ok++;
+		}
+	}
+
+	/* heap objects are freed and slab objects are left to their slabs */
+	for ( n = 0 ; n < 100 ; n++ )
+	{
+		OBJECT *item = (OBJECT*)malloc(sizeof(OBJECT)+oclass->size);
+		if ( item == NULL )
+			break;
+		memset(item,0,sizeof(OBJECT)+oclass->size);
+		item->cold = &object_cold_default;
+		if ( object_arena_owns(item) )
+		{
+			output_test("heap object at %p is owned by a slab", item);
+			failed++;
+			free(item);
+		}
+		else
+		{
+			object_free(item);
+			ok++;
+		}
+	}
+
+Done:
+	global_object_arena = arena;
+	if ( failed )
+	{
+		output_error("objectarenatest: %d object arena tests failed--see test.txt for more information",failed);
+		output_test("!!! %d object arena tests failed",failed);
+	}
+	else
+	{
+		IN_MYCONTEXT output_verbose("%d object arena tests completed with no errors--see test.txt for details",ok);
+		output_test("objectarenatest: %d object arena tests completed with no errors",ok);
+	}
+	output_test("END: object arena tests");
+	return failed;
+}
+
 /** Create a single object.
 	@return a pointer to object header, \p NULL of error, set \p errno as follows:
 	- \p EINVAL type is not valid
@@ -580,7 +977,7 @@ OBJECT *object_create_single(CLASS *oclass) /**< the class of the object */
 		*/
 	}
 
-	obj = (OBJECT*)malloc(sz + oclass->size);
+	obj = global_object_arena ? object_arena_alloc(oclass) : (OBJECT*)malloc(sz + oclass->size);
 	if ( obj == NULL )
 	{
 		throw_exception("object_create_single(CLASS *oclass='%s'): memory allocation failed", oclass->name);
@@ -610,7 +1007,12 @@ OBJECT *object_create_single(CLASS *oclass) /**< the class of the object */
 	obj->flags = OF_NONE;
 	obj->rng_state = randwarn(NULL);
 	obj->heartbeat = 0;
-	obj->events = oclass->events;
+	obj->delta_substep = 0;
+	obj->cold = &object_cold_default;
+	if ( memcmp(&oclass->events,&object_cold_default.events,sizeof(EVENTHANDLERS)) != 0 )
+	{
+		object_get_cold(obj)->events = oclass->events;
+	}
 	random_key(obj->guid,sizeof(obj->guid)/sizeof(obj->guid[0]));
 
 	object_create_properties(obj,obj->oclass);
@@ -626,6 +1028,7 @@ OBJECT *object_create_single(CLASS *oclass) /**< the class of the object */
 	
 	last_object = obj;
 	oclass->profiler.numobjs++;
+	object_update_generation();
 	
 	return obj;
 }
@@ -664,7 +1067,7 @@ OBJECT *object_create_foreign(OBJECT *obj) /**< a pointer to the OBJECT data str
 			This is most likely a bug and should be reported.
 		 */
 
-	memset(obj->synctime,0,sizeof(obj->synctime));
+	obj->cold = &object_cold_default;
 
 	obj->id = next_object_id++;
 	obj->next = NULL;
@@ -690,6 +1093,7 @@ OBJECT *object_create_foreign(OBJECT *obj) /**< a pointer to the OBJECT data str
 	
 	last_object = obj;
 	obj->oclass->profiler.numobjs++;
+	object_update_generation();
 	
 	return obj;
 }
@@ -717,6 +1121,7 @@ OBJECT *object_create_array(CLASS *oclass, /**< a pointer to the CLASS structure
 							unsigned int n_objects){ /**< the number of objects to create */
 	OBJECT *first = NULL;
 	
+	object_reserve(oclass,n_objects);
 	while(n_objects-- > 0){
 		OBJECT *obj = object_create_single(oclass);
 		
@@ -749,13 +1154,14 @@ OBJECT *object_remove_by_id(OBJECTNUM id){
 			}
 		}
 		
-		object_tree_delete(target, target->name ? target->name : (sprintf(name, "%s:%d", target->oclass->name, target->id), name));
+		object_name_delete(target, target->name ? target->name : (sprintf(name, "%s:%d", target->oclass->name, target->id), name));
 		next = target->next;
 		prev->next = next;
 		target->oclass->profiler.numobjs--;
-		free(target);
+		object_free(target);
 		target = NULL;
 		deleted_object_count++;
+		object_update_generation();
 	}
 	
 	return next;
@@ -1082,6 +1488,52 @@ int object_set_value_by_addr(OBJECT *obj, /**< the object to alter */
 	return result;
 }
 
+/** Set the objects that must be initialized before an object.
+	The value is a comma-separated list of object names.  The names are
+	resolved when the objects are initialized, so they may refer to objects
+	that are defined later (see <IS_DEPENDENCY>).
+	@return SUCCESS or FAILED
+ **/
+STATUS object_set_init_after(OBJECT *obj, const char *value)
+{
+	char *list = NULL;
+	if ( strcmp(value,"") != 0 && (list=strdup(value)) == NULL )
+	{
+		output_error("object %s:%d init_after '%s' cannot be stored", obj->oclass->name, obj->id, value);
+		/*	TROUBLESHOOT
+			The system has run out of memory while storing the init_after list of an object.
+			Try freeing up system memory and try again.
+		*/
+		return FAILED;
+	}
+	OBJECTCOLD *cold = object_get_cold(obj);
+	free(cold->init_after);
+	cold->init_after = list;
+	return SUCCESS;
+}
+
+/** Set the preferred deltamode update interval of an object.
+	The value is given in seconds unless a time unit is specified, e.g., "10 ms".
+	@return SUCCESS or FAILED
+ **/
+STATUS object_set_delta_substep(OBJECT *obj, const char *value)
+{
+	double substep;
+	char unit[32] = "s";
+	if ( sscanf(value,"%lf%*[ \t]%31s",&substep,unit) < 1 || ! unit_convert(unit,"s",&substep) || substep < 0 )
+	{
+		output_error("object %s:%d delta_substep '%s' is invalid", obj->oclass->name, obj->id, value);
+		/*	TROUBLESHOOT
+			The deltamode update interval of an object must be a positive time, 
+			optionally followed by a time unit, e.g., "10 ms".  Use 0 to update
+			the object on every deltamode timestep.
+		*/
+		return FAILED;
+	}
+	obj->delta_substep = substep;
+	return SUCCESS;
+}
+
 static int set_header_value(OBJECT *obj, const char *name, const char *value)
 {
 	unsigned int temp_microseconds;
@@ -1113,7 +1565,7 @@ static int set_header_value(OBJECT *obj, const char *name, const char *value)
 			output_error("object %s:%d parent %s not found", obj->oclass->name, obj->id, value);
 			return FAILED;
 		}
-		else if(object_set_parent(obj,parent)==FAILED && strcmp(value,"")!=0)
+		else if(object_set_parent(obj,parent)<0 && strcmp(value,"")!=0)
 		{
 			output_error("object %s:%d cannot use parent %s", obj->oclass->name, obj->id, value);
 			return FAILED;
@@ -1202,6 +1654,7 @@ static int set_header_value(OBJECT *obj, const char *name, const char *value)
 			obj->in_svc = tval;
 			obj->in_svc_micro = temp_microseconds;
 			obj->in_svc_double = tval_double;
+			object_update_generation();
 			return SUCCESS;
 		}
 	}
@@ -1224,6 +1677,7 @@ static int set_header_value(OBJECT *obj, const char *name, const char *value)
 			obj->out_svc = tval;
 			obj->out_svc_micro = temp_microseconds;
 			obj->out_svc_double = tval_double;
+			object_update_generation();
 			return SUCCESS;
 		}
 	}
@@ -1246,16 +1700,24 @@ static int set_header_value(OBJECT *obj, const char *name, const char *value)
 			return SUCCESS;
 		}
 	}
+	else if ( strcmp(name,"delta_substep")==0 )
+	{
+		return object_set_delta_substep(obj,value);
+	}
+	else if ( strcmp(name,"init_after")==0 )
+	{
+		return object_set_init_after(obj,value);
+	}
 	else if ( strcmp(name,"groupid")==0 )
 	{
-		if ( strlen(value)<sizeof(obj->groupid) )
+		if ( strlen(value)<sizeof(obj->cold->groupid) )
 		{
-			strcpy(obj->groupid,value);
+			strcpy(object_get_cold(obj)->groupid,value);
 			return SUCCESS;
 		}
 		else
 		{
-			output_error("object %s:%d groupid '%s' is too long (max=%d)", obj->oclass->name, obj->id, value, sizeof(obj->groupid));
+			output_error("object %s:%d groupid '%s' is too long (max=%d)", obj->oclass->name, obj->id, value, sizeof(obj->cold->groupid));
 			return FAILED;
 		}
 	}
@@ -1272,7 +1734,7 @@ static int set_header_value(OBJECT *obj, const char *name, const char *value)
 		output_error("object %s:%d called set_header_value() for invalid field '%s'", obj->oclass->name, obj->id, name);
 		/*	TROUBLESHOOT
 			The valid header fields are "name", "parent", "rank", "clock", "valid_to", "latitude",
-			"longitude", "in_svc", "out_svc", "heartbeat", and "flags".
+			"longitude", "in_svc", "out_svc", "heartbeat", "delta_substep", "init_after", and "flags".
 		*/
 		return FAILED;
 	}
@@ -1349,15 +1811,23 @@ const char *object_get_header_string(OBJECT *obj, const char *item, char *buffer
 	}
 	else if ( strcmp(item,"flags") == 0 )
 	{
-		snprintf(buffer,len,"%llu",(long long)obj->flags);
+		snprintf(buffer,len,"%llu",(long long)(obj->flags&~OF_UNSAVED));
 	}
 	else if ( strcmp(item,"heartbeat") == 0 )
 	{
 		snprintf(buffer,len,"%llu",obj->heartbeat);
 	}
+	else if ( strcmp(item,"delta_substep") == 0 )
+	{
+		snprintf(buffer,len,"%g s",obj->delta_substep);
+	}
 	else if ( strcmp(item,"groupid") == 0 )
 	{
-		snprintf(buffer,len,"%s",(const char*)obj->groupid);
+		snprintf(buffer,len,"%s",(const char*)obj->cold->groupid);
+	}
+	else if ( strcmp(item,"init_after") == 0 )
+	{
+		snprintf(buffer,len,"%s",obj->cold->init_after?obj->cold->init_after:"");
 	}
 	else if ( strcmp(item,"rng_state") == 0 )
 	{
@@ -1369,31 +1839,31 @@ const char *object_get_header_string(OBJECT *obj, const char *item, char *buffer
 	}
 	else if ( strcmp(item,"on_init") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.init ? obj->events.init : "");
+		snprintf(buffer,len,"%s", obj->cold->events.init ? obj->cold->events.init : "");
 	}
 	else if ( strcmp(item,"on_precommit") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.precommit ? obj->events.precommit : "");
+		snprintf(buffer,len,"%s", obj->cold->events.precommit ? obj->cold->events.precommit : "");
 	}
 	else if ( strcmp(item,"on_presync") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.presync ? obj->events.presync : "");
+		snprintf(buffer,len,"%s", obj->cold->events.presync ? obj->cold->events.presync : "");
 	}
 	else if ( strcmp(item,"on_sync") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.sync ? obj->events.sync : "");
+		snprintf(buffer,len,"%s", obj->cold->events.sync ? obj->cold->events.sync : "");
 	}
 	else if ( strcmp(item,"on_postsync") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.postsync ? obj->events.postsync : "");
+		snprintf(buffer,len,"%s", obj->cold->events.postsync ? obj->cold->events.postsync : "");
 	}
 	else if ( strcmp(item,"on_commit") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.commit ? obj->events.commit : "");
+		snprintf(buffer,len,"%s", obj->cold->events.commit ? obj->cold->events.commit : "");
 	}
 	else if ( strcmp(item,"on_finalize") == 0 )
 	{
-		snprintf(buffer,len,"%s", obj->events.finalize ? obj->events.finalize : "");
+		snprintf(buffer,len,"%s", obj->cold->events.finalize ? obj->cold->events.finalize : "");
 	}
 	else
 	{
@@ -1421,6 +1891,7 @@ int object_set_value_by_name(OBJECT *obj, /**< the object to change */
 		}
 		else
 		{
+			object_update_generation();
 			size_t len = strlen(value);
 			return len>0?(int)len:1; /* empty string is not necessarily wrong */
 		}
@@ -1685,12 +2156,17 @@ static OBJECTRANK set_rank(OBJECT *obj, OBJECTRANK rank, OBJECT *first)
 		return -1;
 	}
 	if ( rank > obj->rank )
+	{
 		obj->rank = rank;
+		object_update_generation();
+	}
 	return obj->rank;
 }
 
 /** Set the rank of an object but forcing it's parent
-	to increase rank if necessary.
+	to increase rank if necessary.  The object is flagged
+	as reranked so that the sync scheduler knows its rank
+	is not implied by its children alone.
 	@return object rank; -1 if failed 
  **/
 OBJECTRANK object_set_rank(OBJECT *obj, /**< the object to set */
@@ -1698,6 +2174,7 @@ OBJECTRANK object_set_rank(OBJECT *obj, /**< the object to set */
 {
 	if ( obj == NULL )
 		return -1;
+	obj->flags |= OF_RERANK;
 	return set_rank(obj,rank,NULL);
 }
 
@@ -1720,7 +2197,8 @@ int object_set_parent(OBJECT *obj, /**< the object to set */
 	}
 	obj->parent = parent;
 	obj->child_count++;
-	if ( object_set_rank(parent,obj->rank+1) < obj->rank )
+	object_update_generation();
+	if ( parent != NULL && set_rank(parent,obj->rank+1,NULL) < obj->rank )
 	{
 		char tmp1[64], tmp2[64];
 		object_name(obj,tmp1,sizeof(tmp1));
@@ -1756,6 +2234,7 @@ int object_set_dependent(OBJECT *obj, /**< the object to set */
 	if(obj == dependent)
 		return -1;
 	
+	dependent->flags |= OF_RERANK;
 	return set_rank(dependent,obj->rank,NULL);
 }
 
@@ -1841,7 +2320,7 @@ void object_profile(OBJECT *obj, OBJECTPROFILEITEM pass, clock_t t)
 	if ( global_profiler==1 )
 	{
 		clock_t dt = (clock_t)exec_clock()-t;
-		obj->synctime[pass] += dt;
+		object_get_cold(obj)->synctime[pass] += dt;
 		wlock(&obj->oclass->profiler.lock);
 		obj->oclass->profiler.count++;
 		obj->oclass->profiler.clocks += dt;
@@ -1865,7 +2344,7 @@ void object_synctime_profile_dump(const char *filename)
 		int i;
 		fprintf(fp,"%s,%u,%s",obj->oclass->name,obj->id,obj->name?obj->name:"");
 		for ( i = 0 ; i < _OPI_NUMITEMS ; i++ )
-			fprintf(fp,",%llu",(unsigned long long)obj->synctime[i]);
+			fprintf(fp,",%llu",(unsigned long long)obj->cold->synctime[i]);
 		fprintf(fp,"\n");
 	}
 	fclose(fp);
@@ -2015,13 +2494,13 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 	switch (pass) 
 	{
 	case PC_PRETOPDOWN:
-		event = obj->events.presync;
+		event = obj->cold->events.presync;
 		break;
 	case PC_BOTTOMUP:
-		event = obj->events.sync;
+		event = obj->cold->events.sync;
 		break;
 	case PC_POSTTOPDOWN:
-		event = obj->events.postsync;
+		event = obj->cold->events.postsync;
 		break;
 	default:
 		break;
@@ -2080,10 +2559,10 @@ int object_init(OBJECT *obj) /**< the object to initialize */
 	obj->clock = global_starttime;
 	if ( obj->oclass->init != NULL )
 		rv = (int)(*(obj->oclass->init))(obj, obj->parent);
-	if ( rv == 1 && obj->events.init != NULL )
+	if ( rv == 1 && obj->cold->events.init != NULL )
 	{
 		long long ok = 0;
-		int rc = object_event(obj,obj->events.init,&ok);
+		int rc = object_event(obj,obj->cold->events.init,&ok);
 		if ( rc != 0 || ok != 0 )
 		{
 			output_error("object %s:%d init at ts=%d event handler failed with code %d (retval=%lld)",obj->oclass->name,obj->id,global_starttime,rc,ok);
@@ -2124,10 +2603,10 @@ STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 		// if 'old school' or no precommit callback,
 		rv = SUCCESS;
 	}
-	if ( rv == 1 && obj->events.precommit != NULL )
+	if ( rv == 1 && obj->cold->events.precommit != NULL )
 	{
 		long long t2 = TS_NEVER;
-		int rc = object_event(obj,obj->events.precommit,&t2);
+		int rc = object_event(obj,obj->cold->events.precommit,&t2);
 		if ( rc != 0 || t2 < t1 )
 		{
 			output_error("object %s:%d precommit at ts=%d event handler failed with code %d (retval=%lld)",obj->oclass->name,obj->id,global_starttime,rc,t2);
@@ -2159,9 +2638,9 @@ TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 		// if 'old school' or no commit callback,
 		rv =TS_NEVER;
 	} 
-	if ( obj->events.commit != NULL )
+	if ( obj->cold->events.commit != NULL )
 	{
-		int rc = object_event(obj,obj->events.commit,&rv);
+		int rc = object_event(obj,obj->cold->events.commit,&rv);
 		if ( rc != 0 || rv == TS_INVALID )
 		{
 			output_error("object %s:%d commit at ts=%d event handler failed with code %d (retval=%lld)",obj->oclass->name,obj->id,global_starttime,rc,rv);
@@ -2193,10 +2672,10 @@ STATUS object_finalize(OBJECT *obj)
 	if(rv == 1){ // if 'old school' or no finalize callback,
 		rv = SUCCESS;
 	}
-	if ( obj->events.finalize != NULL )
+	if ( obj->cold->events.finalize != NULL )
 	{
 		long long rv = 0;
-		int rc = object_event(obj,obj->events.finalize,&rv);
+		int rc = object_event(obj,obj->cold->events.finalize,&rv);
 		if ( rc != 0 )
 		{
 			output_error("object %s:%d precommit at ts=%d event handler failed with code %d",obj->oclass->name,obj->id,global_starttime,rc);
@@ -2265,7 +2744,8 @@ size_t object_dump(char *outbuffer, /**< the destination buffer */
 	if(!isnan(obj->longitude)){
 		count += sprintf(buffer + count, "\tlongitude = %s;\n", convert_from_longitude(obj->longitude, tmp, sizeof(tmp)) ? tmp : "(invalid)");
 	}
-	count += sprintf(buffer + count, "\tflags = %s;\n", convert_from_set(tmp, sizeof(tmp), &(obj->flags), object_flag_property()) ? tmp : "(invalid)");
+	set flags = obj->flags&~OF_UNSAVED;
+	count += sprintf(buffer + count, "\tflags = %s;\n", convert_from_set(tmp, sizeof(tmp), &flags, object_flag_property()) ? tmp : "(invalid)");
 
 	/* dump properties */
 	for (prop = obj->oclass->pmap; prop != NULL && prop->oclass == obj->oclass; prop = prop->next)
@@ -2364,7 +2844,8 @@ size_t object_save(char *buffer, size_t size, OBJECT *obj)
 	if( !isnan(obj->longitude) ){
 		count += sprintf(temp+count, "\tlongitude %s;\n", convert_from_longitude(obj->longitude, buffer, sizeof(buffer)) ? buffer : "(invalid)");
 	}
-	count += sprintf(temp+count, "\tflags %s;\n", convert_from_set(buffer, sizeof(buffer), &(obj->flags), object_flag_property()) ? buffer : "(invalid)");
+	set flags = obj->flags&~OF_UNSAVED;
+	count += sprintf(temp+count, "\tflags %s;\n", convert_from_set(buffer, sizeof(buffer), &flags, object_flag_property()) ? buffer : "(invalid)");
 
 	/* dump class-defined properties */
 	for ( pclass=obj->oclass->parent ; pclass!=NULL ; pclass=pclass->parent )
@@ -2482,8 +2963,8 @@ int object_saveall(FILE *fp) /**< the stream to write to */
 				count += fprintf(fp, "\tname \"%s\";\n", obj->name);
 			else if ( (global_glm_save_options&GSO_NOINTERNALS)==GSO_NOINTERNALS )
 				count += fprintf(fp, "\tname \"%s:%d\";\n", oclass->name, obj->id);
-			if ( obj->groupid[0] != '\0' )
-				count += fprintf(fp,"\tgroupid \"%s\";\n", (const char*)obj->groupid);
+			if ( obj->cold->groupid[0] != '\0' )
+				count += fprintf(fp,"\tgroupid \"%s\";\n", (const char*)obj->cold->groupid);
 			if ( (global_glm_save_options&GSO_NOINTERNALS)==0 && convert_from_timestamp(obj->clock, buffer, sizeof(buffer)) )
 				count += fprintf(fp,"\tclock '%s';\n",  buffer);
 			if ( !isnan(obj->latitude) )
@@ -2504,26 +2985,27 @@ int object_saveall(FILE *fp) /**< the stream to write to */
 				count += fprintf(fp, "\theartbeat \"%lld\";\n", (int64)obj->heartbeat);
 			if ( obj->guid[0] != 0 || obj->guid[1] != 0 )
 				count += fprintf(fp, "\tguid \"%08llX%08llX\";\n", obj->guid[0], obj->guid[1]);
-			if ( obj->events.init )
-				count += fprintf(fp, "\ton_init \"%s\";\n", obj->events.init);
-			if ( obj->events.precommit )
-				count += fprintf(fp, "\ton_precommit \"%s\";\n", obj->events.precommit);
-			if ( obj->events.presync )
-				count += fprintf(fp, "\ton_presync \"%s\";\n", obj->events.presync);
-			if ( obj->events.sync )
-				count += fprintf(fp, "\ton_sync \"%s\";\n", obj->events.sync);
-			if ( obj->events.postsync )
-				count += fprintf(fp, "\ton_postsync \"%s\";\n", obj->events.postsync);
-			if ( obj->events.commit )
-				count += fprintf(fp, "\ton_commit \"%s\";\n", obj->events.commit);
-			if ( obj->events.finalize )
-				count += fprintf(fp, "\ton_finalize \"%s\";\n", obj->events.finalize);
+			if ( obj->cold->events.init )
+				count += fprintf(fp, "\ton_init \"%s\";\n", obj->cold->events.init);
+			if ( obj->cold->events.precommit )
+				count += fprintf(fp, "\ton_precommit \"%s\";\n", obj->cold->events.precommit);
+			if ( obj->cold->events.presync )
+				count += fprintf(fp, "\ton_presync \"%s\";\n", obj->cold->events.presync);
+			if ( obj->cold->events.sync )
+				count += fprintf(fp, "\ton_sync \"%s\";\n", obj->cold->events.sync);
+			if ( obj->cold->events.postsync )
+				count += fprintf(fp, "\ton_postsync \"%s\";\n", obj->cold->events.postsync);
+			if ( obj->cold->events.commit )
+				count += fprintf(fp, "\ton_commit \"%s\";\n", obj->cold->events.commit);
+			if ( obj->cold->events.finalize )
+				count += fprintf(fp, "\ton_finalize \"%s\";\n", obj->cold->events.finalize);
 			if ( (global_glm_save_options&GSO_NOINTERNALS)==0 )
 			{
-				if ( convert_from_set(buffer, sizeof(buffer), &(obj->flags), object_flag_property()) > 0 )
+				set flags = obj->flags&~OF_UNSAVED;
+				if ( convert_from_set(buffer, sizeof(buffer), &flags, object_flag_property()) > 0 )
 					count += fprintf(fp, "\tflags \"%s\";\n",  buffer);
 				else
-					count += fprintf(fp, "\tflags \"%lld\";\n", (unsigned long long)obj->flags);
+					count += fprintf(fp, "\tflags \"%lld\";\n", (unsigned long long)flags);
 			}
 
 			/* dump properties */
@@ -2838,153 +3320,231 @@ double convert_to_longitude(const char *buffer)
 }
 
 /***************************************************************************
- OBJECT NAME TREE
+ OBJECT NAME INDEX
  ***************************************************************************/
 
-#define TREESIZE 65536*16
-typedef struct s_objecttree {
-	const char *name;
-	OBJECT *obj;
-	struct s_objecttree *next;
-} OBJECTTREE;
-static OBJECTTREE *top[TREESIZE];
+/* The name index is an open-addressing hash table with linear probing.
+   Lookups do not lock: a slot is published by storing its hash last, a
+   removed name only clears the object of its slot, and a table that is
+   replaced when the index grows is kept until the objects are removed so
+   that a concurrent lookup can finish probing it.  Changes are serialized
+   by name_index_lock.  Names are copied into a pool that is never freed
+   while objects exist, because obj->name refers to the copy.
+ */
 typedef unsigned long long HASH;
+typedef struct s_objectnameslot {
+	HASH hash; /**< hash of the name (0 if the slot is empty) */
+	const char *name; /**< name of the object */
+	OBJECT *obj; /**< object (NULL if the name was removed) */
+} OBJECTNAMESLOT;
+typedef struct s_objectnameindex {
+	size_t size; /**< number of slots (a power of 2) */
+	size_t used; /**< number of slots used, including removed names */
+	OBJECTNAMESLOT *slot; /**< slots */
+	struct s_objectnameindex *retired; /**< table replaced by this one */
+} OBJECTNAMEINDEX;
+typedef struct s_objectnamepool {
+	size_t used; /**< bytes used in this block */
+	size_t size; /**< bytes available in this block */
+	struct s_objectnamepool *next; /**< previous block */
+	char data[1]; /**< names */
+} OBJECTNAMEPOOL;
+#define NAMEINDEX_MINSIZE 1024
+#define NAMEPOOL_BLOCKSIZE 65536
+static OBJECTNAMEINDEX *name_index = NULL;
+static OBJECTNAMEPOOL *name_pool = NULL;
+static LOCKVAR name_index_lock = 0;
+
+/* copy a name into the name pool (name_index_lock must be held) */
+static const char *object_name_copy(OBJECTNAME name)
+{
+	size_t len = strlen(name)+1;
+	if ( name_pool == NULL || name_pool->used + len > name_pool->size )
+	{
+		size_t size = len > NAMEPOOL_BLOCKSIZE ? len : NAMEPOOL_BLOCKSIZE;
+		OBJECTNAMEPOOL *block = (OBJECTNAMEPOOL*)malloc(sizeof(OBJECTNAMEPOOL)+size);
+		if ( block == NULL )
+		{
+			return NULL;
+		}
+		block->used = 0;
+		block->size = size;
+		block->next = name_pool;
+		name_pool = block;
+	}
+	char *copy = name_pool->data + name_pool->used;
+	memcpy(copy,name,len);
+	name_pool->used += len;
+	return copy;
+}
 
-static HASH hash(OBJECTNAME name)
+/* find the slot of a name in a table (NULL if none) */
+static OBJECTNAMESLOT *object_name_slot(OBJECTNAMEINDEX *index, OBJECTNAME name, HASH h)
 {
-	static HASH A = 55711, B = 45131; //, C = 60083; isn't used but should be in principle
-	HASH h = 18443;
-	const char *p;
-	bool ok = true;
-	for ( p = name ; ok ; p++ )
+	size_t mask = index->size-1;
+	for ( size_t n = h&mask ; ; n = (n+1)&mask )
 	{
-		unsigned long long c = *p;
-		if ( (c&0xff) == 0 )
-			break;
-		else if ( (c&0xff00) == 0 )
+		OBJECTNAMESLOT *slot = index->slot+n;
+		HASH found = __atomic_load_n(&slot->hash,__ATOMIC_ACQUIRE);
+		if ( found == 0 )
 		{
-			ok = false;
-			c &= 0x00000000000000ff;
-		}
-		else if ( (c&0xff0000) == 0 )
-		{
-			ok = false;
-			c &= 0x000000000000ffff;
-		}
-		else if ( (c&0xff000000) == 0 )
-		{
-			ok = false;
-			c &= 0x0000000000ffffff;
+			return NULL;
 		}
-		else if ( (c&0xff00000000) == 0 )
+		if ( found == h && strcmp(slot->name,name) == 0 )
 		{
-			ok = false;
-			c &= 0x00000000ffffffff;
+			return slot;
 		}
-		else if ( (c&0xff0000000000) == 0 )
+	}
+}
+
+/* store a name in the first empty slot of a table that has room for it */
+static void object_name_store(OBJECTNAMEINDEX *index, HASH h, const char *name, OBJECT *obj)
+{
+	size_t mask = index->size-1;
+	size_t n = h&mask;
+	while ( index->slot[n].hash != 0 )
+	{
+		n = (n+1)&mask;
+	}
+	index->slot[n].name = name;
+	index->slot[n].obj = obj;
+	__atomic_store_n(&index->slot[n].hash,h,__ATOMIC_RELEASE);
+	index->used++;
+}
+
+/* replace the table with one that has room for n more names (name_index_lock must be held) */
+static bool object_name_grow(size_t n)
+{
+	size_t live = 0;
+	if ( name_index != NULL )
+	{
+		if ( (name_index->used+n)*2 <= name_index->size )
 		{
-			ok = false;
-			c &= 0x000000ffffffffff;
+			return true;
 		}
-		else if ( (c&0xff000000000000) == 0 )
+		for ( size_t m = 0 ; m < name_index->size ; m++ )
 		{
-			ok = false;
-			c &= 0x0000ffffffffffff;
+			if ( name_index->slot[m].obj != NULL )
+			{
+				live++;
+			}
 		}
-		else if ( (c&0xff00000000000000) == 0 )
+	}
+	size_t size = NAMEINDEX_MINSIZE;
+	while ( size < (live+n)*2 )
+	{
+		size *= 2;
+	}
+	OBJECTNAMEINDEX *index = (OBJECTNAMEINDEX*)malloc(sizeof(OBJECTNAMEINDEX));
+	OBJECTNAMESLOT *slot = (OBJECTNAMESLOT*)calloc(size,sizeof(OBJECTNAMESLOT));
+	if ( index == NULL || slot == NULL )
+	{
+		free(index);
+		free(slot);
+		return false;
+	}
+	index->size = size;
+	index->used = 0;
+	index->slot = slot;
+	index->retired = name_index;
+	if ( name_index != NULL )
+	{
+		for ( size_t m = 0 ; m < name_index->size ; m++ )
 		{
-			ok = false;
-			c &= 0x00ffffffffffffff;
+			OBJECTNAMESLOT *item = name_index->slot+m;
+			if ( item->obj != NULL )
+			{
+				object_name_store(index,item->hash,item->name,item->obj);
+			}
 		}
-		h = ((h*A)^(c*B));
 	}
-	h %= TREESIZE;
-	if ( global_debug_output )
-	{
-		IN_MYCONTEXT output_debug("hash(name='%s') = %llu",name,h);
-	}	
-	return h;
+	__atomic_store_n(&name_index,index,__ATOMIC_RELEASE);
+	return true;
 }
 
-OBJECTTREE *hash_find(HASH h, OBJECTNAME name)
+/** Reserve room in the name index for names that are about to be set.
+
+	Loaders that know how many named objects they will create can call
+	this first so the index is not rebuilt while the names are added.
+
+	@return SUCCESS or FAILED
+ **/
+STATUS object_name_reserve(size_t n) /**< number of names to add */
 {
-	OBJECTTREE *item;
-	for ( item = top[h] ; item != NULL ; item = item->next )
-	{
-		if ( strcmp(item->name,name) == 0 )
-			return item;
-	}
-	if ( global_debug_output )
-	{
-		IN_MYCONTEXT output_debug("hash_find(HASH h=%lld, OBJECTNAME name='%s'): name not found",h,name);
-	}	
-	return NULL;
+	wlock(&name_index_lock);
+	bool ok = object_name_grow(n);
+	wunlock(&name_index_lock);
+	return ok ? SUCCESS : FAILED;
 }
 
-/*	Add an object to the object tree.  Throws exceptions on memory errors.
-	Returns a pointer to the object tree item if successful, NULL on failure (usually because name already used)
+/*	Add a name to the index.
+	Returns the stored name, or NULL if another object already uses the name
  */
-static OBJECTTREE *object_tree_add(OBJECT *obj, OBJECTNAME name)
+static const char *object_name_add(OBJECT *obj, OBJECTNAME name)
 {
-	OBJECTTREE *item = (OBJECTTREE*)malloc(sizeof(OBJECTTREE));
-	item->name = strdup(name);
-	if ( item->name == NULL )
+	HASH h = hash_name(name);
+	const char *result = NULL;
+	wlock(&name_index_lock);
+	OBJECTNAMESLOT *slot = name_index ? object_name_slot(name_index,name,h) : NULL;
+	if ( slot != NULL && slot->obj == obj )
 	{
-		output_fatal("object_tree_add(OBJECT *obj=<%s:%d>, OBJECTNAME name='%s'): memory allocation failed", obj->oclass->name, obj->id, name);
-		return NULL;
+		result = slot->name;
 	}
-	item->obj = obj;
-	HASH h = hash(name);
-	item->next = top[h];
-	if ( global_debug_output )
+	else if ( slot != NULL && slot->obj == NULL )
 	{
-		if ( top[h] == NULL )
-		{
-			IN_MYCONTEXT output_debug("object_tree_add(OBJECT *obj=<%s:%d>, OBJECTNAME name='%s'): added to hash %d", obj->oclass->name, obj->id, name, h);
-		}
-		else
+		/* reuse the slot of a removed name */
+		__atomic_store_n(&slot->obj,obj,__ATOMIC_RELEASE);
+		result = slot->name;
+	}
+	else if ( slot == NULL )
+	{
+		if ( ! object_name_grow(1) || (result=object_name_copy(name)) == NULL )
 		{
-			IN_MYCONTEXT output_debug("object_tree_add(OBJECT *obj=<%s:%d>, OBJECTNAME name='%s'): added to hash %d after '%s'", obj->oclass->name, obj->id, name, h, top[h]->name);
+			wunlock(&name_index_lock);
+			throw_exception("object_name_add(OBJECT *obj=<%s:%d>, OBJECTNAME name='%s'): memory allocation failed", obj->oclass->name, obj->id, name);
+			/* TROUBLESHOOT
+				The system has run out of memory while adding an object name to the name index.
+				Try freeing up system memory and try again.
+			 */
 		}
+		object_name_store(name_index,h,result,obj);
 	}
-	top[h] = item;
-	return item;
+	wunlock(&name_index_lock);
+	return result;
 }
 
-/*	Finds a name in the tree
+/*	Removes a name from the index.
+	WARNING: removing a name does NOT free() its object!
  */
-static OBJECTTREE *findin_tree(OBJECTNAME name)
+static void object_name_delete(OBJECT *obj, OBJECTNAME name)
 {
-	HASH h = hash(name);
-	OBJECTTREE *item = hash_find(h,name);
-	if ( global_debug_output )
+	wlock(&name_index_lock);
+	OBJECTNAMESLOT *slot = name_index ? object_name_slot(name_index,name,hash_name(name)) : NULL;
+	if ( slot != NULL && slot->obj == obj )
 	{
-		IN_MYCONTEXT output_debug("findin_tree(OBJECTNAME name='%s'): item=%p", name, item);
+		__atomic_store_n(&slot->obj,(OBJECT*)NULL,__ATOMIC_RELEASE);
 	}
-	return item;
+	wunlock(&name_index_lock);
 }
 
-/*	Deletes a name from the tree
-	WARNING: removing a tree entry does NOT free() its object!
- */
-void object_tree_delete(OBJECT *obj, OBJECTNAME name)
+/* clear the name index and free the tables and names (only when no objects remain) */
+static void object_name_free(void)
 {
-	HASH h = hash(name);
-	OBJECTTREE *item, *last = NULL;
-	for ( item = top[h] ; item != NULL ; item = item->next )
+	wlock(&name_index_lock);
+	while ( name_index != NULL )
 	{
-		if ( strcmp(item->name, name) == 0 )
-		{
-			if ( last != NULL )
-				last->next = item->next;
-			else
-				top[h] = item->next;
-			free((void*)item->name);
-			free(item);
-		}
-		else
-			last = item;
+		OBJECTNAMEINDEX *index = name_index;
+		name_index = index->retired;
+		free(index->slot);
+		free(index);
 	}
+	while ( name_pool != NULL )
+	{
+		OBJECTNAMEPOOL *block = name_pool;
+		name_pool = block->next;
+		free(block);
+	}
+	wunlock(&name_index_lock);
 }
 
 /** Find an object from a name.  This only works for named objects.  See object_set_name().
@@ -3014,17 +3574,57 @@ OBJECT *object_find_name(OBJECTNAME name)
 	}
 	else 
 	{
-		OBJECTTREE *item = findin_tree(name);
-		if ( item == NULL )
+		OBJECTNAMEINDEX *index = __atomic_load_n(&name_index,__ATOMIC_ACQUIRE);
+		OBJECTNAMESLOT *slot = index ? object_name_slot(index,name,hash_name(name)) : NULL;
+		return slot ? __atomic_load_n(&slot->obj,__ATOMIC_ACQUIRE) : NULL;
+	}
+}
+
+/** Find the objects whose names match a pattern.
+
+	The pattern is a regular expression as accepted by match().  A pattern
+	that starts with '^' followed only by literal characters is matched as
+	a prefix without running the regular expression.  The objects are listed
+	in no particular order.
+
+	@return the number of matching objects, which may exceed \p max
+ **/
+size_t object_find_names(const char *pattern, /**< regular expression to match */
+						 OBJECT **list, /**< list to fill (may be NULL) */
+						 size_t max) /**< size of the list */
+{
+	const char *prefix = NULL;
+	size_t len = 0;
+	if ( pattern[0] == '^' && strpbrk(pattern+1,".*$^\\") == NULL )
+	{
+		prefix = pattern+1;
+		len = strlen(prefix);
+	}
+	GldRegex re(pattern);
+	size_t count = 0;
+	OBJECTNAMEINDEX *index = __atomic_load_n(&name_index,__ATOMIC_ACQUIRE);
+	for ( size_t n = 0 ; index != NULL && n < index->size ; n++ )
+	{
+		OBJECTNAMESLOT *slot = index->slot+n;
+		if ( __atomic_load_n(&slot->hash,__ATOMIC_ACQUIRE) == 0 )
 		{
-			IN_MYCONTEXT output_debug("object_find_name(name='%s') name '%s' not found in tree", name, name);
-			return NULL;
+			continue;
 		}
-		else
+		OBJECT *obj = __atomic_load_n(&slot->obj,__ATOMIC_ACQUIRE);
+		if ( obj == NULL )
 		{
-			return item->obj;
+			continue;
+		}
+		if ( prefix ? strncmp(slot->name,prefix,len) == 0 : re.match(slot->name) )
+		{
+			if ( list != NULL && count < max )
+			{
+				list[count] = obj;
+			}
+			count++;
 		}
 	}
+	return count;
 }
 
 int object_build_name(OBJECT *obj, char *buffer, int len){
@@ -3063,8 +3663,10 @@ int object_build_name(OBJECT *obj, char *buffer, int len){
  **/
 OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name)
 {
-	OBJECTTREE *item = NULL;
-
+	if ( name == NULL )
+	{
+		return NULL;
+	}
 	if ( (isalpha(name[0]) != 0) || (name[0] == '_') )
 	{
 		; // good
@@ -3081,48 +3683,41 @@ OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name)
 			output_warning("object name '%s' does not follow strict naming rules and may not link correctly during load time", name);
 		}
 	}
-	if ( obj->name != NULL ) 
-	{
-		object_tree_delete(obj,name);
-	}
-	
-	if ( name != NULL )
+
+	/* names that look like class:id refer to that object */
+	char oclass[64];
+	unsigned int id;
+	if ( sscanf(name,"%63[^:]:%u",oclass,&id) == 2 )
 	{
 		OBJECT *found = object_find_name(name);
-		if ( found != NULL )
+		if ( found != NULL && ( found != obj || found->name != NULL ) ) // setting the name to the default is ok
 		{
-			IN_MYCONTEXT output_debug("found object %s:%d when searching for name=%s", found->oclass->name, found->id, name);
-			if ( found == obj && found->name == NULL )
-			{
-				// likely attempt to set name to default -- this is ok
-				;
-			}
-			else
-			{
-				output_error("An object named '%s' already exists!", name);
-				/*	TROUBLESHOOT
-					GridLab-D prohibits two objects from using the same name, to prevent
-					ambiguous object look-ups.
-				*/
-				return NULL;
-			}
-		}
-		IN_MYCONTEXT output_debug("adding object %s:%d as name %s", obj->oclass->name, obj->id, name);
-		item = object_tree_add(obj,name);
-		if ( item != NULL )
-		{
-			obj->name = item->name;
+			output_error("An object named '%s' already exists!", name);
+			return NULL;
 		}
 	}
-	
-	if ( item != NULL )
-	{
-		return item->name;
-	} 
-	else 
+
+	const char *result = object_name_add(obj,name);
+	if ( result == NULL )
 	{
+		output_error("An object named '%s' already exists!", name);
+		/*	TROUBLESHOOT
+			GridLab-D prohibits two objects from using the same name, to prevent
+			ambiguous object look-ups.
+		*/
 		return NULL;
 	}
+	if ( obj->name != NULL && obj->name != result )
+	{
+		object_name_delete(obj,obj->name);
+	}
+	if ( obj->name != result )
+	{
+		IN_MYCONTEXT output_debug("adding object %s:%d as name %s", obj->oclass->name, obj->id, name);
+		obj->name = result;
+		object_update_generation();
+	}
+	return result;
 }
 
 /** Convenience method use by the testing framework.  
@@ -3135,9 +3730,11 @@ void remove_objects(){
 	while(obj1 != NULL){
 		first_object = obj1->next;
 		obj1->oclass->profiler.numobjs--;
-		free(obj1);
+		object_free(obj1);
 		obj1 = first_object;
 	}
+	object_arena_free();
+	object_name_free();
 
 	next_object_id = 0;
 }
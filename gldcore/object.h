@@ -45,7 +45,8 @@ typedef char FULLNAME[1024]; /** Full object name (including space name) */
 #define OF_FORECAST		0x00000040	/**< Object flag; inidcates that the object has a valid forecast available */
 #define OF_DEFERRED		0x00000080	/**< Object flag; indicates that the object started to be initialized, but requested deferral */
 #define OF_INIT			0x00000100	/**< Object flag; indicates that the object has been successfully initialized */
-#define OF_RERANK		0x00004000	/**< Internal use only */
+#define OF_RERANK		0x00004000	/**< Object flag; rank was set explicitly (internal use only) */
+#define OF_UNSAVED		(OF_RERANK)	/**< Object flags that are used by the scheduler and never saved or output */
 #define OF_QUIET		0x00010000  /**< Object flag; disables error messages from the object */
 #define OF_WARNING		0x00020000  /**< Object flag; disables warning messages from the object */
 #define OF_DEBUG		0x00040000  /**< Object flag; disables debug messages from the object */
@@ -96,33 +97,46 @@ typedef enum {
 	_OPI_NUMITEMS,
 } OBJECTPROFILEITEM;
 
+/* Typedef: OBJECTCOLD
+	Rarely used object header data
+
+	Objects share a default record, which must never be changed, until one
+	of these fields is set on the object (see <object_get_cold>).
+ */
+typedef struct s_object_cold {
+	char32 groupid; /**< object group id */
+	EVENTHANDLERS events; /**< object event handlers */
+	clock_t synctime[_OPI_NUMITEMS]; /**< total time used by this object */
+	char *init_after; /**< names of the objects that must be initialized first (see <IS_DEPENDENCY>) */
+} OBJECTCOLD;
+
+/* the fields used by every pass come first so they share a cache line */
 typedef struct s_object_list {
 	OBJECTNUM id; /**< object id number; globally unique */
+	OBJECTRANK rank; /**< object's rank */
 	CLASS *oclass; /**< object class; determine structure of object data */
-	OBJECTNAME name;
-	char32 groupid;
 	struct s_object_list *next; /**< next object in list */
 	struct s_object_list *parent; /**< object's parent; determines rank */
-	unsigned int child_count; /**< number of object that have this object as a parent */
-	OBJECTRANK rank; /**< object's rank */
 	TIMESTAMP clock; /**< object's private clock */
 	TIMESTAMP valid_to;	/**< object's valid-until time */
-	TIMESTAMP schedule_skew; /**< time skew applied to schedule operations involving this object */
-	FORECAST *forecast; /**< forecast data block */
-	double latitude, longitude; /**< object's geo-coordinates */
 	TIMESTAMP in_svc, /**< time at which object begin's operating */
 		out_svc; /**< time at which object ceases operating */
-	unsigned int in_svc_micro,	/**< Microsecond portion of in_svc */
-		out_svc_micro;	/**< Microsecond portion of out_svc */
-	double in_svc_double;	/**< Double value representation of in service time */
-	double out_svc_double;	/**< Double value representation of out of service time */
-	clock_t synctime[_OPI_NUMITEMS]; /**< total time used by this object */
-	NAMESPACE *space; /**< namespace of object */
 	LOCKVAR lock; /**< object lock */
 	unsigned int rng_state; /**< random number generator state */
 	TIMESTAMP heartbeat; /**< heartbeat call interval (in sim-seconds) */
+	TIMESTAMP schedule_skew; /**< time skew applied to schedule operations involving this object */
+	double delta_substep; /**< preferred deltamode update interval in seconds (0 to update every timestep) */
+	double in_svc_double;	/**< Double value representation of in service time */
+	double out_svc_double;	/**< Double value representation of out of service time */
+	unsigned int in_svc_micro,	/**< Microsecond portion of in_svc */
+		out_svc_micro;	/**< Microsecond portion of out_svc */
+	unsigned int child_count; /**< number of object that have this object as a parent */
+	OBJECTNAME name;
+	NAMESPACE *space; /**< namespace of object */
+	FORECAST *forecast; /**< forecast data block */
+	double latitude, longitude; /**< object's geo-coordinates */
 	unsigned long long guid[2]; /**< globally unique identifier */
-	EVENTHANDLERS events;
+	OBJECTCOLD *cold; /**< rarely used header data (see <OBJECTCOLD>) */
 	/* IMPORTANT: flags must be last */
 	unsigned long long flags; /**< object flags */
 } OBJECT; /**< Object header structure */
@@ -367,6 +381,11 @@ typedef struct s_callbacks {
 		PyObject *(*import)(const char *module, const char *path);
 		bool (*call)(PyObject *pModule, const char *method, const char *vargsfmt, va_list varargs);
 	} python;
+	struct {
+		struct s_property_column *(*create)(CLASS *oclass, PROPERTY *prop);
+		struct s_property_column *(*find)(CLASS *oclass, PROPERTY *prop);
+		bool (*refresh)(struct s_property_column *column);
+	} column;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -376,7 +395,10 @@ extern "C" {
 
 OBJECT *object_create_single(CLASS *oclass);
 OBJECT *object_create_array(CLASS *oclass, unsigned int n_objects);
+STATUS object_reserve(CLASS *oclass, unsigned int n_objects);
+int object_arena_test(void);
 OBJECT *object_create_foreign(OBJECT *obj);
+OBJECTCOLD *object_get_cold(OBJECT *obj);
 OBJECT *object_remove_by_id(OBJECTNUM id);
 int object_init(OBJECT *obj);
 STATUS object_precommit(OBJECT *obj, TIMESTAMP t1);
@@ -404,6 +426,8 @@ OBJECT *object_get_reference(OBJECT *obj, const char *name);
 int object_isa(OBJECT *obj, const char *type);
 OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name);
 OBJECT *object_find_name(OBJECTNAME name);
+size_t object_find_names(const char *pattern, OBJECT **list, size_t max);
+STATUS object_name_reserve(size_t n);
 int object_build_name(OBJECT *obj, char *buffer, int len);
 int object_locate_property(void *addr, OBJECT **pObj, PROPERTY **pProp);
 int object_property_getsize(OBJECT *obj, PROPERTY *prop);
@@ -443,6 +467,8 @@ OBJECT *object_get_first(void);
 OBJECT *object_get_next(OBJECT *obj);
 OBJECT *object_get_last(void);
 unsigned int object_get_count(void);
+unsigned long long object_get_generation(void);
+void object_update_generation(void);
 size_t object_dump(char *buffer, size_t size, OBJECT *obj);
 size_t object_save(char *buffer, size_t size, OBJECT *obj);
 int object_saveall(FILE *fp);
@@ -505,6 +531,8 @@ const char *object_property_to_initial(OBJECT *obj, const char *name, char *buff
 #endif
 
 const char* object_get_header_string(OBJECT *obj, const char *item, char *buffer, size_t len);
+STATUS object_set_delta_substep(OBJECT *obj, const char *value);
+STATUS object_set_init_after(OBJECT *obj, const char *value);
 
 #define object_size(X) ((X)?(X)->size:-1) /**< get the size of the object X */
 #define object_id(X) ((X)?(X)->id:-1) /**< get the id of the object X */
@@ -533,6 +533,9 @@ typedef enum e_passconfig
 	PC_ABSTRACTONLY 		= 0x0100,
 	PC_AUTOLOCK 			= 0x0200,
 	PC_OBSERVER 			= 0x0400,
+	PC_LAZYSYNC 			= 0x0800,
+	PC_PARALLELUPDATE 		= 0x1000,
+	PC_PARALLELINIT 		= 0x2000,
 } PASSCONFIG;
 
 #ifndef FALSE
@@ -722,6 +725,7 @@ struct s_class_list {
 	char runtime[1024]; ///< name of file containing runtime dll, so, or dylib
 	struct s_eventhandlers events;
 	CLASS *next;
+	void *pindex; ///< property lookup index (core use only)
 };
 
 typedef char FULLNAME[1024]; /** Full object name (including space name) */
@@ -754,33 +758,39 @@ typedef enum {
 	_OPI_NUMITEMS,
 } OBJECTPROFILEITEM;
 
+typedef struct s_object_cold {
+	char32 groupid; /**< object group id */
+	EVENTHANDLERS events; /**< object event handlers */
+	clock_t synctime[_OPI_NUMITEMS]; /**< total time used by this object */
+	char *init_after; /**< names of the objects that must be initialized first (see <IS_DEPENDENCY>) */
+} OBJECTCOLD; /**< Rarely used object header data */
+
 struct s_object_list {
 	OBJECTNUM id; /**< object id number; globally unique */
+	OBJECTRANK rank; /**< object's rank */
 	CLASS *oclass; /**< object class; determine structure of object data */
-	OBJECTNAME name;
-	char32 groupid;
 	OBJECT *next; /**< next object in list */
 	OBJECT *parent; /**< object's parent; determines rank */
-	unsigned int child_count; /**< number of object that have this object as a parent */
-	OBJECTRANK rank; /**< object's rank */
 	TIMESTAMP clock; /**< object's private clock */
 	TIMESTAMP valid_to;	/**< object's valid-until time */
-	TIMESTAMP schedule_skew; /**< time skew applied to schedule operations involving this object */
-	FORECAST *forecast; /**< forecast data block */
-	double latitude, longitude; /**< object's geo-coordinates */
 	TIMESTAMP in_svc, /**< time at which object begin's operating */
 		out_svc; /**< time at which object ceases operating */
-	unsigned int in_svc_micro,	/**< Microsecond portion of in_svc */
-		out_svc_micro;	/**< Microsecond portion of out_svc */
-	double in_svc_double;	/**< Double value representation of in service time */
-	double out_svc_double;	/**< Double value representation of out of service time */
-	clock_t synctime[_OPI_NUMITEMS]; /**< total time used by this object */
-	NAMESPACE *space; /**< namespace of object */
 	LOCKVAR lock; /**< object lock */
 	unsigned int rng_state; /**< random number generator state */
 	TIMESTAMP heartbeat; /**< heartbeat call interval (in sim-seconds) */
+	TIMESTAMP schedule_skew; /**< time skew applied to schedule operations involving this object */
+	double delta_substep; /**< preferred deltamode update interval in seconds (0 to update every timestep) */
+	double in_svc_double;	/**< Double value representation of in service time */
+	double out_svc_double;	/**< Double value representation of out of service time */
+	unsigned int in_svc_micro,	/**< Microsecond portion of in_svc */
+		out_svc_micro;	/**< Microsecond portion of out_svc */
+	unsigned int child_count; /**< number of object that have this object as a parent */
+	OBJECTNAME name;
+	NAMESPACE *space; /**< namespace of object */
+	FORECAST *forecast; /**< forecast data block */
+	double latitude, longitude; /**< object's geo-coordinates */
 	unsigned long long guid[2]; /**< globally unique identifier */
-	EVENTHANDLERS events;
+	OBJECTCOLD *cold; /**< rarely used header data */
 	/* IMPORTANT: flags must be last */
 	unsigned long long flags; /**< object flags */
 }; /**< Object header structure */
@@ -808,19 +818,41 @@ typedef struct s_datetime { ///< The s_datetime structure
 	int tzoffset; /**< time zone offset in seconds (-43200 - 43200) */
 } DATETIME; ///< A typedef for struct s_datetime
 
-struct s_schedule {
-	char name[64];						/**< the name of the schedule */
-	char definition[65536];				/**< the definition string of the schedule */
+typedef struct s_schedulecalendar {
+	uint32 runs;						/**< the number of runs */
+	uint32 *start;						/**< the first minute of each run */
+	uint32 *change;						/**< the minute of the next value change after each run */
+	unsigned char *index;				/**< the value index of each run */
+	uint32 day[367];					/**< the run in effect at the start of each day (day[366] is the last run) */
+	bool shared;						/**< the runs belong to an earlier identical calendar */
+} SCHEDULECALENDAR;
+
+typedef struct s_schedulebody SCHEDULEBODY;
+struct s_schedulebody {
+	unsigned int refcount;				/**< the number of schedules using the body */
+	unsigned long long hash;			/**< the hash of the normalized definition and the compiler version */
+	char *key;							/**< the normalized definition */
 	char blockname[MAXBLOCKS][64];		/**< the name of each block */
 	unsigned char block;				/**< the last block used (4 max) */
-	unsigned char index[14][366*24*60];	/**< the schedule index (enough room for all 14 annual calendars to 1 minute resolution) */
-	uint32 dtnext[14][366*24*60];/**< the time until the next schedule change (in minutes) */
+	unsigned char (*index)[366*24*60];	/**< the schedule index of all 14 annual calendars to 1 minute resolution (only while compiling) */
+	SCHEDULECALENDAR calendar[14];		/**< the compiled annual calendars */
+	bool invariant;						/**< the schedule value never changes */
 	double data[MAXBLOCKS*MAXVALUES];	/**< the list of values used in each block */
 	unsigned int weight[MAXBLOCKS*MAXVALUES];	/**< the weight (in minutes) associate with each value */
 	double sum[MAXBLOCKS];				/**< the sum of values for each block -- used to normalize */
 	double abs[MAXBLOCKS];				/**< the sum of the absolute values for each block -- used to normalize */
 	unsigned int count[MAXBLOCKS];		/**< the number of values given in each block */
 	unsigned int minutes[MAXBLOCKS];	/**< the total number of minutes associate with each block */
+	int flags;							/**< the compiled schedule flags (see SN_*) */
+	void *map;							/**< the cache file the calendars are mapped from (NULL if compiled) */
+	size_t mapsize;						/**< the size of the mapped cache file */
+	SCHEDULEBODY *next;					/**< next body with the same hash bucket */
+};
+
+struct s_schedule {
+	char name[64];						/**< the name of the schedule */
+	char *definition;					/**< the definition string of the schedule */
+	SCHEDULEBODY *body;					/**< the compiled schedule (may be shared) */
 	TIMESTAMP next_t;					/**< the time of the next schedule event */
 	double value;						/**< the current scheduled value */
 	double duration;					/**< the duration of the current scheduled value */
@@ -1414,6 +1446,11 @@ typedef struct s_callbacks {
 		PyObject *(*import)(const char *module, const char *path);
 		bool (*call)(PyObject *pModule, const char *method);
 	} python;
+	struct {
+		struct s_property_column *(*create)(CLASS *oclass, PROPERTY *prop);
+		struct s_property_column *(*find)(CLASS *oclass, PROPERTY *prop);
+		bool (*refresh)(struct s_property_column *column);
+	} column;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -7,9 +7,15 @@
 **/
 
 #include "gldcore.h"
+#include <fcntl.h>
+#include <sys/mman.h>
 
 SET_MYCONTEXT(DMC_SCHEDULE)
 
+/* change this when the compiler or the compiled form of schedules changes so
+   that bodies saved in the schedule cache by older versions are not used */
+#define SCHEDULE_COMPILER_VERSION 1
+
 static SCHEDULE *schedule_list = NULL;
 static uint32 n_schedules = 0;
 static int interpolated_schedules = FALSE;
@@ -155,9 +161,9 @@ int find_value_index (SCHEDULE *sch, /// schedule to search
 					  double value) /// value to find
 {
 	int ndx;
-	for (ndx=0; ndx<(int)(sch->count[block]); ndx++)
+	for (ndx=0; ndx<(int)(sch->body->count[block]); ndx++)
 	{
-		if ((float)(sch->data[block*MAXVALUES+ndx]) == (float)value)
+		if ((float)(sch->body->data[block*MAXVALUES+ndx]) == (float)value)
 			return ndx;
 	}
 	return -1;
@@ -179,7 +185,7 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 	unsigned int minute=0;
 
 	/* check block count */
-	if (sch->block>=MAXBLOCKS)
+	if (sch->body->block>=MAXBLOCKS)
 	{
 		output_error("schedule_compile(SCHEDULE *sch='{name=%s, ...}') maximum number of blocks reached", sch->name);
 		/* TROUBLESHOOT
@@ -190,7 +196,7 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 	}
 
 	/* first index is always default value 0 */
-	sch->count[sch->block]=1;
+	sch->body->count[sch->body->block]=1;
 	char *last = NULL;
 	while ( (token=strtok_r(token==NULL?blockcopy:NULL,";\r\n",&last))!=NULL )
 	{
@@ -216,20 +222,20 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 		if (strcmp(token,"")==0)
 			continue;
 		if ( strcmp(token,"nonzero")==0 )
-			sch->flags |= SN_NONZERO;
+			sch->body->flags |= SN_NONZERO;
 		else if ( strcmp(token,"positive")==0 )
-			sch->flags |= SN_POSITIVE;
+			sch->body->flags |= SN_POSITIVE;
 		else if ( strcmp(token,"boolean")==0 )
-			sch->flags |= SN_BOOLEAN;
+			sch->body->flags |= SN_BOOLEAN;
 		else if ( strcmp(token,"normal")==0 )
-			sch->flags |= SN_NORMAL;
+			sch->body->flags |= SN_NORMAL;
 		else if ( strcmp(token,"weighted")==0 )
-			sch->flags |= SN_NORMAL|SN_WEIGHTED;
+			sch->body->flags |= SN_NORMAL|SN_WEIGHTED;
 		else if ( strcmp(token,"absolute")==0 )
-			sch->flags |= SN_NORMAL|SN_ABSOLUTE;
+			sch->body->flags |= SN_NORMAL|SN_ABSOLUTE;
 		else if ( strcmp(token,"interpolated")==0 )
 		{
-			sch->flags |= SN_INTERPOLATED;
+			sch->body->flags |= SN_INTERPOLATED;
 			interpolated_schedules = TRUE;
 		}
 		else if (sscanf(token,"%255s%*[ \t]%255s%*[ \t]%255s%*[ \t]%255s%*[ \t]%255s%*[ \t]%lf",matcher[0].pattern,matcher[1].pattern,matcher[2].pattern,matcher[3].pattern,matcher[4].pattern,&value)<5) /* value can be missing -> defaults to 1.0 */
@@ -242,20 +248,20 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 		}
 		else
 		{
-			if ((ndx=find_value_index(sch,sch->block,value))==-1)
+			if ((ndx=find_value_index(sch,sch->body->block,value))==-1)
 			{	
-				ndx = sch->count[sch->block]++;
+				ndx = sch->body->count[sch->body->block]++;
 				// bound checking
 				if(ndx > MAXVALUES-1)
 				{
-					output_error("schedule_compile(SCHEDULE *sch='{name=%s, ...}') maximum number of values reached in block %i", sch->name, sch->block);
+					output_error("schedule_compile(SCHEDULE *sch='{name=%s, ...}') maximum number of values reached in block %i", sch->name, sch->body->block);
 					free(blockcopy);
 					return 0;
 				}
-				sch->data[sch->block*MAXVALUES+ndx] = value;
+				sch->body->data[sch->body->block*MAXVALUES+ndx] = value;
 			}
-			sch->sum[sch->block] += value;
-			sch->abs[sch->block] += (value<0?-value:value); // check to see if the value already exists in the value array, if so, don't ++index and use existing indexed value
+			sch->body->sum[sch->body->block] += value;
+			sch->body->abs[sch->body->block] += (value<0?-value:value); // check to see if the value already exists in the value array, if so, don't ++index and use existing indexed value
 		}
 
 		/* compile matching tables */
@@ -281,7 +287,7 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 			unsigned int calendar = weekday*2+is_leapyear;
 			unsigned int month;
 			unsigned int days[] = {31,(unsigned int)(is_leapyear?29:28),31,30,31,30,31,31,30,31,30,31};
-			unsigned int n = sch->block*MAXVALUES + ndx;
+			unsigned int n = sch->body->block*MAXVALUES + ndx;
 			minute = 0;
 			for (month=0; month<12; month++)
 			{
@@ -313,10 +319,10 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 						{
 							if (matcher[0].table[minute%60])
 							{
-								if (sch->index[calendar][minute]>0)
+								if (sch->body->index[calendar][minute]>0)
 								{
 									const char *dayofweek[] = {"Sun","Mon","Tue","Wed","Thu","Fri","Sat","Sun","Hol"};
-									output_error("schedule_compile(SCHEDULE *sch={name='%s', ...}) '%s' in block '%s' has a conflict with value %g on %s %d/%d %02d:%02d", sch->name, token, blockname, sch->data[sch->index[calendar][minute]], dayofweek[weekday], month+1, day+1, hour, minute%60);
+									output_error("schedule_compile(SCHEDULE *sch={name='%s', ...}) '%s' in block '%s' has a conflict with value %g on %s %d/%d %02d:%02d", sch->name, token, blockname, sch->body->data[sch->body->index[calendar][minute]], dayofweek[weekday], month+1, day+1, hour, minute%60);
 									/* TROUBLESHOOT
 									   The schedule definition is not valid and has been ignored.  Check the syntax of your schedule and try again.
 									 */
@@ -326,9 +332,9 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 								else
 								{
 									/* associate this time with the current value */
-									sch->index[calendar][minute] = n;
-									sch->weight[n]++;
-									sch->minutes[sch->block]++;
+									sch->body->index[calendar][minute] = n;
+									sch->body->weight[n]++;
+									sch->body->minutes[sch->body->block]++;
 
 								}
 							}
@@ -339,7 +345,7 @@ int schedule_compile_block(SCHEDULE *sch, const char *blockname, const char *blo
 			}
 		}
 	}
-	strcpy(sch->blockname[sch->block],blockname);
+	strcpy(sch->body->blockname[sch->body->block],blockname);
 	free(blockcopy);
 	return 1;
 }
@@ -364,7 +370,7 @@ int schedule_compile(SCHEDULE *sch)
 		strcpy(blockdef,p);
 		if (schedule_compile_block(sch,"*",blockdef))
 		{
-			sch->block++;
+			sch->body->block++;
 			return 1;
 		}
 		else
@@ -394,7 +400,7 @@ int schedule_compile(SCHEDULE *sch)
 		case CLOSE:
 			if (!isspace(*p) && !iscntrl(*p)) 
 			{
-				if (sch->block>=MAXBLOCKS)
+				if (sch->body->block>=MAXBLOCKS)
 				{
 					output_error("maximum number of allowed schedule blocks exceeded");
 					/* TROUBLESHOOT
@@ -440,20 +446,20 @@ int schedule_compile(SCHEDULE *sch)
 			if (*p==';') /* option */
 			{
 				if (strcmp(blockname,"weighted")==0)
-					sch->flags |= SN_WEIGHTED;
+					sch->body->flags |= SN_WEIGHTED;
 				else if (strcmp(blockname,"absolute")==0)
-					sch->flags |= SN_ABSOLUTE;
+					sch->body->flags |= SN_ABSOLUTE;
 				else if (strcmp(blockname,"normal")==0)
-					sch->flags |= SN_NORMAL;
+					sch->body->flags |= SN_NORMAL;
 				else if (strcmp(blockname,"positive")==0)
-					sch->flags |= SN_POSITIVE;
+					sch->body->flags |= SN_POSITIVE;
 				else if (strcmp(blockname,"nonzero")==0)
-					sch->flags |= SN_NONZERO;
+					sch->body->flags |= SN_NONZERO;
 				else if (strcmp(blockname,"boolean")==0)
-					sch->flags |= SN_BOOLEAN;
+					sch->body->flags |= SN_BOOLEAN;
 				else if (strcmp(blockname,"interpolated")==0)
 				{
-					sch->flags |= SN_INTERPOLATED;
+					sch->body->flags |= SN_INTERPOLATED;
 					interpolated_schedules = TRUE;
 				}
 				else
@@ -485,7 +491,7 @@ int schedule_compile(SCHEDULE *sch)
 				q = NULL;
 				p++;
 				if (schedule_compile_block(sch,blockname,blockdef))
-					sch->block++;
+					sch->body->block++;
 				else
 					return 0;
 			}
@@ -513,6 +519,489 @@ int schedule_compile(SCHEDULE *sch)
 	return 1;
 }
 
+/* compresses the compiled schedule index into runs for each calendar
+   returns 1 on success, 0 on failure
+ */
+static int schedule_compress(SCHEDULE *sch)
+{
+	unsigned int calendar;
+	sch->body->invariant = true;
+	for ( calendar = 0 ; calendar < 14 ; calendar++ )
+	{
+		SCHEDULECALENDAR *cal = &(sch->body->calendar[calendar]);
+		unsigned char *index = sch->body->index[calendar];
+		uint32 t, n, runs = 1;
+		unsigned int other;
+
+		/* count the runs */
+		for ( t = 1 ; t < MINUTES_PER_CALENDAR ; t++ )
+		{
+			if ( index[t] != index[t-1] )
+				runs++;
+		}
+
+		/* allocate the runs */
+		void *data = malloc(runs*(2*sizeof(uint32)+sizeof(unsigned char)));
+		if ( data == NULL )
+		{
+			output_error("schedule_compress(SCHEDULE *sch={name='%s', ...}) memory allocation failed", sch->name);
+			/* TROUBLESHOOT
+			   The schedule compiler could not allocate enough memory to store the schedule.  Try freeing system memory and try again.
+			 */
+			return 0;
+		}
+		cal->runs = runs;
+		cal->start = (uint32*)data;
+		cal->change = cal->start + runs;
+		cal->index = (unsigned char*)(cal->change + runs);
+		cal->shared = false;
+
+		/* fill the runs and the run in effect at the start of each day */
+		for ( t = 0, n = 0 ; t < MINUTES_PER_CALENDAR ; t++ )
+		{
+			if ( t == 0 || index[t] != index[t-1] )
+			{
+				cal->start[n] = t;
+				cal->index[n] = index[t];
+				n++;
+			}
+			if ( t%(24*60) == 0 )
+				cal->day[t/(24*60)] = n-1;
+		}
+		cal->day[366] = runs-1;
+
+		/* find the next value change of each run (the end of the calendar counts as a change) */
+		cal->change[runs-1] = MINUTES_PER_CALENDAR;
+		for ( n = runs-1 ; n > 0 ; n-- )
+		{
+			if ( sch->body->data[cal->index[n-1]] == sch->body->data[cal->index[n]] )
+			{
+				cal->change[n-1] = cal->change[n];
+			}
+			else
+			{
+				cal->change[n-1] = cal->start[n];
+				sch->body->invariant = false;
+			}
+		}
+
+		/* share the runs of an identical calendar */
+		for ( other = 0 ; other < calendar ; other++ )
+		{
+			SCHEDULECALENDAR *prev = &(sch->body->calendar[other]);
+			if ( ! prev->shared && prev->runs == runs 
+				&& memcmp(prev->start,cal->start,runs*sizeof(uint32)) == 0
+				&& memcmp(prev->index,cal->index,runs*sizeof(unsigned char)) == 0 )
+			{
+				free(data);
+				*cal = *prev;
+				cal->shared = true;
+				break;
+			}
+		}
+	}
+	return 1;
+}
+
+/* the compiled bodies indexed by the hash of their normalized definition */
+#define SCHEDULE_BODIES 1024
+static SCHEDULEBODY *body_table[SCHEDULE_BODIES];
+static pthread_mutex_t body_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* removes the whitespace that does not change the meaning of a definition,
+   i.e., blanks at the start and end of lines, repeated blanks, and empty lines
+   returns a new string, or NULL if memory allocation failed
+ */
+static char *schedule_key(const char *definition)
+{
+	char *key = (char*)malloc(strlen(definition)+1);
+	if ( key == NULL )
+		return NULL;
+	char *q = key;
+	bool blank = false;
+	for ( const char *p = definition ; *p != '\0' ; p++ )
+	{
+		if ( *p == ' ' || *p == '\t' )
+		{
+			blank = true;
+		}
+		else if ( *p == '\n' || *p == '\r' )
+		{
+			if ( q > key && q[-1] != '\n' )
+				*q++ = '\n';
+			blank = false;
+		}
+		else
+		{
+			if ( blank && q > key && q[-1] != '\n' )
+				*q++ = ' ';
+			*q++ = *p;
+			blank = false;
+		}
+	}
+	if ( q > key && q[-1] == '\n' )
+		q--;
+	*q = '\0';
+	return key;
+}
+
+/* hashes a normalized definition and the compiler version */
+static unsigned long long schedule_hash(const char *key)
+{
+	return hash_string(key,(HASH_FNV1A_OFFSET^SCHEDULE_COMPILER_VERSION)*HASH_FNV1A_PRIME);
+}
+
+/* finds the body of an identical definition or creates a new empty body
+   created is set when the body is new and must be compiled or loaded
+   returns NULL if memory allocation failed
+ */
+static SCHEDULEBODY *schedule_body_get(const char *definition, bool *created)
+{
+	char *key = schedule_key(definition);
+	if ( key == NULL )
+		return NULL;
+	unsigned long long hash = schedule_hash(key);
+	SCHEDULEBODY **bucket = &body_table[hash%SCHEDULE_BODIES];
+	SCHEDULEBODY *body;
+	pthread_mutex_lock(&body_lock);
+	for ( body = *bucket ; body != NULL ; body = body->next )
+	{
+		if ( body->hash == hash && strcmp(body->key,key) == 0 )
+		{
+			body->refcount++;
+			pthread_mutex_unlock(&body_lock);
+			free(key);
+			*created = false;
+			return body;
+		}
+	}
+	body = (SCHEDULEBODY*)malloc(sizeof(SCHEDULEBODY));
+	if ( body != NULL )
+	{
+		memset(body,0,sizeof(SCHEDULEBODY));
+		body->refcount = 1;
+		body->hash = hash;
+		body->key = key;
+		body->next = *bucket;
+		*bucket = body;
+	}
+	else
+		free(key);
+	pthread_mutex_unlock(&body_lock);
+	*created = true;
+	return body;
+}
+
+/* releases a body and frees it when it is no longer used */
+static void schedule_body_release(SCHEDULEBODY *body)
+{
+	pthread_mutex_lock(&body_lock);
+	if ( --body->refcount > 0 )
+	{
+		pthread_mutex_unlock(&body_lock);
+		return;
+	}
+	SCHEDULEBODY **item = &body_table[body->hash%SCHEDULE_BODIES];
+	while ( *item != body )
+		item = &((*item)->next);
+	*item = body->next;
+	pthread_mutex_unlock(&body_lock);
+
+	if ( body->map != NULL )
+	{
+		munmap(body->map,body->mapsize);
+	}
+	else
+	{
+		unsigned int calendar;
+		for ( calendar = 0 ; calendar < 14 ; calendar++ )
+		{
+			if ( ! body->calendar[calendar].shared && body->calendar[calendar].start != NULL )
+				free(body->calendar[calendar].start);
+		}
+	}
+	if ( body->index != NULL )
+		free(body->index);
+	free(body->key);
+	free(body);
+}
+
+/* releases the memory used by a schedule */
+static void schedule_free(SCHEDULE *sch)
+{
+	if ( sch->body != NULL )
+		schedule_body_release(sch->body);
+	if ( sch->definition != NULL )
+		free(sch->definition);
+	free(sch);
+}
+
+/** Get the memory used by a compiled schedule, including its body (which may be shared)
+	@return the number of bytes used
+ **/
+size_t schedule_memory(SCHEDULE *sch) /**< the schedule */
+{
+	size_t size = sizeof(SCHEDULE) + strlen(sch->definition) + 1;
+	if ( sch->body == NULL )
+		return size;
+	size += sizeof(SCHEDULEBODY) + strlen(sch->body->key) + 1;
+	unsigned int calendar;
+	for ( calendar = 0 ; calendar < 14 ; calendar++ )
+	{
+		if ( ! sch->body->calendar[calendar].shared )
+			size += sch->body->calendar[calendar].runs*(2*sizeof(uint32)+sizeof(unsigned char));
+	}
+	return size;
+}
+
+/* the header of a schedule cache file, which is followed by the normalized
+   definition and the runs of each calendar that is not shared
+ */
+typedef struct s_schedulecache {
+	uint32 magic;						/* SCHEDULE_CACHE_MAGIC */
+	uint32 version;						/* SCHEDULE_COMPILER_VERSION */
+	uint32 header;						/* the size of this header */
+	uint32 keysize;						/* the size of the normalized definition (including the terminator) */
+	unsigned long long hash;			/* the hash of the normalized definition and the compiler version */
+	unsigned long long size;			/* the size of the file */
+	int flags;
+	unsigned int block;
+	unsigned int invariant;
+	char blockname[MAXBLOCKS][64];
+	double data[MAXBLOCKS*MAXVALUES];
+	unsigned int weight[MAXBLOCKS*MAXVALUES];
+	double sum[MAXBLOCKS];
+	double abs[MAXBLOCKS];
+	unsigned int count[MAXBLOCKS];
+	unsigned int minutes[MAXBLOCKS];
+	struct {
+		uint32 runs;
+		uint32 source;					/* the calendar whose runs are used */
+		unsigned long long offset;		/* the file offset of the runs (if source is this calendar) */
+		uint32 day[367];
+	} calendar[14];
+} SCHEDULECACHE;
+#define SCHEDULE_CACHE_MAGIC 0x47534348
+#define SCHEDULE_CACHE_ALIGN(X) (((X)+3)&~(size_t)3)
+
+/* gets the name of the cache file of a body
+   returns false if the name is too long
+ */
+static bool schedule_cache_path(SCHEDULEBODY *body, char *path, size_t len)
+{
+	return (size_t)snprintf(path,len,"%s/%016llx.sch",(const char*)global_schedule_cache,body->hash) < len;
+}
+
+/* maps a compiled body from the schedule cache
+   returns true if the body was loaded, false if it must be compiled
+ */
+static bool schedule_cache_load(SCHEDULEBODY *body)
+{
+	char path[1200];
+	if ( ! schedule_cache_path(body,path,sizeof(path)) )
+		return false;
+	int fd = open(path,O_RDONLY);
+	if ( fd < 0 )
+		return false;
+	struct stat info;
+	void *map = MAP_FAILED;
+	if ( fstat(fd,&info) == 0 && (size_t)info.st_size >= sizeof(SCHEDULECACHE) )
+		map = mmap(NULL,info.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+	close(fd);
+	if ( map == MAP_FAILED )
+	{
+		IN_MYCONTEXT output_debug("schedule cache file '%s' could not be mapped", path);
+		return false;
+	}
+
+	/* check the header and the definition */
+	const SCHEDULECACHE *cache = (const SCHEDULECACHE*)map;
+	size_t size = (size_t)info.st_size;
+	size_t keysize = strlen(body->key) + 1;
+	bool valid = cache->magic == SCHEDULE_CACHE_MAGIC
+		&& cache->version == SCHEDULE_COMPILER_VERSION
+		&& cache->header == sizeof(SCHEDULECACHE)
+		&& cache->hash == body->hash
+		&& cache->size == size
+		&& cache->keysize == keysize
+		&& sizeof(SCHEDULECACHE) + keysize <= size
+		&& memcmp(cache+1,body->key,keysize) == 0
+		&& cache->block <= MAXBLOCKS;
+
+	/* check the runs */
+	unsigned int calendar, day;
+	for ( calendar = 0 ; valid && calendar < 14 ; calendar++ )
+	{
+		uint32 runs = cache->calendar[calendar].runs;
+		uint32 source = cache->calendar[calendar].source;
+		unsigned long long offset = cache->calendar[calendar].offset;
+		if ( source == calendar )
+		{
+			valid = runs > 0 && offset%sizeof(uint32) == 0 && offset <= size
+				&& runs <= (size-offset)/(2*sizeof(uint32)+sizeof(unsigned char));
+		}
+		else
+		{
+			valid = source < calendar && cache->calendar[source].source == source
+				&& cache->calendar[source].runs == runs;
+		}
+		for ( day = 0 ; valid && day < 367 ; day++ )
+			valid = cache->calendar[calendar].day[day] < runs;
+	}
+	if ( ! valid )
+	{
+		IN_MYCONTEXT output_debug("schedule cache file '%s' does not match the definition or the compiler", path);
+		munmap(map,size);
+		return false;
+	}
+
+	/* the calendars use the runs in the mapped file */
+	body->flags = cache->flags;
+	body->block = (unsigned char)cache->block;
+	body->invariant = cache->invariant != 0;
+	memcpy(body->blockname,cache->blockname,sizeof(body->blockname));
+	memcpy(body->data,cache->data,sizeof(body->data));
+	memcpy(body->weight,cache->weight,sizeof(body->weight));
+	memcpy(body->sum,cache->sum,sizeof(body->sum));
+	memcpy(body->abs,cache->abs,sizeof(body->abs));
+	memcpy(body->count,cache->count,sizeof(body->count));
+	memcpy(body->minutes,cache->minutes,sizeof(body->minutes));
+	for ( calendar = 0 ; calendar < 14 ; calendar++ )
+	{
+		SCHEDULECALENDAR *cal = &(body->calendar[calendar]);
+		uint32 source = cache->calendar[calendar].source;
+		if ( source == calendar )
+		{
+			cal->runs = cache->calendar[calendar].runs;
+			cal->start = (uint32*)((char*)map + cache->calendar[calendar].offset);
+			cal->change = cal->start + cal->runs;
+			cal->index = (unsigned char*)(cal->change + cal->runs);
+			cal->shared = false;
+		}
+		else
+		{
+			*cal = body->calendar[source];
+			cal->shared = true;
+		}
+		memcpy(cal->day,cache->calendar[calendar].day,sizeof(cal->day));
+	}
+	body->map = map;
+	body->mapsize = size;
+	if ( body->flags&SN_INTERPOLATED )
+		interpolated_schedules = TRUE;
+	return true;
+}
+
+/* writes a compiled body to the schedule cache
+   the file is written under a temporary name and renamed so that other
+   simulations never map a partially written file
+ */
+static void schedule_cache_save(SCHEDULE *sch)
+{
+	static bool warned = false;
+	SCHEDULEBODY *body = sch->body;
+	char path[1200], temp[1200];
+	if ( ! schedule_cache_path(body,path,sizeof(path))
+		|| (size_t)snprintf(temp,sizeof(temp),"%s/.schXXXXXX",(const char*)global_schedule_cache) >= sizeof(temp) )
+	{
+		return;
+	}
+
+	/* build the header */
+	SCHEDULECACHE *cache = (SCHEDULECACHE*)malloc(sizeof(SCHEDULECACHE));
+	if ( cache == NULL )
+		return;
+	memset(cache,0,sizeof(SCHEDULECACHE));
+	size_t keysize = strlen(body->key) + 1;
+	cache->magic = SCHEDULE_CACHE_MAGIC;
+	cache->version = SCHEDULE_COMPILER_VERSION;
+	cache->header = sizeof(SCHEDULECACHE);
+	cache->keysize = keysize;
+	cache->hash = body->hash;
+	cache->flags = body->flags;
+	cache->block = body->block;
+	cache->invariant = body->invariant;
+	memcpy(cache->blockname,body->blockname,sizeof(body->blockname));
+	memcpy(cache->data,body->data,sizeof(body->data));
+	memcpy(cache->weight,body->weight,sizeof(body->weight));
+	memcpy(cache->sum,body->sum,sizeof(body->sum));
+	memcpy(cache->abs,body->abs,sizeof(body->abs));
+	memcpy(cache->count,body->count,sizeof(body->count));
+	memcpy(cache->minutes,body->minutes,sizeof(body->minutes));
+	size_t offset = SCHEDULE_CACHE_ALIGN(sizeof(SCHEDULECACHE)+keysize);
+	unsigned int calendar, other;
+	for ( calendar = 0 ; calendar < 14 ; calendar++ )
+	{
+		SCHEDULECALENDAR *cal = &(body->calendar[calendar]);
+		uint32 source = calendar;
+		for ( other = 0 ; cal->shared && other < calendar ; other++ )
+		{
+			if ( ! body->calendar[other].shared && body->calendar[other].start == cal->start )
+				source = other;
+		}
+		cache->calendar[calendar].runs = cal->runs;
+		cache->calendar[calendar].source = source;
+		memcpy(cache->calendar[calendar].day,cal->day,sizeof(cal->day));
+		if ( source == calendar )
+		{
+			cache->calendar[calendar].offset = offset;
+			offset = SCHEDULE_CACHE_ALIGN(offset + cal->runs*(2*sizeof(uint32)+sizeof(unsigned char)));
+		}
+	}
+	cache->size = offset;
+
+	/* write the file */
+	mkdir(global_schedule_cache,0755);
+	int fd = mkstemp(temp);
+	if ( fd >= 0 )
+		fchmod(fd,0644);
+	FILE *fp = fd < 0 ? NULL : fdopen(fd,"wb");
+	bool ok = fp != NULL;
+	if ( ok )
+	{
+		static const char pad[4] = {0,0,0,0};
+		ok = fwrite(cache,sizeof(SCHEDULECACHE),1,fp) == 1
+			&& fwrite(body->key,keysize,1,fp) == 1
+			&& fwrite(pad,SCHEDULE_CACHE_ALIGN(sizeof(SCHEDULECACHE)+keysize)-sizeof(SCHEDULECACHE)-keysize,1,fp) <= 1;
+		for ( calendar = 0 ; ok && calendar < 14 ; calendar++ )
+		{
+			SCHEDULECALENDAR *cal = &(body->calendar[calendar]);
+			if ( cache->calendar[calendar].source != calendar )
+				continue;
+			size_t runsize = cal->runs*(2*sizeof(uint32)+sizeof(unsigned char));
+			ok = fwrite(cal->start,sizeof(uint32),cal->runs,fp) == cal->runs
+				&& fwrite(cal->change,sizeof(uint32),cal->runs,fp) == cal->runs
+				&& fwrite(cal->index,sizeof(unsigned char),cal->runs,fp) == cal->runs
+				&& fwrite(pad,SCHEDULE_CACHE_ALIGN(runsize)-runsize,1,fp) <= 1;
+		}
+		ok = ( fclose(fp) == 0 ) && ok;
+	}
+	else if ( fd >= 0 )
+	{
+		close(fd);
+	}
+	if ( ok && rename(temp,path) == 0 )
+	{
+		IN_MYCONTEXT output_debug("schedule '%s' saved to cache file '%s'", sch->name, path);
+	}
+	else
+	{
+		if ( fd >= 0 )
+			unlink(temp);
+		if ( ! warned )
+		{
+			output_warning("unable to save schedule '%s' to cache folder '%s' (%s)", sch->name, (const char*)global_schedule_cache, strerror(errno));
+			/* TROUBLESHOOT
+			   The compiled schedule could not be written to the folder given by the schedule_cache global.
+			   Check that the folder can be created and written to, or clear schedule_cache to disable the cache.
+			   The schedule is still compiled and used, and this warning is only given once.
+			 */
+			warned = true;
+		}
+	}
+	free(cache);
+}
+
 static pthread_cond_t sc_active = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t sc_activelock = PTHREAD_MUTEX_INITIALIZER;
 static STATUS sc_status = SUCCESS;
@@ -535,94 +1024,31 @@ void *schedule_createproc(void *args)
 	pthread_mutex_unlock(&sc_activelock);
 
 	/* compile the schedule */
-	if (schedule_compile(sch))
+	sch->body->index = (unsigned char(*)[MINUTES_PER_CALENDAR])calloc(14,sizeof(sch->body->index[0]));
+	if ( sch->body->index == NULL )
 	{
-		/* construct the dtnext array */
-		unsigned char calendar;
-		int invariant = 1;
-		for (calendar=0; calendar<14; calendar++)
-		{
-			/* number of minutes that are indexed */
-			int t = sizeof(sch->dtnext[calendar])/sizeof(sch->dtnext[calendar][0])-1;
-
-			/* assume that loopback results in a value change in 1 minute */
-			sch->dtnext[calendar][t] = 1; 
-
-			/* scan backwards through time */
-			for (t--; t>=0; t--)
-			{
-				/* get this and the next index to values */
-				int index0 = sch->index[calendar][t];
-				int index1 = sch->index[calendar][t+1];
-
-				/* if the values are the same */
-				if (sch->data[index0]==sch->data[index1])
-				{	
-					/* if we haven't reached the maximum delta-t (for unsigned char dtnext) */
-					if (sch->dtnext[calendar][t+1]<255)
-
-						/* add 1 minute to next values time */
-						sch->dtnext[calendar][t] = sch->dtnext[calendar][t+1] + 1;
-					else
-
-						/* start the time over at 1 minute (to next value) */
-						sch->dtnext[calendar][t] = 1;
-				}
-				else
-				{
-					/* start the time over at 1 minute (to next value) */
-					sch->dtnext[calendar][t] = 1;
-					invariant = 0;
-				}
-			}
-		}
-
-		/* special case for invariant schedule */
-		if (invariant)
-			memset(sch->dtnext,0,sizeof(sch->dtnext)); /* zero means never */
-
-		/* check for gaps in the schedule */
-		else
-		{
-			int ngaps = 0;
-			int ingap = 0;
-			for (calendar=0; calendar<14; calendar++)
-			{
-				unsigned long t;
-				for ( t=0; t<sizeof(sch->dtnext[calendar])/sizeof(sch->dtnext[calendar][0])-1; t++ )
-				{
-					if ( sch->dtnext[calendar][t] == 0 && !ingap)
-					{
-						int day = t/60/24;
-						int hour = t/60 - day*24;
-						int minute = t - hour*60 - day*24*60;
-						IN_MYCONTEXT output_debug("schedule '%s' gap in calendar %d at day %d, hour %d, minute %d lasting %d minutes", sch->name, day, hour, minute);
-						ingap = 1;
-						ngaps++;
-					}
-					else if ( sch->dtnext[calendar][t] != 0 && ingap )
-						ingap = 0;
-				}
-			}
-			if (ngaps>0)
-				output_error("schedule '%s' has %d gaps which may cause erroneous results", sch->name, ngaps);
-				/* TROUBLESHOOT
-					The definition given the schedule has missing data that will cause time synchronization problems.
-					Make sure that all the time covered by the schedule has values given.
-				 */
-		}
+		output_error("schedule_createproc(SCHEDULE *sch={name='%s', ...}) memory allocation failed", sch->name);
+		status = FAILED;
+	}
+	else if (schedule_compile(sch) && schedule_compress(sch))
+	{
+		IN_MYCONTEXT output_debug("schedule '%s' compiled to %.1f kB", sch->name, schedule_memory(sch)/1024.0);
 
 		/* normalize */
-		if (sch->flags!=0)
-			schedule_normalize(sch,sch->flags);
+		if (sch->body->flags!=0)
+			schedule_normalize(sch,sch->body->flags);
 
 		/* validate */
-		if ((sch->flags&(SN_POSITIVE|SN_NONZERO|SN_BOOLEAN)) != 0 && ! schedule_validate(sch,sch->flags))
+		if ((sch->body->flags&(SN_POSITIVE|SN_NONZERO|SN_BOOLEAN)) != 0 && ! schedule_validate(sch,sch->body->flags))
 		{
 			status = FAILED;
 			goto Done;
 		}
 
+		/* save for other simulations */
+		if ( strcmp(global_schedule_cache,"") != 0 )
+			schedule_cache_save(sch);
+
 #ifdef _DEBUG
 		/* calculate checksum */
 		sch->checksum = schedule_checksum(sch);
@@ -633,6 +1059,12 @@ void *schedule_createproc(void *args)
 	else
 		status = FAILED;
 Done:
+	/* the dense index is only needed by the compiler */
+	if ( sch->body->index != NULL )
+	{
+		free(sch->body->index);
+		sch->body->index = NULL;
+	}
 	pthread_mutex_lock(&sc_activelock);
 	sc_running--;
 	sc_done++;
@@ -661,8 +1093,11 @@ int schedule_createwait(void)
 	{
 		void *rc;
 		pthread_join(*thread,&rc);
-		status |= *(int*)rc;
+		if ( ! *(bool*)rc )
+			status = FAILED;
+		delete (bool*)rc;
 	}
+	thread_list.clear();
 	return status;
 	// if ( sc_running==0 && sc_done==sc_started ) return sc_status;
 	// pthread_mutex_lock(&sc_activelock);
@@ -720,31 +1155,60 @@ SCHEDULE *schedule_create(const char *name,		/**< the name of the schedule */
 		 */
 		return NULL;
 	}
-	IN_MYCONTEXT output_debug("schedule '%s' uses %.1f MB of memory", name, sizeof(SCHEDULE)/1000000.0);
 	if (strlen(name)>=sizeof(sch->name))
 	{
 		output_error("schedule_create(char *name='%s', char *definition='%s') name too long)", name, definition);
 		/* TROUBLESHOOT
 			The name given the schedule is too long to be used.  Use a name that is less than 64 characters and try again.
 		 */
-		free(sch);
+		schedule_free(sch);
 		return NULL;
 	}
 	strcpy(sch->name,name);
-	if (strlen(definition)>=sizeof(sch->definition))
+	if (strlen(definition)>=MAXDEFINITION)
 	{
 		output_error("schedule_create(char *name='%s', char *definition='%s') definition too long)", name, definition);
 		/* TROUBLESHOOT
 			The definition given the schedule is too long to be used.  Use a definition that is less than 1024 characters and try again.
 		 */
-		free(sch);
+		schedule_free(sch);
+		return NULL;
+	}
+	sch->definition = strdup(definition);
+	if (sch->definition==NULL)
+	{
+		output_error("schedule_create(char *name='%s', char *definition='%s') memory allocation failed)", name, definition);
+		schedule_free(sch);
+		return NULL;
+	}
+
+	/* use the body of an identical definition if any */
+	bool created;
+	sch->body = schedule_body_get(sch->definition,&created);
+	if (sch->body==NULL)
+	{
+		output_error("schedule_create(char *name='%s', char *definition='%s') memory allocation failed)", name, definition);
+		schedule_free(sch);
 		return NULL;
 	}
-	strcpy(sch->definition,definition);
 
 	/* attach to schedule list */
 	schedule_add(sch);
 
+	/* identical definitions are compiled only once */
+	if ( ! created )
+	{
+		IN_MYCONTEXT output_debug("schedule '%s' uses the compiled body of an identical definition (%u schedules)", sch->name, sch->body->refcount);
+		return sch;
+	}
+
+	/* definitions compiled by an earlier simulation are mapped from the cache */
+	if ( strcmp(global_schedule_cache,"") != 0 && schedule_cache_load(sch->body) )
+	{
+		IN_MYCONTEXT output_debug("schedule '%s' loaded from the schedule cache", sch->name);
+		return sch;
+	}
+
 	/* singlethreaded creation */
 	if ( global_threadcount<=1 )
 	{
@@ -758,7 +1222,7 @@ SCHEDULE *schedule_create(const char *name,		/**< the name of the schedule */
 		else
 		{
 			/* error message should be given by schedule_compile */
-			free(sch);
+			schedule_free(sch);
 			sch = NULL;
 			return NULL;
 		}
@@ -812,10 +1276,10 @@ int schedule_validate(SCHEDULE *sch, int flags)
 	int failed=0;
 	for (b=0; b<MAXBLOCKS; b++) {
 		i = (flags & SN_NONZERO ? 0 : 1);
-		for (; i<=sch->count[b]; i++)
+		for (; i<=sch->body->count[b]; i++)
 		{
-			double value = sch->data[b*MAXVALUES+i];
-			int weight = sch->weight[b*MAXVALUES+i];
+			double value = sch->body->data[b*MAXVALUES+i];
+			int weight = sch->body->weight[b*MAXVALUES+i];
 			int nonzero = (weight>0 && value!=0.0);
 			int boolean = (weight>0 && (value==0.0 || value==1.0));
 			int positive = (weight>0 && value>0.0);
@@ -824,17 +1288,17 @@ int schedule_validate(SCHEDULE *sch, int flags)
 				nzct += weight;
 			if ((flags&SN_BOOLEAN) && !boolean)
 			{
-				output_error("schedule %s fails 'boolean' validation in block %s at schedule index %d", sch->name, sch->blockname[b], i);
+				output_error("schedule %s fails 'boolean' validation in block %s at schedule index %d", sch->name, sch->body->blockname[b], i);
 				failed = 1;
 			}
 			else if ((flags&SN_POSITIVE) && !positive)
 			{
-				output_error("schedule %s fails 'positive' validation in block %s at schedule index %d", sch->name, sch->blockname[b], i);
+				output_error("schedule %s fails 'positive' validation in block %s at schedule index %d", sch->name, sch->body->blockname[b], i);
 				failed = 1;
 			}
 			else if ((flags&SN_NONZERO) && !nonzero)
 			{
-				output_error("schedule %s fails 'nonzero' validation in block %s at schedule index %d", sch->name, sch->blockname[b], i);
+				output_error("schedule %s fails 'nonzero' validation in block %s at schedule index %d", sch->name, sch->body->blockname[b], i);
 				failed = 1;
 			}
 		}
@@ -860,7 +1324,7 @@ int schedule_normalize(SCHEDULE *sch,	/**< the schedule to normalize */
 	for (b=0; b<MAXBLOCKS; b++)
 	{
 		/* ignore empty blocks */
-		if (sch->count[b]==0)
+		if (sch->body->count[b]==0)
 			continue;
 
 		/* weighted normalization */
@@ -870,33 +1334,33 @@ int schedule_normalize(SCHEDULE *sch,	/**< the schedule to normalize */
 			unsigned int i;
 			int nonzero = 0;
 			memset(scale,0,sizeof(scale));
-			for (i=1; i<=sch->count[b]; i++)
+			for (i=1; i<=sch->body->count[b]; i++)
 			{
-				if (sch->weight[i]!=0)
+				if (sch->body->weight[i]!=0)
 				{
 					nonzero = 1;
-					scale[i] += sch->data[b*MAXVALUES+i] * sch->weight[i] / sch->minutes[b];
+					scale[i] += sch->body->data[b*MAXVALUES+i] * sch->body->weight[i] / sch->body->minutes[b];
 				}
 			}
 			if (nonzero)
 			{
-				for (i=1; i<=sch->count[b]; i++)
-					sch->data[b*MAXVALUES+i]*=scale[i];
+				for (i=1; i<=sch->body->count[b]; i++)
+					sch->body->data[b*MAXVALUES+i]*=scale[i];
 			}
 		}
 
 		/* unweighted normalization */
 		else
 		{
-			double scale = (flags&SN_ABSOLUTE?sch->abs[b]:sch->sum[b]);
+			double scale = (flags&SN_ABSOLUTE?sch->body->abs[b]:sch->body->sum[b]);
 
 			/* if the coefficient is non-zero */
 			if (scale!=0)
 			{
 				/* normalize the values */
 				count++;
-				for (i=1; i<=sch->count[b]; i++)
-					sch->data[b*MAXVALUES+i]/=scale;
+				for (i=1; i<=sch->body->count[b]; i++)
+					sch->body->data[b*MAXVALUES+i]/=scale;
 			}
 		}
 	}
@@ -929,7 +1393,7 @@ SCHEDULEINDEX schedule_index(SCHEDULE *sch, TIMESTAMP ts)
 	/* compute the minute of year */
 	min=(dt.yearday*24 + dt.hour)*60 + dt.minute;
 
-	if ( cal>=14 || min>=60*24*366 )
+	if ( cal>=14 || min>=MINUTES_PER_CALENDAR )
 		output_error("schedule_index(): timestamp %" FMT_INT64 "d has calendar %d minute %d which is invalid", ts, cal, min);
 
 	SET_CALENDAR(ref, cal);
@@ -939,6 +1403,22 @@ SCHEDULEINDEX schedule_index(SCHEDULE *sch, TIMESTAMP ts)
 	return ref;
 }
 
+/* finds the run of a calendar that contains a minute */
+static inline uint32 schedule_run(SCHEDULECALENDAR *cal, uint32 min)
+{
+	uint32 day = min/(24*60);
+	uint32 lo = cal->day[day], hi = cal->day[day+1];
+	while ( lo < hi )
+	{
+		uint32 mid = (lo+hi+1)/2;
+		if ( cal->start[mid] <= min )
+			lo = mid;
+		else
+			hi = mid-1;
+	}
+	return lo;
+}
+
 /** reads the value on the schedule
     @return current value on schedule
  **/
@@ -947,22 +1427,34 @@ double schedule_value(SCHEDULE *sch,		/**< the schedule to read */
 {
 	int32 cal = GET_CALENDAR(index);
 	int32 min = GET_MINUTE(index);
-	if ( cal>=14 || min>=60*24*366 )
+	if ( cal>=14 || min>=MINUTES_PER_CALENDAR )
+	{
 		output_error("schedule_index(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	return sch->data[sch->index[cal][min]];
+		return 0.0;
+	}
+	SCHEDULECALENDAR *calendar = &(sch->body->calendar[cal]);
+	return sch->body->data[calendar->index[schedule_run(calendar,min)]];
 }
 
 /** reads the time until the next change in the schedule 
-	@return time until next value change (in minutes)
+	@note the time is given as it would be counted down to 1 minute every 255 minutes
+	@return time until next value change (in minutes), 0 if never
  **/
 int32 schedule_dtnext(SCHEDULE *sch,			/**< the schedule to read */
 					 SCHEDULEINDEX index)	/**< the index of the value to read (see schedule_index) */
 {
 	int32 cal = GET_CALENDAR(index);
 	int32 min = GET_MINUTE(index);
-	if ( cal>=14 || min>=60*24*366 )
+	if ( cal>=14 || min>=MINUTES_PER_CALENDAR )
+	{
 		output_error("schedule_dtnext(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	return sch->dtnext[cal][min];
+		return 0;
+	}
+	if ( sch->body->invariant )
+		return 0;
+	SCHEDULECALENDAR *calendar = &(sch->body->calendar[cal]);
+	uint32 dt = calendar->change[schedule_run(calendar,min)] - min;
+	return (dt-1)%255 + 1;
 }
 
 int32 schedule_duration(SCHEDULE *sch,			/**< the schedule to read */
@@ -971,10 +1463,14 @@ int32 schedule_duration(SCHEDULE *sch,			/**< the schedule to read */
 	int32 cal = GET_CALENDAR(index);
 	int32 min = GET_MINUTE(index);
 	int block;
-	if ( cal>=14 || min>=60*24*366 )
+	if ( cal>=14 || min>=MINUTES_PER_CALENDAR )
+	{
 		output_error("schedule_duration(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	block = (sch->index[cal][min]>>6)&MAXBLOCKS; // these change if MAXVALUES or MAXBLOCKS changes
-	return sch->minutes[block];
+		return 0;
+	}
+	SCHEDULECALENDAR *calendar = &(sch->body->calendar[cal]);
+	block = (calendar->index[schedule_run(calendar,min)]>>6)&MAXBLOCKS; // these change if MAXVALUES or MAXBLOCKS changes
+	return sch->body->minutes[block];
 }
 
 double schedule_weight(SCHEDULE *sch,			/**< the schedule to read */
@@ -982,9 +1478,13 @@ double schedule_weight(SCHEDULE *sch,			/**< the schedule to read */
 {
 	int32 cal = GET_CALENDAR(index);
 	int32 min = GET_MINUTE(index);
-	if ( cal>=14 || min>=60*24*366 )
+	if ( cal>=14 || min>=MINUTES_PER_CALENDAR )
+	{
 		output_error("schedule_weight(): index %d has calendar %d minute %d which is invalid", index, cal, min);
-	return sch->weight[sch->index[cal][min]];
+		return 0.0;
+	}
+	SCHEDULECALENDAR *calendar = &(sch->body->calendar[cal]);
+	return sch->body->weight[calendar->index[schedule_run(calendar,min)]];
 }
 
 /** synchronize the schedule to the time given
@@ -998,7 +1498,7 @@ TIMESTAMP schedule_sync(SCHEDULE *sch, /**< the schedule that is to be synchroni
 		output_warning("schedule '%s' may be corrupted", sch->name);
 #endif
 
-	if ((sch->flags & SN_INTERPOLATED) == SN_INTERPOLATED)
+	if ((sch->body->flags & SN_INTERPOLATED) == SN_INTERPOLATED)
 	{
 		/* 
 		 * In interpolation mode we call for the next sync when the schedule changes, but if any other
@@ -1358,7 +1858,7 @@ void schedule_dump(SCHEDULE *sch, const char *file, const char *mode)
 	unsigned int calendar;
 
 	fprintf(fp,"schedule %s { %s }\n", sch->name, sch->definition);
-	fprintf(fp,"sizeof(SCHEDULE) = %.3f MB\n", (double)sizeof(SCHEDULE)/1024/1024);
+	fprintf(fp,"schedule memory = %.3f kB\n", (double)schedule_memory(sch)/1024);
 	for (calendar=0; calendar<14; calendar++)
 	{
 		int year=0, month, y;
@@ -51,10 +51,56 @@ typedef uint32 SCHEDULEINDEX;
 #define SET_CALENDAR(N,X) (N)|=(((X)&0x0f)<<20)
 #define SET_MINUTE(N,X) (N)|=((X)&0x0fffff)
 
+#define MAXDEFINITION 65536
+#define MINUTES_PER_CALENDAR (366*24*60)
+
 #ifdef _DEBUG
 #define SCHEDULE_MAGIC 0x47ab617e
 #endif
 
+/** The SCHEDULECALENDAR structure holds one compiled annual calendar
+
+	The minutes of the year are stored as runs over which the value index
+	does not change.  Runs are sorted by their first minute and day[] gives the
+	run in effect at the start of each day, so a lookup only searches the runs
+	of one day.
+ **/
+typedef struct s_schedulecalendar {
+	uint32 runs;						/**< the number of runs */
+	uint32 *start;						/**< the first minute of each run */
+	uint32 *change;						/**< the minute of the next value change after each run */
+	unsigned char *index;				/**< the value index of each run */
+	uint32 day[367];					/**< the run in effect at the start of each day (day[366] is the last run) */
+	bool shared;						/**< the runs belong to an earlier identical calendar */
+} SCHEDULECALENDAR;
+
+/** The SCHEDULEBODY structure holds the compiled form of a schedule definition
+
+	Schedules whose definitions are the same apart from extra whitespace share
+	one body, which is freed when the last of them is freed.
+ **/
+typedef struct s_schedulebody SCHEDULEBODY;
+struct s_schedulebody {
+	unsigned int refcount;				/**< the number of schedules using the body */
+	unsigned long long hash;			/**< the hash of the normalized definition and the compiler version */
+	char *key;							/**< the normalized definition */
+	char blockname[MAXBLOCKS][64];		/**< the name of each block */
+	unsigned char block;				/**< the last block used (4 max) */
+	unsigned char (*index)[MINUTES_PER_CALENDAR];	/**< the schedule index of all 14 annual calendars to 1 minute resolution (only while compiling) */
+	SCHEDULECALENDAR calendar[14];		/**< the compiled annual calendars */
+	bool invariant;						/**< the schedule value never changes */
+	double data[MAXBLOCKS*MAXVALUES];	/**< the list of values used in each block */
+	unsigned int weight[MAXBLOCKS*MAXVALUES];	/**< the weight (in minutes) associate with each value */
+	double sum[MAXBLOCKS];				/**< the sum of values for each block -- used to normalize */
+	double abs[MAXBLOCKS];				/**< the sum of the absolute values for each block -- used to normalize */
+	unsigned int count[MAXBLOCKS];		/**< the number of values given in each block */
+	unsigned int minutes[MAXBLOCKS];	/**< the total number of minutes associate with each block */
+	int flags;							/**< the compiled schedule flags (see SN_*) */
+	void *map;							/**< the cache file the calendars are mapped from (NULL if compiled) */
+	size_t mapsize;						/**< the size of the mapped cache file */
+	SCHEDULEBODY *next;					/**< next body with the same hash bucket */
+};
+
 /** The SCHEDULE structure defines POSIX style schedules */
 typedef struct s_schedule SCHEDULE;
 struct s_schedule {
@@ -64,17 +110,8 @@ struct s_schedule {
 	unsigned int magic1;	/* values between magic1 and magic2 should never change once compiled */
 #endif
 	char name[64];						/**< the name of the schedule */
-	char definition[65536];				/**< the definition string of the schedule */
-	char blockname[MAXBLOCKS][64];		/**< the name of each block */
-	unsigned char block;				/**< the last block used (4 max) */
-	unsigned char index[14][366*24*60];	/**< the schedule index (enough room for all 14 annual calendars to 1 minute resolution) */
-	unsigned char dtnext[14][366*24*60];/**< the time until the next schedule change (in minutes) */
-	double data[MAXBLOCKS*MAXVALUES];	/**< the list of values used in each block */
-	unsigned int weight[MAXBLOCKS*MAXVALUES];	/**< the weight (in minutes) associate with each value */
-	double sum[MAXBLOCKS];				/**< the sum of values for each block -- used to normalize */
-	double abs[MAXBLOCKS];				/**< the sum of the absolute values for each block -- used to normalize */
-	unsigned int count[MAXBLOCKS];		/**< the number of values given in each block */
-	unsigned int minutes[MAXBLOCKS];	/**< the total number of minutes associate with each block */
+	char *definition;					/**< the definition string of the schedule */
+	SCHEDULEBODY *body;					/**< the compiled schedule (may be shared) */
 #ifdef _DEBUG
 	unsigned int magic2;
 	unsigned int checksum;
@@ -83,7 +120,7 @@ struct s_schedule {
 	TIMESTAMP since;
 	double duration;					/**< the duration of the current scheduled value (in hours) */
 	double fraction;					/**< the fractional weight of the block of the current value (pu time) */
-	int flags;							/**< the schedule flags (see SN_*) */
+	int flags;							/**< the schedule flags (see SN_USERDEFINED, the compiled flags are in the body) */
 	SCHEDULE *next;	/* next schedule in list */
 };
 
@@ -119,6 +156,7 @@ void schedule_dumpall(const char *file);
 int schedule_createwait(void);
 SCHEDULE *schedule_getfirst(void);
 int schedule_saveall(FILE *fp,bool user_defined_only=true);
+size_t schedule_memory(SCHEDULE *sch);
 
 #ifdef __cplusplus
 }
@@ -862,7 +862,7 @@ int http_xml_request(HTTPCNX *http,char *uri)
 			DO_PROPERTY("id","%d",obj->id);
 			DO_PROPERTY("class","%s",obj->oclass->name);
 			if ( obj->name ) DO_PROPERTY("name","%s",object_name(obj,buffer,sizeof(buffer)));
-			if ( strlen(obj->groupid)>0 ) DO_PROPERTY("groupid","%s",(const char*)obj->groupid);
+			if ( strlen(obj->cold->groupid)>0 ) DO_PROPERTY("groupid","%s",(const char*)obj->cold->groupid);
 			if ( obj->parent ) DO_PROPERTY("parent","%s",object_name(obj->parent,buffer,sizeof(buffer)));
 			DO_PROPERTY("rank","%d",obj->rank);
 			DO_PROPERTY("clock","%lld",obj->clock);
@@ -1013,7 +1013,7 @@ int http_json_request(HTTPCNX *http,char *uri)
 			DO_PROPERTY("id","%d",obj->id);
 			DO_PROPERTY("class","%s",obj->oclass->name);
 			if ( obj->name ) DO_PROPERTY("name","%s",object_name(obj,buffer,sizeof(buffer)));
-			if ( strlen(obj->groupid)>0 ) DO_PROPERTY("groupid","%s",(const char*)obj->groupid);
+			if ( strlen(obj->cold->groupid)>0 ) DO_PROPERTY("groupid","%s",(const char*)obj->cold->groupid);
 			if ( obj->parent ) DO_PROPERTY("parent","%s",object_name(obj->parent,buffer,sizeof(buffer)));
 			DO_PROPERTY("rank","%d",obj->rank);
 			DO_PROPERTY("clock","%lld",obj->clock);
@@ -1110,7 +1110,7 @@ int http_find_request(HTTPCNX *http,char *uri)
 		return 0;
 	http_format(http,"[\n");
 	obj = find_first(list);
-	while ( 1 )
+	while ( obj != NULL )
 	{
 		if ( obj->name == NULL )
 			http_format(http,"\t{\"name\" : \"%s:%d\"}",obj->oclass->name,obj->id);
@@ -4,6 +4,9 @@
 
 #include "gldcore.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+
 SET_MYCONTEXT(DMC_STREAM)
 
 
@@ -42,7 +45,7 @@ extern "C" {
 #define STREAM_NAME "GRIDLABD"
 
 /* stream version - change this when the structure of the stream changes */
-#define STREAM_VERSION 2
+#define STREAM_VERSION 3
 
 /* stream handle */
 static FILE *fp = NULL;
@@ -290,6 +293,10 @@ size_t stream_decompress(char *buf, const size_t len)
 static size_t stream_pos = 0;
 static int flags = 0x00;
 
+/* mapped input image (see stream_restore) */
+static const char *map_data = NULL;
+static size_t map_size = 0;
+
 /** Stream data
     @returns Bytes read/written to/from stream
  **/
@@ -303,7 +310,7 @@ size_t stream(void *ptr, ///< pointer to buffer
 #ifdef _DEBUG
 		if ( is_str ) len = strlen((char*)ptr);
 		unsigned int a = fprintf(fp,"%d ",len);
-		if ( a<0 ) throw;
+		if ( a<0 ) throw "write error";
 		unsigned int i;
 		for ( i=0 ; i<len ; i++ )
 		{
@@ -312,20 +319,20 @@ size_t stream(void *ptr, ///< pointer to buffer
 			if ( !is_str || c<32 || c>126 || c=='\\' )
 				b = fprintf(fp,"\\%02x",c);
 			else if ( fputc(c,fp)==EOF ) b=-1;
-			if ( b==-1 ) throw;
+			if ( b==-1 ) throw "write error";
 			a+=b;
 		}
 		unsigned int b = fprintf(fp,"\n");
-		if ( b<0 ) throw;
+		if ( b<0 ) throw "write error";
 		a+=b;
 		stream_pos += a;
 		return a;
 #else
 		if ( is_str ) len = strlen((char*)ptr);
 		size_t a = fwrite((void*)&len,1,sizeof(len),fp);
-		if ( a!=sizeof(len) ) throw;
+		if ( a!=sizeof(len) ) throw "write error";
 		size_t b = fwrite((void*)ptr,1,len,fp);
-		if ( b!=len ) throw;
+		if ( b!=len ) throw "write error";
 		a+=b;
 		stream_pos += a;
 		return a;
@@ -336,7 +343,7 @@ size_t stream(void *ptr, ///< pointer to buffer
 #ifdef _DEBUG
 		unsigned int a;
 		if ( fscanf(fp,"%d",&a)<1 ) throw -1;
-		if ( a>len ) throw;
+		if ( a>len ) throw "block too long";
 		if ( fgetc(fp)!=' ') throw "FMT";
 		memset(ptr,0,len);
 		unsigned int i;
@@ -352,23 +359,69 @@ size_t stream(void *ptr, ///< pointer to buffer
 		stream_pos += b;
 		return b;
 #else
-		size_t a, b = fread(&a,1,sizeof(size_t),fp);
-		if ( b<sizeof(size_t) ) throw -1;
-		if ( a>len ) throw;
-		size_t c = fread((void*)ptr,1,a,fp);
-		if ( a!=c ) throw;
+		size_t a, b, c;
+		if ( map_data != NULL )
+		{
+			/* read directly from the mapped image */
+			if ( stream_pos+sizeof(size_t) > map_size ) throw -1;
+			memcpy(&a,map_data+stream_pos,sizeof(size_t));
+			b = sizeof(size_t);
+			if ( a>len ) throw "block too long";
+			if ( stream_pos+b+a > map_size ) throw "truncated image";
+			memcpy(ptr,map_data+stream_pos+b,a);
+			c = a;
+		}
+		else
+		{
+			b = fread(&a,1,sizeof(size_t),fp);
+			if ( b<sizeof(size_t) ) throw -1;
+			if ( a>len ) throw "block too long";
+			c = fread((void*)ptr,1,a,fp);
+			if ( a!=c ) throw "truncated image";
+		}
+		if ( is_str && a<len ) ((char*)ptr)[a] = '\0';
 		if ( match!=NULL && memcmp(ptr,match,a)!=0 ) throw 0;
 		b+=c;
 		stream_pos += b;
 		return b;
 #endif
 	}
-	throw;
+	throw "stream not open";
 }
 void stream(const char *s,size_t max=0) { char t[1024]; strncpy(t,s,sizeof(t)); stream((void*)t,max?max:strlen(s),true,(void*)s); }
 void stream(char *s,size_t max=0) { stream((void*)s,max?max:strlen(s),true); }
 template<class T> void stream(T &v) { stream(&v,sizeof(T)); }
 
+/** Read a block of known length without copying it when the image is mapped
+	@returns Pointer to the block data, valid until the next call
+ **/
+static const void *stream_view(size_t len)
+{
+#ifndef _DEBUG
+	if ( map_data != NULL )
+	{
+		size_t a;
+		if ( stream_pos+sizeof(size_t) > map_size ) throw -1;
+		memcpy(&a,map_data+stream_pos,sizeof(size_t));
+		if ( a != len || stream_pos+sizeof(size_t)+a > map_size ) throw "block size mismatch";
+		const void *data = map_data+stream_pos+sizeof(size_t);
+		stream_pos += sizeof(size_t)+a;
+		return data;
+	}
+#endif
+	static char *buffer = NULL;
+	static size_t size = 0;
+	if ( len > size )
+	{
+		char *bigger = (char*)realloc(buffer,len);
+		if ( bigger == NULL ) throw "out of memory";
+		buffer = bigger;
+		size = len;
+	}
+	stream(buffer,len);
+	return buffer;
+}
+
 // module stream
 void stream(MODULE *mod)
 {
@@ -383,7 +436,11 @@ void stream(MODULE *mod)
 		stream(name,sizeof(name));
 
 		if ( flags&SF_OUT ) mod = mod->next;
-		if ( flags&SF_IN ) module_load(name,0,NULL);
+		if ( flags&SF_IN && module_find(name)==NULL )
+		{
+			output_error("checkpoint uses module '%s', which is not loaded", name);
+			throw "module mismatch";
+		}
 	}
 	stream("/MOD");
 }
@@ -399,7 +456,7 @@ void stream(CLASS *oclass, PROPERTY *prop)
 	for ( n=0 ; n<count ; n++ )
 	{
 		char name[64]; if ( prop ) strcpy(name,prop->name);
-		stream(prop->name,strlen(prop->name));
+		stream(name,sizeof(name));
 
 		PROPERTYTYPE ptype; if ( prop ) ptype = prop->ptype;
 		stream(ptype);
@@ -411,7 +468,11 @@ void stream(CLASS *oclass, PROPERTY *prop)
 		stream(width);
 
 		if ( flags&SF_OUT ) prop = prop->next;
-		if ( flags&SF_IN ) class_add_extended_property(oclass,name,ptype,unit);
+		if ( flags&SF_IN && class_find_property(oclass,name)==NULL )
+		{
+			output_error("checkpoint uses property '%s' of class '%s', which is not defined", name, oclass->name);
+			throw "property mismatch";
+		}
 	}
 	stream("/RTC");
 }
@@ -435,50 +496,236 @@ void stream(CLASS *oclass)
 		PASSCONFIG passconfig; if ( oclass ) passconfig = oclass->passconfig;
 		stream(passconfig);
 
-		if ( flags&SF_IN ) oclass = class_register(NULL,name,size,passconfig);
+		if ( flags&SF_IN ) 
+		{
+			oclass = class_get_class_from_classname(name);
+			if ( oclass==NULL || oclass->size!=size )
+			{
+				output_error("checkpoint uses runtime class '%s', which is not defined the same way", name);
+				throw "class mismatch";
+			}
+		}
 
 		// TODO parent
 
 		stream(oclass,oclass->pmap);
 
 		if ( flags&SF_OUT ) oclass = class_get_next_runtime(oclass);
-		if ( flags&SF_IN ) module_load(oclass->name,0,NULL);
 	}
 	stream("/RTC");
 }
 
+/* copy the state of a loadshape, enduse, or randomvar, keeping the pointers of the live copy */
+template<class T> static void stream_copy_state(T *to, const T *from, const void **pointers, size_t count)
+{
+	const void *save[8];
+	size_t n;
+	for ( n=0 ; n<count ; n++ ) save[n] = *(const void**)pointers[n];
+	memcpy((void*)to,(const void*)from,sizeof(T));
+	for ( n=0 ; n<count ; n++ ) *(const void**)pointers[n] = save[n];
+}
+
+/* restore the published properties of an object from its image
+
+   The restore is a snapshot of the published properties only.  Data that
+   a class does not publish keeps the values set by its init, so a restored
+   run matches the original run only for classes whose state is published.
+ */
+static void stream_restore_properties(OBJECT *obj, const char *image)
+{
+	char *data = (char*)(obj+1);
+	CLASS *oclass;
+	PROPERTY *prop;
+	for ( oclass=obj->oclass ; oclass!=NULL ; oclass=oclass->parent )
+	{
+		for ( prop=oclass->pmap ; prop!=NULL && prop->oclass==oclass ; prop=prop->next )
+		{
+			size_t offset = (size_t)prop->addr;
+			void *addr = data+offset;
+			const void *from = image+offset;
+			switch ( prop->ptype ) {
+			case PT_double:
+			case PT_complex:
+			case PT_enumeration:
+			case PT_set:
+			case PT_int16:
+			case PT_int32:
+			case PT_int64:
+			case PT_bool:
+			case PT_timestamp:
+			case PT_real:
+			case PT_float:
+				memcpy(addr,from,property_size_by_type(prop->ptype)*(prop->size>1?prop->size:1));
+				break;
+			case PT_char8:
+			case PT_char32:
+			case PT_char256:
+			case PT_char1024:
+				/* strings are copied only up to their terminator so that a
+				   short string never overwrites the fields that follow it */
+				memcpy(addr,from,strnlen((const char*)from,property_size_by_type(prop->ptype)-1)+1);
+				break;
+			case PT_loadshape:
+			{
+				loadshape *ls = (loadshape*)addr;
+				const void *pointers[] = {&ls->schedule, &ls->next};
+				stream_copy_state(ls,(const loadshape*)from,pointers,sizeof(pointers)/sizeof(pointers[0]));
+				break;
+			}
+			case PT_enduse:
+			{
+				enduse *eu = (enduse*)addr;
+				const void *pointers[] = {&eu->name, &eu->shape, &eu->end_obj, &eu->next};
+				stream_copy_state(eu,(const enduse*)from,pointers,sizeof(pointers)/sizeof(pointers[0]));
+				break;
+			}
+			case PT_random:
+			{
+				randomvar *rv = (randomvar*)addr;
+				const void *pointers[] = {&rv->correlation, &rv->next};
+				stream_copy_state(rv,(const randomvar*)from,pointers,sizeof(pointers)/sizeof(pointers[0]));
+				break;
+			}
+			default:
+				/* object references are restored by the fixup table, other types keep their model values */
+				break;
+			}
+		}
+	}
+}
+
 // object stream
 void stream(OBJECT *obj)
 {
 	stream("OBJ");
+
 	size_t count = object_get_count();
 	stream(count);
+	if ( flags&SF_IN && count!=object_get_count() )
+	{
+		output_error("checkpoint has %d objects but the model has %d objects", (int)count, (int)object_get_count());
+		throw "object count mismatch";
+	}
 	size_t n;
 	for ( n=0 ; n<count ; n++)
 	{
-		char cname[64]; if ( obj ) strcpy(cname,obj->oclass->name);
+		OBJECTNUM id; if ( obj ) id = obj->id;
+		stream(id);
+		if ( flags&SF_IN ) obj = object_find_by_id(id);
+
+		char cname[64]; if ( flags&SF_OUT ) strncpy(cname,obj->oclass->name,sizeof(cname)-1);
 		stream(cname,sizeof(cname));
 
-		unsigned int size; if ( obj) size = sizeof(OBJECT)+obj->oclass->size;
-		stream(&size,sizeof(size));
+		unsigned int size; if ( flags&SF_OUT ) size = obj->oclass->size;
+		stream(size);
 
-		char oname[64]; if ( obj ) strcpy(oname,obj->name?obj->name:"");
-		stream(oname,sizeof(oname));
+		if ( flags&SF_IN && ( obj==NULL || strcmp(obj->oclass->name,cname)!=0 || obj->oclass->size!=size ) )
+		{
+			output_error("checkpoint object %d of class '%s' does not match the model", id, cname);
+			throw "object mismatch";
+		}
 
-		OBJECT *data=(OBJECT*)malloc(size); if ( obj ) memcpy(data,obj,size);
-		stream(data,size);
+		// header and data are raw blocks
+		if ( flags&SF_OUT )
+		{
+			stream(obj,sizeof(OBJECT));
+			stream(obj+1,size);
+		}
+		else
+		{
+			const OBJECT *header = (const OBJECT*)stream_view(sizeof(OBJECT));
+			obj->clock = header->clock;
+			obj->valid_to = header->valid_to;
+			obj->schedule_skew = header->schedule_skew;
+			obj->latitude = header->latitude;
+			obj->longitude = header->longitude;
+			obj->in_svc = header->in_svc;
+			obj->out_svc = header->out_svc;
+			obj->in_svc_micro = header->in_svc_micro;
+			obj->out_svc_micro = header->out_svc_micro;
+			obj->in_svc_double = header->in_svc_double;
+			obj->out_svc_double = header->out_svc_double;
+			obj->rng_state = header->rng_state;
+			obj->heartbeat = header->heartbeat;
+			obj->delta_substep = header->delta_substep;
+			obj->flags = header->flags;
+			stream_restore_properties(obj,(const char*)stream_view(size));
+		}
+
+		// pointer fixup table maps object references to object ids
+		size_t n_fixups = 0;
+		CLASS *oclass;
+		PROPERTY *prop;
+		if ( flags&SF_OUT )
+		{
+			for ( oclass=obj->oclass ; oclass!=NULL ; oclass=oclass->parent )
+				for ( prop=oclass->pmap ; prop!=NULL && prop->oclass==oclass ; prop=prop->next )
+					if ( prop->ptype==PT_object ) n_fixups++;
+		}
+		stream(n_fixups);
+		if ( flags&SF_OUT )
+		{
+			for ( oclass=obj->oclass ; oclass!=NULL ; oclass=oclass->parent )
+			{
+				for ( prop=oclass->pmap ; prop!=NULL && prop->oclass==oclass ; prop=prop->next )
+				{
+					if ( prop->ptype!=PT_object ) continue;
+					uint64 offset = (uint64)prop->addr;
+					OBJECT *ref = *(OBJECT**)GETADDR(obj,prop);
+					OBJECTNUM refid = ( ref ? ref->id : (OBJECTNUM)-1 );
+					stream(offset);
+					stream(refid);
+				}
+			}
+		}
+		else
+		{
+			size_t m;
+			for ( m=0 ; m<n_fixups ; m++ )
+			{
+				uint64 offset;
+				OBJECTNUM refid;
+				stream(offset);
+				stream(refid);
+				if ( offset+sizeof(OBJECT*) > size ) throw "invalid fixup";
+				*(OBJECT**)((char*)(obj+1)+offset) = ( refid==(OBJECTNUM)-1 ? NULL : object_find_by_id(refid) );
+			}
+		}
 
 		// TODO forecast and namespace
 
-		if ( flags&SF_OUT ) 
+		if ( flags&SF_OUT ) obj = obj->next;
+	}
+	stream("/OBJ");
+}
+
+// schedule stream
+void stream(SCHEDULE *sch)
+{
+	stream("SCH");
+
+	size_t count = 0;
+	SCHEDULE *item;
+	for ( item=schedule_getnext(NULL) ; item!=NULL ; item=schedule_getnext(item) ) count++;
+	stream(count);
+	size_t n;
+	for ( n=0 ; n<count ; n++ )
+	{
+		char name[64]; if ( sch ) strcpy(name,sch->name);
+		stream(name,sizeof(name));
+		if ( flags&SF_IN && (sch=schedule_find_byname(name))==NULL )
 		{
-			obj = obj->next;
-			free(data);
+			output_error("checkpoint uses schedule '%s', which is not defined", name);
+			throw "schedule mismatch";
 		}
-		else if ( flags&SF_IN ) 
-			object_stream_fixup(data,cname,oname);
+		stream(sch->value);
+		stream(sch->next_t);
+		stream(sch->since);
+		stream(sch->duration);
+		stream(sch->fraction);
+		if ( flags&SF_OUT ) sch = schedule_getnext(sch);
 	}
-	stream("/OBJ");
+	stream("/SCH");
 }
 
 // globals stream
@@ -491,29 +738,50 @@ void stream(GLOBALVAR *var)
 	size_t n;
 	for ( n=0 ; n<count ; n++ )
 	{
-		char name[64]; if ( var ) strcpy(name,var->prop->name);
+		char name[64] = "";
+		char value[1024] = "";
+		if ( flags&SF_OUT )
+		{
+			strncpy(name,var->prop->name,sizeof(name)-1);
+			global_getvar(name,value,sizeof(value));
+		}
 		stream(name,sizeof(name));
-
-		char value[1024]; if ( var ) global_getvar(name,value,sizeof(value));
 		stream(value,sizeof(value));
 
 		if ( flags&SF_OUT ) var = var->next;
-		if ( flags&SF_IN ) global_setvar(name,value);
+		if ( flags&SF_IN )
+		{
+			/* only the clock and public module variables are restored, the
+			   core settings are taken from the model and command line */
+			GLOBALVAR *item = global_find(name);
+			if ( item!=NULL && item->prop->access==PA_PUBLIC
+				&& ( strcmp(name,"clock")==0 || strstr(name,"::")!=NULL ) )
+				global_setvar(name,value);
+		}
 	}
 
 	stream("/VAR");
 }
 
-size_t stream(FILE *fileptr,int opts)
+/* stream all the sections of a checkpoint */
+static size_t stream_all(void)
 {
-	stream_pos = 0;
-	fp = fileptr;
-	flags = opts;
-	IN_MYCONTEXT output_debug("starting stream on file %d with options %x", fileno(fp), flags);
 	try {
 
 		// header
 		stream("GLD30");
+		stream(STREAM_NAME);
+		unsigned int version = STREAM_VERSION;
+		stream(version);
+		if ( version!=STREAM_VERSION )
+		{
+			output_error("checkpoint stream version %d is not supported (version %d is required)", version, STREAM_VERSION);
+			throw "version mismatch";
+		}
+		unsigned int header_size = sizeof(OBJECT);
+		stream(header_size);
+		if ( header_size!=sizeof(OBJECT) )
+			throw "object header mismatch";
 
 		// runtime classes
 		try { stream(class_get_first_runtime()); } catch (int) {};
@@ -524,6 +792,9 @@ size_t stream(FILE *fileptr,int opts)
 		// objects
 		try { stream(object_get_first()); } catch (int) {};
 
+		// schedules
+		try { stream(schedule_getnext(NULL)); } catch (int) {};
+
 		// globals
 		try { stream(global_getnext(NULL)); } catch (int) {};
 
@@ -533,7 +804,7 @@ size_t stream(FILE *fileptr,int opts)
 		{	
 			s->call((int)flags,(STREAMCALLBACK)stream_callback);
 		}
-		IN_MYCONTEXT output_debug("done processing stream on file %d with options %x", fileno(fp), flags);
+		IN_MYCONTEXT output_debug("done processing stream with options %x", flags);
 		return stream_pos;
 	}
 	catch (const char *msg)
@@ -548,6 +819,83 @@ size_t stream(FILE *fileptr,int opts)
 	}
 }
 
+size_t stream(FILE *fileptr,int opts)
+{
+	stream_pos = 0;
+	fp = fileptr;
+	flags = opts;
+	IN_MYCONTEXT output_debug("starting stream on file %d with options %x", fileno(fp), flags);
+	return stream_all();
+}
+
+/** Restore the simulation state from a checkpoint file
+
+	The checkpoint file is mapped into memory and the object data is copied
+	directly from the image onto the objects of the model, which must already 
+	be loaded and initialized.
+
+	@returns SUCCESS or FAILED
+ **/
+STATUS stream_restore(const char *filename)
+{
+	size_t len;
+#ifdef _DEBUG
+	fp = fopen(filename,"r");
+	if ( fp == NULL )
+	{
+		output_error("unable to open checkpoint file '%s' for reading: %s", filename, strerror(errno));
+		return FAILED;
+	}
+	len = stream(fp,SF_IN);
+	fclose(fp);
+	fp = NULL;
+#else
+	int fd = open(filename,O_RDONLY);
+	struct stat info;
+	if ( fd < 0 || fstat(fd,&info) < 0 )
+	{
+		output_error("unable to open checkpoint file '%s' for reading: %s", filename, strerror(errno));
+		/* TROUBLESHOOT
+		   The checkpoint file given to the --restore command line option could not be opened.
+		   Check that the file exists and is readable, and try again.
+		 */
+		if ( fd >= 0 ) close(fd);
+		return FAILED;
+	}
+	void *data = mmap(NULL,info.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+	close(fd);
+	if ( data == MAP_FAILED )
+	{
+		output_error("unable to map checkpoint file '%s': %s", filename, strerror(errno));
+		return FAILED;
+	}
+	map_data = (const char*)data;
+	map_size = info.st_size;
+	stream_pos = 0;
+	fp = NULL;
+	flags = SF_IN;
+	IN_MYCONTEXT output_debug("restoring %lld bytes from checkpoint file '%s'", (int64)map_size, filename);
+	len = stream_all();
+	munmap(data,map_size);
+	map_data = NULL;
+	map_size = 0;
+#endif
+	flags = 0x00;
+	if ( len == (size_t)-1 )
+	{
+		output_error("unable to restore checkpoint file '%s'", filename);
+		/* TROUBLESHOOT
+		   The checkpoint file could not be restored onto the model.  The checkpoint must be
+		   created by the same version of gridlabd using the same model.  The preceding messages
+		   explain which part of the checkpoint did not match.
+		 */
+		return FAILED;
+	}
+	char buffer[64];
+	IN_MYCONTEXT output_verbose("restored checkpoint '%s' at %s", filename, convert_from_timestamp(global_clock,buffer,sizeof(buffer)) ? buffer : "(invalid clock)");
+	return SUCCESS;
+}
+
 #define stream_type(T) extern "C" size_t stream_##T(void *ptr, size_t len, PROPERTY *prop) { return stream((T*)ptr,len); }
 #include "stream_type.h"
 #undef stream_type
@@ -38,6 +38,7 @@ typedef size_t (*STREAMCALLBACK)(void*,size_t,bool,void*);
 typedef size_t (*STREAMCALL)(int flags,STREAMCALLBACK call);
 void stream_register(STREAMCALL);
 size_t stream(FILE *fp, int flags);
+STATUS stream_restore(const char *filename);
 char* stream_context();
 #endif
 
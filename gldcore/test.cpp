@@ -21,6 +21,8 @@ static TESTLIST test_list[] = {
 	{"schedule",	schedule_test,		0, test_list+4},
 	{"loadshape",	loadshape_test,		0, test_list+5},
 	{"enduse",		enduse_test,		0, test_list+6},
+	{"arena",		object_arena_test,	0, test_list+7},
+	{"find",		find_index_test,	0, test_list+8},
 	{"lock",		test_lock,			0, NULL}, /* last test in list has no next */
 	/* add new core test routines before this line */
 }, *last_test = test_list+sizeof(test_list)/sizeof(test_list[0])-1;
@@ -9,6 +9,9 @@
 
 #include "gldcore.h"
 
+#include <atomic>
+#include <vector>
+
 static int mti_debug_mode = 0;
 int mti_debug(MTI *mti, const char *fmt, ...)
 {
@@ -298,3 +301,539 @@ int mti_run(MTIDATA result, MTI *mti, MTIDATA input)
 	mti->runtime += (clock_t)exec_clock() - t0;
 	return 1;
 }
+
+/*****************************************************************************
+ * Work-stealing task pool
+ *
+ * Each worker owns a deque expressed as a range [head,tail) of the item
+ * array, packed into a single 64-bit word so that the owner (taking from 
+ * the head) and thieves (taking from the tail) can both update it with a 
+ * single compare-and-swap.  A worker only ever replaces its own range after
+ * it is empty, so a range value can never be reused by an in-flight steal.
+ *****************************************************************************/
+
+#define TASKRANGE(head,tail) ((((uint64_t)(tail))<<32)|(uint64_t)(head))
+#define TASKHEAD(range) ((uint32_t)((range)&0xffffffff))
+#define TASKTAIL(range) ((uint32_t)((range)>>32))
+
+typedef struct s_taskworker {
+	TASKPOOL *pool;					/**< pool to which this worker belongs */
+	unsigned int id;				/**< worker number */
+	pthread_t thread_id;			/**< pthread handle (unused for worker 0) */
+	std::atomic<uint64_t> range;	/**< packed [head,tail) range of items owned */
+	size_t n_items;					/**< items processed during last run */
+	size_t n_steals;				/**< steals completed during last run */
+	double t_busy;					/**< busy time during last run */
+	int64 t_stop;					/**< tracer time at which the worker ran out of work */
+	char pad[64];					/**< keep workers on separate cache lines */
+} TASKWORKER;
+
+struct s_taskpool {
+	unsigned int n_workers;			/**< number of workers (including caller) */
+	TASKWORKER *worker;				/**< worker list */
+	pthread_mutex_t lock;			/**< start/stop lock */
+	pthread_cond_t start;			/**< start condition */
+	pthread_cond_t stop;			/**< stop condition */
+	unsigned int generation;		/**< run counter used as start condition */
+	unsigned int running;			/**< number of helpers still running */
+	bool shutdown;					/**< flag to terminate helpers */
+	void **items;					/**< item array of current run */
+	TASKGRAPH *graph;				/**< task graph of current run (NULL for item array) */
+	TASKCALL call;					/**< item call of current run */
+	void *arg;						/**< call argument of current run */
+};
+
+/*****************************************************************************
+ * Task graph
+ *
+ * Ready nodes are appended to a queue that has one slot per node, since
+ * each node becomes ready exactly once per run.  A worker claims the next
+ * slot and waits for it to be filled, which is guaranteed to happen because
+ * the graph is acyclic and the only nodes not yet queued are successors of
+ * nodes that are still being processed.  A worker whose slot is empty sleeps
+ * on the graph's fill condition, which is only signaled when a worker is
+ * waiting, so releasing a node costs no lock when every slot is filled in
+ * time.
+ *****************************************************************************/
+
+#define TASKNONE ((size_t)-1)
+
+struct s_taskgraph {
+	std::vector<void*> item;		/**< item of each node */
+	std::vector<size_t> from;		/**< edge sources */
+	std::vector<size_t> to;			/**< edge destinations */
+	std::vector<size_t> succ_index;	/**< start of each node's successors (compiled) */
+	std::vector<size_t> succ;		/**< successor list (compiled) */
+	std::vector<unsigned int> n_pred;/**< number of predecessors of each node (compiled) */
+	std::vector<size_t> root;		/**< nodes without predecessors (compiled) */
+	size_t depth;					/**< number of items on the longest path (compiled) */
+	bool compiled;					/**< flag indicating graph is compiled */
+	std::atomic<unsigned int> *pending; /**< predecessors not yet done in current run */
+	std::atomic<size_t> *ready;		/**< queue of ready nodes in current run */
+	std::atomic<size_t> n_ready;	/**< number of nodes queued in current run */
+	std::atomic<size_t> n_taken;	/**< number of queue slots claimed in current run */
+	std::atomic<unsigned int> n_waiting; /**< number of workers waiting for their slot */
+	pthread_mutex_t lock;			/**< fill lock */
+	pthread_cond_t filled;			/**< fill condition */
+};
+
+static double taskpool_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+/* take one item from the front of the worker's own range */
+static bool taskpool_pop(TASKWORKER *w, uint32_t *index)
+{
+	uint64_t range = w->range.load(std::memory_order_acquire);
+	while ( TASKHEAD(range) < TASKTAIL(range) )
+	{
+		if ( w->range.compare_exchange_weak(range,TASKRANGE(TASKHEAD(range)+1,TASKTAIL(range)),std::memory_order_acq_rel) )
+		{
+			*index = TASKHEAD(range);
+			return true;
+		}
+	}
+	return false;
+}
+
+/* take the back half of another worker's range */
+static bool taskpool_steal(TASKWORKER *w)
+{
+	TASKPOOL *pool = w->pool;
+	unsigned int n;
+	for ( n = 1 ; n < pool->n_workers ; n++ )
+	{
+		TASKWORKER *victim = &pool->worker[(w->id+n)%pool->n_workers];
+		uint64_t range = victim->range.load(std::memory_order_acquire);
+		while ( TASKHEAD(range) < TASKTAIL(range) )
+		{
+			uint32_t head = TASKHEAD(range), tail = TASKTAIL(range);
+			uint32_t take = (tail-head+1)/2;
+			if ( victim->range.compare_exchange_weak(range,TASKRANGE(head,tail-take),std::memory_order_acq_rel) )
+			{
+				w->range.store(TASKRANGE(tail-take,tail),std::memory_order_release);
+				w->n_steals++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static void taskpool_work(TASKWORKER *w)
+{
+	TASKPOOL *pool = w->pool;
+	double t0 = taskpool_now();
+	uint32_t index;
+	do {
+		while ( taskpool_pop(w,&index) )
+		{
+			pool->call(pool->arg,w->id,pool->items[index]);
+			w->n_items++;
+		}
+	} while ( taskpool_steal(w) );
+	w->t_busy = taskpool_now() - t0;
+	if ( trace_active )
+		w->t_stop = trace_now();
+}
+
+static void taskgraph_work(TASKWORKER *w)
+{
+	TASKPOOL *pool = w->pool;
+	TASKGRAPH *graph = pool->graph;
+	size_t n_nodes = graph->item.size();
+	double t0 = taskpool_now(), t_wait = 0;
+	while ( true )
+	{
+		size_t slot = graph->n_taken.fetch_add(1,std::memory_order_relaxed);
+		size_t node, n;
+		if ( slot >= n_nodes )
+			break;
+
+		/* wait for a predecessor still in progress to release the node */
+		node = graph->ready[slot].load(std::memory_order_acquire);
+		if ( node == TASKNONE )
+		{
+			double t1 = taskpool_now();
+			int64 t_trace = trace_active ? trace_now() : 0;
+			graph->n_waiting.fetch_add(1);
+			pthread_mutex_lock(&graph->lock);
+			while ( (node=graph->ready[slot].load()) == TASKNONE )
+				pthread_cond_wait(&graph->filled,&graph->lock);
+			pthread_mutex_unlock(&graph->lock);
+			graph->n_waiting.fetch_sub(1);
+			t_wait += taskpool_now() - t1;
+			if ( trace_active )
+				trace_span(w->id,"wait","dependency",t_trace,trace_now());
+		}
+
+		if ( graph->item[node] != NULL )
+		{
+			pool->call(pool->arg,w->id,graph->item[node]);
+			w->n_items++;
+		}
+
+		/* release successors that have no other predecessor pending */
+		bool released = false;
+		for ( n = graph->succ_index[node] ; n < graph->succ_index[node+1] ; n++ )
+		{
+			size_t next = graph->succ[n];
+			if ( graph->pending[next].fetch_sub(1,std::memory_order_acq_rel) == 1 )
+			{
+				graph->ready[graph->n_ready.fetch_add(1,std::memory_order_relaxed)].store(next);
+				released = true;
+			}
+		}
+
+		/* wake the workers waiting for their slot (the slot stores and the
+		   waiter count are sequentially consistent, so either the waiter
+		   sees its slot filled or this sees the waiter) */
+		if ( released && graph->n_waiting.load() > 0 )
+		{
+			pthread_mutex_lock(&graph->lock);
+			pthread_cond_broadcast(&graph->filled);
+			pthread_mutex_unlock(&graph->lock);
+		}
+	}
+	w->t_busy = taskpool_now() - t0 - t_wait;
+	if ( trace_active )
+		w->t_stop = trace_now();
+}
+
+static void *taskpool_proc(void *ptr)
+{
+	TASKWORKER *w = (TASKWORKER*)ptr;
+	TASKPOOL *pool = w->pool;
+	unsigned int generation = 0;
+	while ( true )
+	{
+		/* wait for the start condition */
+		pthread_mutex_lock(&pool->lock);
+		while ( pool->generation == generation && ! pool->shutdown )
+			pthread_cond_wait(&pool->start,&pool->lock);
+		generation = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+		if ( pool->shutdown )
+			break;
+
+		if ( pool->graph != NULL )
+			taskgraph_work(w);
+		else
+			taskpool_work(w);
+
+		/* signal the stop condition */
+		pthread_mutex_lock(&pool->lock);
+		if ( --pool->running == 0 )
+			pthread_cond_signal(&pool->stop);
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+TASKPOOL *taskpool_create(unsigned int n_threads)
+{
+	unsigned int n;
+	TASKPOOL *pool = new TASKPOOL;
+	if ( n_threads == 0 )
+		n_threads = 1;
+	pool->n_workers = n_threads;
+	pool->worker = new TASKWORKER[n_threads];
+	pthread_mutex_init(&pool->lock,NULL);
+	pthread_cond_init(&pool->start,NULL);
+	pthread_cond_init(&pool->stop,NULL);
+	pool->generation = 0;
+	pool->running = 0;
+	pool->shutdown = false;
+	pool->items = NULL;
+	pool->graph = NULL;
+	pool->call = NULL;
+	pool->arg = NULL;
+	for ( n = 0 ; n < n_threads ; n++ )
+	{
+		TASKWORKER *w = &pool->worker[n];
+		w->pool = pool;
+		w->id = n;
+		w->range.store(0);
+		w->n_items = w->n_steals = 0;
+		w->t_busy = 0;
+		w->t_stop = 0;
+		if ( n > 0 && pthread_create(&w->thread_id,NULL,taskpool_proc,w) != 0 )
+		{
+			output_error("taskpool_create(n_threads=%u): unable to start thread %u", n_threads, n);
+			/* TROUBLESHOOT
+			   The system refused to create a thread for the task pool.  The pool
+			   will use the threads that were created successfully.  Reduce the 
+			   value of the threadcount global variable and try again.
+			 */
+			pool->n_workers = n;
+			break;
+		}
+	}
+	return pool;
+}
+
+/* reset the worker counters before a run */
+static void taskpool_reset(TASKPOOL *pool)
+{
+	unsigned int n;
+	for ( n = 0 ; n < pool->n_workers ; n++ )
+	{
+		TASKWORKER *w = &pool->worker[n];
+		w->range.store(0,std::memory_order_relaxed);
+		w->n_items = w->n_steals = 0;
+		w->t_busy = 0;
+		w->t_stop = trace_active ? trace_now() : 0;
+	}
+}
+
+/* run the helpers and the caller (as worker 0) until all are done */
+static void taskpool_dispatch(TASKPOOL *pool, void (*work)(TASKWORKER*))
+{
+	/* start the helpers */
+	pthread_mutex_lock(&pool->lock);
+	pool->running = pool->n_workers - 1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	/* caller is worker 0 */
+	work(&pool->worker[0]);
+
+	/* wait for the helpers to finish */
+	pthread_mutex_lock(&pool->lock);
+	while ( pool->running > 0 )
+		pthread_cond_wait(&pool->stop,&pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/* collect the worker counters after a run */
+static void taskpool_getstats(TASKPOOL *pool, TASKSTATS *stats, double t0)
+{
+	unsigned int n;
+
+	/* trace the time each worker waited for the others to finish */
+	if ( trace_active && pool->n_workers > 1 )
+	{
+		int64 t_done = trace_now();
+		for ( n = 0 ; n < pool->n_workers ; n++ )
+			trace_span(n,"wait","barrier",pool->worker[n].t_stop,t_done);
+	}
+	if ( stats == NULL )
+		return;
+	memset(stats,0,sizeof(TASKSTATS));
+	stats->n_runs = 1;
+	for ( n = 0 ; n < pool->n_workers ; n++ )
+	{
+		TASKWORKER *w = &pool->worker[n];
+		stats->n_items += w->n_items;
+		stats->n_steals += w->n_steals;
+		stats->t_busy_mean += w->t_busy;
+		if ( w->t_busy > stats->t_busy_max )
+			stats->t_busy_max = w->t_busy;
+	}
+	stats->t_busy_mean /= pool->n_workers;
+	stats->t_elapsed = taskpool_now() - t0;
+}
+
+void taskpool_run(TASKPOOL *pool, void **items, size_t n_items, TASKCALL call, void *arg, TASKSTATS *stats)
+{
+	unsigned int n;
+	double t0 = taskpool_now();
+	if ( n_items >= 0xffffffff )
+		throw_exception("taskpool_run(n_items=%lu): too many items", (unsigned long)n_items);
+
+	pool->items = items;
+	pool->graph = NULL;
+	pool->call = call;
+	pool->arg = arg;
+	taskpool_reset(pool);
+
+	/* single item or single thread is done by caller alone */
+	if ( n_items < 2 || pool->n_workers < 2 )
+	{
+		pool->worker[0].range.store(TASKRANGE(0,n_items),std::memory_order_relaxed);
+		taskpool_work(&pool->worker[0]);
+	}
+	else
+	{
+		/* initial distribution is contiguous ranges of equal size */
+		for ( n = 0 ; n < pool->n_workers ; n++ )
+			pool->worker[n].range.store(TASKRANGE(n_items*n/pool->n_workers,n_items*(n+1)/pool->n_workers),std::memory_order_relaxed);
+		taskpool_dispatch(pool,taskpool_work);
+	}
+	taskpool_getstats(pool,stats,t0);
+}
+
+TASKGRAPH *taskgraph_create(void)
+{
+	TASKGRAPH *graph = new TASKGRAPH;
+	graph->depth = 0;
+	graph->compiled = false;
+	graph->pending = NULL;
+	graph->ready = NULL;
+	graph->n_waiting.store(0);
+	pthread_mutex_init(&graph->lock,NULL);
+	pthread_cond_init(&graph->filled,NULL);
+	return graph;
+}
+
+size_t taskgraph_add_node(TASKGRAPH *graph, void *item)
+{
+	graph->compiled = false;
+	graph->item.push_back(item);
+	return graph->item.size()-1;
+}
+
+void taskgraph_add_edge(TASKGRAPH *graph, size_t from, size_t to)
+{
+	if ( from >= graph->item.size() || to >= graph->item.size() )
+		throw_exception("taskgraph_add_edge(from=%lu, to=%lu): node not found", (unsigned long)from, (unsigned long)to);
+	graph->compiled = false;
+	graph->from.push_back(from);
+	graph->to.push_back(to);
+}
+
+bool taskgraph_compile(TASKGRAPH *graph)
+{
+	size_t n_nodes = graph->item.size(), n_edges = graph->from.size();
+	size_t n, m, n_done;
+	std::vector<size_t> fill, order, level;
+
+	/* build the successor lists */
+	graph->succ_index.assign(n_nodes+1,0);
+	graph->n_pred.assign(n_nodes,0);
+	for ( n = 0 ; n < n_edges ; n++ )
+	{
+		graph->succ_index[graph->from[n]+1]++;
+		graph->n_pred[graph->to[n]]++;
+	}
+	for ( n = 0 ; n < n_nodes ; n++ )
+		graph->succ_index[n+1] += graph->succ_index[n];
+	graph->succ.resize(n_edges);
+	fill.assign(graph->succ_index.begin(),graph->succ_index.end()-1);
+	for ( n = 0 ; n < n_edges ; n++ )
+		graph->succ[fill[graph->from[n]]++] = graph->to[n];
+
+	/* topological sort to check for cycles and find the depth */
+	graph->root.clear();
+	for ( n = 0 ; n < n_nodes ; n++ )
+	{
+		if ( graph->n_pred[n] == 0 )
+			graph->root.push_back(n);
+	}
+	std::vector<unsigned int> count(graph->n_pred);
+	order = graph->root;
+	level.assign(n_nodes,0);
+	for ( n = 0 ; n < order.size() ; n++ )
+		level[order[n]] = ( graph->item[order[n]] != NULL );
+	graph->depth = 0;
+	for ( n_done = 0 ; n_done < order.size() ; n_done++ )
+	{
+		size_t node = order[n_done];
+		if ( level[node] > graph->depth )
+			graph->depth = level[node];
+		for ( m = graph->succ_index[node] ; m < graph->succ_index[node+1] ; m++ )
+		{
+			size_t next = graph->succ[m];
+			size_t depth = level[node] + ( graph->item[next] != NULL );
+			if ( depth > level[next] )
+				level[next] = depth;
+			if ( --count[next] == 0 )
+				order.push_back(next);
+		}
+	}
+	if ( n_done < n_nodes )
+		return false;
+
+	delete [] graph->pending;
+	delete [] graph->ready;
+	graph->pending = new std::atomic<unsigned int>[n_nodes];
+	graph->ready = new std::atomic<size_t>[n_nodes];
+	graph->compiled = true;
+	return true;
+}
+
+size_t taskgraph_get_depth(TASKGRAPH *graph)
+{
+	return graph->compiled ? graph->depth : 0;
+}
+
+void taskpool_rungraph(TASKPOOL *pool, TASKGRAPH *graph, TASKCALL call, void *arg, TASKSTATS *stats)
+{
+	size_t n, n_nodes = graph->item.size();
+	double t0 = taskpool_now();
+	if ( ! graph->compiled && ! taskgraph_compile(graph) )
+		throw_exception("taskpool_rungraph(): task graph has a cycle");
+
+	/* reset the pending counts and queue the roots */
+	for ( n = 0 ; n < n_nodes ; n++ )
+	{
+		graph->pending[n].store(graph->n_pred[n],std::memory_order_relaxed);
+		graph->ready[n].store(TASKNONE,std::memory_order_relaxed);
+	}
+	for ( n = 0 ; n < graph->root.size() ; n++ )
+		graph->ready[n].store(graph->root[n],std::memory_order_relaxed);
+	graph->n_ready.store(graph->root.size(),std::memory_order_relaxed);
+	graph->n_taken.store(0,std::memory_order_relaxed);
+
+	pool->items = NULL;
+	pool->graph = graph;
+	pool->call = call;
+	pool->arg = arg;
+	taskpool_reset(pool);
+
+	/* single node or single thread is done by caller alone */
+	if ( n_nodes < 2 || pool->n_workers < 2 )
+		taskgraph_work(&pool->worker[0]);
+	else
+		taskpool_dispatch(pool,taskgraph_work);
+	pool->graph = NULL;
+	taskpool_getstats(pool,stats,t0);
+}
+
+void taskgraph_destroy(TASKGRAPH *graph)
+{
+	if ( graph == NULL )
+		return;
+	delete [] graph->pending;
+	delete [] graph->ready;
+	pthread_mutex_destroy(&graph->lock);
+	pthread_cond_destroy(&graph->filled);
+	delete graph;
+}
+
+unsigned int taskpool_get_threadcount(TASKPOOL *pool)
+{
+	return pool ? pool->n_workers : 1;
+}
+
+void taskpool_addstats(TASKSTATS *to, const TASKSTATS *from)
+{
+	to->n_runs += from->n_runs;
+	to->n_items += from->n_items;
+	to->n_steals += from->n_steals;
+	to->t_elapsed += from->t_elapsed;
+	to->t_busy_max += from->t_busy_max;
+	to->t_busy_mean += from->t_busy_mean;
+}
+
+void taskpool_destroy(TASKPOOL *pool)
+{
+	unsigned int n;
+	if ( pool == NULL )
+		return;
+	pthread_mutex_lock(&pool->lock);
+	pool->shutdown = true;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	for ( n = 1 ; n < pool->n_workers ; n++ )
+		pthread_join(pool->worker[n].thread_id,NULL);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->stop);
+	delete [] pool->worker;
+	delete pool;
+}
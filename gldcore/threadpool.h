@@ -156,5 +156,130 @@ int mti_run(MTIDATA result,   /**< result of iterator */
 
 int processor_count(void);
 
+/** @addtogroup taskpool Work-stealing task pool
+    @ingroup mti
+
+A task pool is a persistent set of worker threads that repeatedly
+processes arrays of items.  Unlike an MTI, the pool is created once and 
+reused for every call to #taskpool_run(), regardless of which array
+is being processed.
+
+Each call to #taskpool_run() initially divides the item array into 
+contiguous ranges, one per worker.  Each worker processes its own range
+from the front and, when it runs out of work, steals the back half of the 
+range of another worker.  The calling thread always participates as 
+worker 0, so a pool of N threads creates only N-1 helper threads.
+
+The per-call statistics in #TASKSTATS can be accumulated with 
+#taskpool_addstats() to report load imbalance and stealing activity.
+
+@{**/
+
+/** Task pool handle **/
+typedef struct s_taskpool TASKPOOL;
+
+/** Task call function prototype
+    The call receives the argument given to #taskpool_run(), the worker
+    number (0 to N-1) and the item to process.
+ **/
+typedef void (*TASKCALL)(void *arg, unsigned int thread, void *item);
+
+/** Task pool run statistics **/
+typedef struct s_taskstats {
+	unsigned int n_runs;	/**< number of runs */
+	size_t n_items;			/**< number of items processed */
+	size_t n_steals;		/**< number of successful steals */
+	double t_elapsed;		/**< elapsed wall time (seconds) */
+	double t_busy_max;		/**< busy time of the busiest worker (seconds) */
+	double t_busy_mean;		/**< mean busy time of all workers (seconds) */
+} TASKSTATS;
+
+/** Create a task pool
+
+    @returns Pointer to the task pool or NULL if failed.
+ **/
+TASKPOOL *taskpool_create(unsigned int n_threads); /**< number of threads (including caller) */
+
+/** Run a task pool over an array of items
+
+	The call returns only when all the items have been processed.
+ **/
+void taskpool_run(TASKPOOL *pool,	/**< pointer returned by taskpool_create */
+				  void **items,		/**< array of items to process */
+				  size_t n_items,	/**< number of items in array */
+				  TASKCALL call,	/**< function to call for each item */
+				  void *arg,		/**< first argument to call */
+				  TASKSTATS *stats);/**< run statistics (may be NULL) */
+
+/** Get the number of threads in a task pool **/
+unsigned int taskpool_get_threadcount(TASKPOOL *pool);
+
+/** Accumulate task pool run statistics **/
+void taskpool_addstats(TASKSTATS *to, const TASKSTATS *from);
+
+/** Destroy a task pool **/
+void taskpool_destroy(TASKPOOL *pool);
+
+/**@}*/
+
+/** @addtogroup taskgraph Task dependency graph
+    @ingroup taskpool
+
+A task graph is a directed acyclic graph of items in which an edge 
+from one node to another means that the first must be processed before
+the second.  When a task graph is run using #taskpool_rungraph(), each node
+is released to the pool as soon as all of its predecessors are done, so
+that independent chains of work proceed without waiting for each other.
+
+Nodes with a NULL item are gates that only join edges; they are not
+passed to the task call.
+
+The graph is compiled by #taskgraph_compile() after all the nodes and 
+edges have been added and can then be run any number of times.
+
+@{**/
+
+/** Task graph handle **/
+typedef struct s_taskgraph TASKGRAPH;
+
+/** Create an empty task graph
+	@returns Pointer to the task graph
+ **/
+TASKGRAPH *taskgraph_create(void);
+
+/** Add a node to a task graph
+	@returns the node number
+ **/
+size_t taskgraph_add_node(TASKGRAPH *graph,	/**< task graph */
+						  void *item);		/**< item to process (NULL for a gate) */
+
+/** Add an edge to a task graph **/
+void taskgraph_add_edge(TASKGRAPH *graph,	/**< task graph */
+						size_t from,		/**< node that must be done first */
+						size_t to);			/**< node that must wait */
+
+/** Compile a task graph
+	@returns true on success, false if the graph has a cycle
+ **/
+bool taskgraph_compile(TASKGRAPH *graph);
+
+/** Get the number of items (excluding gates) on the longest path through a compiled task graph **/
+size_t taskgraph_get_depth(TASKGRAPH *graph);
+
+/** Run a task pool over a compiled task graph
+
+	The call returns only when all the nodes have been processed.
+ **/
+void taskpool_rungraph(TASKPOOL *pool,		/**< pointer returned by taskpool_create */
+					   TASKGRAPH *graph,	/**< compiled task graph */
+					   TASKCALL call,		/**< function to call for each item */
+					   void *arg,			/**< first argument to call */
+					   TASKSTATS *stats);	/**< run statistics (may be NULL) */
+
+/** Destroy a task graph **/
+void taskgraph_destroy(TASKGRAPH *graph);
+
+/**@}*/
+
 #endif /**@} _THREADPOOL_H */
 
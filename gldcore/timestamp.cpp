@@ -46,6 +46,10 @@ typedef struct{
 } SPEC; /**< the specification of a DST event */
 
 static int daysinmonth[] = {31,28,31,30,31,30,31,31,30,31,30,31};
+static const unsigned short monthstart[2][13] = { /* day of year of the first of each month (normal and leap years) */
+	{0,31,59,90,120,151,181,212,243,273,304,334,365},
+	{0,31,60,91,121,152,182,213,244,274,305,335,366},
+};
 static const char *dow[] = {"Sun","Mon","Tue","Wed","Thu","Fri","Sat"};
 
 #define YEAR0 (1970) /* basis year is 1970 */
@@ -55,6 +59,8 @@ static const char *dow[] = {"Sun","Mon","Tue","Wed","Thu","Fri","Sat"};
 static int tzvalid=0;
 static TIMESTAMP tszero[1000] = {-1}; /* zero timestamp offset for each year */
 static TIMESTAMP dststart[1000], dstend[1000];
+static bool dstspans[1000]; /* DST ends in the year after it starts (e.g., southern hemisphere) */
+static unsigned int tzgeneration = 0; /* changes each time the timezone rules are loaded */
 static TIMESTAMP tzoffset;
 static char current_tzname[64], tzstd[32], tzdst[32];
 
@@ -73,11 +79,7 @@ const char *timestamp_current_timezone(void ) {
  **/
 int timestamp_year(TIMESTAMP ts, TIMESTAMP *remainder)
 {
-#ifdef USE_TS_CACHE
-	static int year = 0; /* reuse last result */
-#else
 	unsigned int year = (unsigned int)(ts/86400/365.24); /* estimate the year */
-#endif
 
 	if (tszero[0] == -1 ) {	/* need to initialize tszero array */
 		TIMESTAMP ts = 0;
@@ -118,17 +120,13 @@ int timestamp_year(TIMESTAMP ts, TIMESTAMP *remainder)
  **/
 int isdst(TIMESTAMP t)
 {
-	int DSTstart_year, DSTend_year;
 	int year = timestamp_year(t + tzoffset, NULL) - YEAR0;
 
 	//Preliminary check to make sure something exists
 	if (dststart[year]>=0)	//If it's -1, no sense going forth
 	{
-		DSTstart_year = timestamp_year(dststart[year],NULL);
-		DSTend_year = timestamp_year(dstend[year],NULL);
-
 		//Southern hemisphere DST-oriented check
-		if (DSTstart_year != DSTend_year)
+		if (dstspans[year])
 		{
 			//See if we're in the "late-year" DST region
 			if (dststart[year] <= t)
@@ -178,36 +176,25 @@ int isdst(TIMESTAMP t)
  **/
 int local_tzoffset(TIMESTAMP t)
 {
-#ifdef USE_TS_CACHE
-	static old_t = 0;
-	static old_tzoffset = 0;
-	if (old_t==0 || old_t!=t)
-	{
-		old_tzoffset = tzoffset + isdst(t)?3600:0;
-		old_t = t;
-	}
-	return old_tzoffset;
-#else
 	return (int)(tzoffset + (isdst(t)?3600:0));
-#endif
 }
 
+/* the last local time converted by each thread, which is reused while the
+   time does not change (e.g., by all the schedules read in a timestep) */
+static thread_local struct {
+	TIMESTAMP ts;
+	unsigned int generation;
+	DATETIME dt;
+} last_datetime = {TS_NEVER};
+
 /** Converts a GMT timestamp to local datetime struct
 	Adjusts to TZ if possible
  **/
 int local_datetime(TIMESTAMP ts, DATETIME *dt)
 {
-
-	int64 n;
 	TIMESTAMP rem = 0;
 	TIMESTAMP local;
-	int tsyear;
-
-#ifdef USE_TS_CACHE
-	/* allow caching */
-	static TIMESTAMP old_ts =0;
-	static DATETIME old_dt;
-#endif
+	int tsyear, dst;
 
 	if( ts == TS_NEVER || ts==TS_ZERO )
 		return 0;
@@ -217,15 +204,16 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 		output_error("local_datetime(ts=%lli,...): invalid local_datetime request",ts);
 		return 0;
 	}
-#ifdef USE_TS_CACHE
+
 	/* check cache */
-	if (old_ts == ts && old_ts!=0)
-		memcpy(dt,&old_dt,sizeof(DATETIME));
-	else
-		old_ts = 0;
-#endif
+	if ( last_datetime.ts == ts && last_datetime.generation == tzgeneration )
+	{
+		memcpy(dt,&last_datetime.dt,sizeof(DATETIME));
+		return 1;
+	}
 
-	local = LOCALTIME(ts);
+	dst = isdst(ts);
+	local = ts - tzoffset + (dst?3600:0);
 	tsyear = timestamp_year(local, &rem);
 
 	if (rem < 0)
@@ -242,19 +230,11 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 		return 0;
 	}
 
-	if ( ts < TS_ZERO && ts > TS_MAX ) { /* timestamp out of range */
-		return 0;
-	}
-	
-	if ( ts == TS_NEVER ) {
-		return 0;
-	}
-
 	/* ts is valid */
 	dt->timestamp = ts;
 
 	/* DST? */
-	dt->is_dst = (tzvalid && isdst(ts));
+	dt->is_dst = (tzvalid && dst);
 
 	/* compute year */
 	dt->year = tsyear;
@@ -263,33 +243,13 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 	dt->yearday = (unsigned short)(rem / DAY);
 	dt->weekday = (unsigned short)((local / DAY + DOW0 + 7) % 7);
 
-	/* compute month */
+	/* compute month and day */
+	const unsigned short *start = monthstart[ISLEAPYEAR(dt->year)?1:0];
 	dt->month = 0;
-	n = daysinmonth[0] * DAY;
-	while(rem >= n ) {
-		rem -= n; /* subtract n ticks from ts */
-		dt->month++; /* add to month */
-		if ( dt->month == 12 ) {
-			dt->month = 0;
-			++dt->year;
-		}
-		n = (daysinmonth[dt->month] + ((dt->month == 1 && ISLEAPYEAR(dt->year)) ? 1:0)) * 86400 * TS_SECOND;
-		if ( n < 86400 * 28 ) { /**/
-			output_fatal("Breaking an infinite loop in local_datetime! (ts = %" FMT_INT64 "ds", ts);
-			/*	TROUBLESHOOT
-				An internal protection against infinite loops in the time calculation
-				module has encountered a critical problem.  This is often caused by
-				an incorrectly initialized timezone system, a missing timezone specification before
-				a timestamp was used, or a missing timezone localization in your system.
-				Correct the timezone problem and try again.
-			 */
-			return 0;
-		}
-	}
+	while ( dt->month < 11 && dt->yearday >= start[dt->month+1] )
+		dt->month++;
+	dt->day = (unsigned short)(dt->yearday - start[dt->month] + 1);
 	dt->month++; /* Jan=1 */
-
-	/* compute day */
-	dt->day = (unsigned short)(rem / DAY + 1);
 	rem %= DAY;
 
 	/* compute hour */
@@ -311,13 +271,12 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 	strncpy(dt->tz, tzvalid ? (dt->is_dst ? tzdst : tzstd) : "GMT", sizeof(dt->tz));
 
 	/* timezone offset in seconds */
-	dt->tzoffset = (int)(tzoffset - (isdst(dt->timestamp)?3600:0));
+	dt->tzoffset = (int)(tzoffset - (dst?3600:0));
 
-#ifdef USE_TS_CACHE
 	/* cache result */
-	old_ts = ts;
-	memcpy(&old_dt,dt,sizeof(old_dt));
-#endif
+	last_datetime.ts = ts;
+	last_datetime.generation = tzgeneration;
+	memcpy(&last_datetime.dt,dt,sizeof(DATETIME));
 	return 1;
 }
 
@@ -334,12 +293,6 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 	TIMESTAMP local;
 	int tsyear;
 
-#ifdef USE_TS_CACHE
-	/* allow caching */
-	static TIMESTAMP old_ts =0;
-	static DATETIME old_dt;
-#endif
-
 	/*Get the cast version*/
 	ts = (TIMESTAMP)tsdbl;
 
@@ -351,14 +304,6 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 		output_error("local_datetime_delta(ts=%lli,...): invalid local_datetime request",ts);
 		return 0;
 	}
-#ifdef USE_TS_CACHE
-	/* check cache */
-	if (old_ts == ts && old_ts!=0)
-		memcpy(dt,&old_dt,sizeof(DATETIME));
-	else
-		old_ts = 0;
-#endif
-
 	local = LOCALTIME(ts);
 	tsyear = timestamp_year(local, &rem);
 
@@ -447,11 +392,6 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 	/* timezone offset in seconds */
 	dt->tzoffset = (int)(tzoffset - (isdst(dt->timestamp)?3600:0));
 
-#ifdef USE_TS_CACHE
-	/* cache result */
-	old_ts = ts;
-	memcpy(&old_dt,dt,sizeof(old_dt));
-#endif
 	return 1;
 }
 
@@ -862,15 +802,20 @@ void set_tzspec(int year, const char *tzname, SPEC *pStart, SPEC *pEnd )
 			{
 				dststart[y] = compute_dstevent(y + YEAR0, pStart, tzoffset);
 				dstend[y] = compute_dstevent(y + YEAR0 + 1, pEnd, tzoffset) - 1;
+				dstspans[y] = true;
 			}
 			else	//"Standard" northern hemisphere rules
 			{
 				dststart[y] = compute_dstevent(y + YEAR0, pStart, tzoffset);
 				dstend[y] = compute_dstevent(y + YEAR0, pEnd, tzoffset) - 1;
+				dstspans[y] = false;
 			}
 		}
 		else
+		{
 			dststart[y] = dstend[y] = -1;
+			dstspans[y] = false;
+		}
 	}
 }
 
@@ -924,6 +869,7 @@ void load_tzspecs(const char *tz )
 	// zero previous DST start/end times
 	for (y = 0; y < sizeof(tszero) / sizeof(tszero[0]); y++ ) {
 		dststart[y] = dstend[y] = -1;
+		dstspans[y] = false;
 	}
 
 	while(fgets(buffer,sizeof(buffer),fp) ) {
@@ -997,6 +943,7 @@ void load_tzspecs(const char *tz )
 
 	fclose(fp);
 	tzvalid = 1;
+	tzgeneration++;
 }
 
 /** Establish the default timezone for time conversion.
@@ -0,0 +1,370 @@
+/* File: trace.cpp
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file trace.cpp
+	@addtogroup trace
+ @{
+ **/
+
+#include "gldcore.h"
+#include <vector>
+
+SET_MYCONTEXT(DMC_EXEC)
+
+/* pass names indexed by pass number */
+static const char *passname[] = {"presync","sync","postsync"};
+#define TRACE_PASSES (sizeof(passname)/sizeof(passname[0]))
+
+/* class spans closer than this are merged (ns) */
+#define TRACE_MERGEGAP 2000
+
+typedef struct s_traceevent {
+	const char *name;		/**< span name */
+	const char *category;	/**< span category */
+	int64 start;			/**< start time (ns) */
+	int64 stop;				/**< stop time (ns) */
+	int64 arg;				/**< rank, object id, or timestamp (-1 for none) */
+} TRACEEVENT;
+
+typedef struct s_tracethread {
+	std::vector<TRACEEVENT> *events;	/**< recorded spans */
+	size_t n_dropped;		/**< spans not recorded because the buffer is full */
+	CLASS *oclass;			/**< class of the pending class span */
+	unsigned int pass;		/**< pass of the pending class span */
+	int64 start;			/**< start of the pending class span */
+	int64 stop;				/**< stop of the pending class span */
+	int64 count;			/**< number of syncs in the pending class span */
+	int64 *histogram;		/**< sync latency histogram by class, pass and bucket */
+	char pad[64];			/**< keep threads on separate cache lines */
+} TRACETHREAD;
+
+bool trace_active = false;
+static bool trace_spans = false;
+static unsigned int n_threads = 0;
+static TRACETHREAD *thread_list = NULL;
+static size_t n_classes = 0;
+static int64 t_origin = 0;
+
+int64 trace_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return (int64)ts.tv_sec*1000000000 + ts.tv_nsec;
+}
+
+const char *trace_passname(unsigned int pass)
+{
+	return pass < TRACE_PASSES ? passname[pass] : "unknown";
+}
+
+STATUS trace_init(unsigned int threads)
+{
+	if ( trace_active || ( ! global_profiler && strcmp(global_profiler_trace,"")==0 ) )
+	{
+		return SUCCESS;
+	}
+	if ( threads == 0 )
+	{
+		threads = 1;
+	}
+	CLASS *oclass;
+	n_classes = 0;
+	for ( oclass = class_get_first_class() ; oclass != NULL ; oclass = oclass->next )
+	{
+		if ( (size_t)oclass->id >= n_classes )
+		{
+			n_classes = oclass->id + 1;
+		}
+	}
+	thread_list = new TRACETHREAD[threads];
+	for ( n_threads = 0 ; n_threads < threads ; n_threads++ )
+	{
+		TRACETHREAD *t = &thread_list[n_threads];
+		t->events = new std::vector<TRACEEVENT>;
+		t->n_dropped = 0;
+		t->oclass = NULL;
+		t->pass = 0;
+		t->start = t->stop = t->count = 0;
+		t->histogram = new int64[n_classes*TRACE_PASSES*TRACE_BUCKETS];
+		memset(t->histogram,0,sizeof(int64)*n_classes*TRACE_PASSES*TRACE_BUCKETS);
+	}
+	t_origin = trace_now();
+	trace_spans = ( strcmp(global_profiler_trace,"") != 0 );
+	trace_active = true;
+	IN_MYCONTEXT output_verbose("sync tracer started for %d thread(s)%s", n_threads, trace_spans ? "" : " (histograms only)");
+	return SUCCESS;
+}
+
+static inline void trace_push(TRACETHREAD *t, const char *name, const char *category, int64 start, int64 stop, int64 arg)
+{
+	if ( t->events->size() < TRACE_MAXEVENTS )
+	{
+		TRACEEVENT event = {name,category,start,stop,arg};
+		t->events->push_back(event);
+	}
+	else
+	{
+		t->n_dropped++;
+	}
+}
+
+/* record the pending class span of a thread */
+static inline void trace_flush_class(TRACETHREAD *t)
+{
+	if ( t->oclass != NULL )
+	{
+		trace_push(t,t->oclass->name,passname[t->pass],t->start,t->stop,t->count);
+		t->oclass = NULL;
+	}
+}
+
+void trace_span(unsigned int thread, const char *name, const char *category, int64 start, int64 stop, int64 arg)
+{
+	if ( ! trace_spans || thread >= n_threads )
+	{
+		return;
+	}
+	TRACETHREAD *t = &thread_list[thread];
+	trace_flush_class(t);
+	trace_push(t,name,category,start,stop,arg);
+}
+
+void trace_object(unsigned int thread, OBJECT *obj, unsigned int pass, int64 start, int64 stop)
+{
+	if ( thread >= n_threads || pass >= TRACE_PASSES )
+	{
+		return;
+	}
+	TRACETHREAD *t = &thread_list[thread];
+
+	/* latency histogram */
+	int64 dt = stop - start;
+	unsigned int bucket = dt > 0 ? 64 - __builtin_clzll((unsigned long long)dt) : 0;
+	if ( bucket >= TRACE_BUCKETS )
+	{
+		bucket = TRACE_BUCKETS - 1;
+	}
+	if ( (size_t)obj->oclass->id < n_classes )
+	{
+		t->histogram[((size_t)obj->oclass->id*TRACE_PASSES+pass)*TRACE_BUCKETS+bucket]++;
+	}
+	if ( ! trace_spans )
+	{
+		return;
+	}
+
+	/* class span */
+	if ( t->oclass == obj->oclass && t->pass == pass && start - t->stop < TRACE_MERGEGAP )
+	{
+		t->stop = stop;
+		t->count++;
+	}
+	else
+	{
+		trace_flush_class(t);
+		t->oclass = obj->oclass;
+		t->pass = pass;
+		t->start = start;
+		t->stop = stop;
+		t->count = 1;
+	}
+
+	/* sampled object span */
+	if ( global_profiler_trace_sample > 0 && obj->id % global_profiler_trace_sample == 0 )
+	{
+		trace_push(t,obj->oclass->name,"object",start,stop,obj->id);
+	}
+}
+
+/* merge the histograms of all threads for a class and pass */
+static int64 trace_histogram(CLASS *oclass, unsigned int pass, int64 *bucket)
+{
+	int64 total = 0;
+	unsigned int n, b;
+	memset(bucket,0,sizeof(int64)*TRACE_BUCKETS);
+	for ( n = 0 ; n < n_threads ; n++ )
+	{
+		int64 *h = thread_list[n].histogram + ((size_t)oclass->id*TRACE_PASSES+pass)*TRACE_BUCKETS;
+		for ( b = 0 ; b < TRACE_BUCKETS ; b++ )
+		{
+			bucket[b] += h[b];
+			total += h[b];
+		}
+	}
+	return total;
+}
+
+/* upper bound of the bucket that holds the given fraction of the syncs (in us) */
+static double trace_percentile(int64 *bucket, int64 total, double fraction)
+{
+	int64 sum = 0;
+	unsigned int b;
+	for ( b = 0 ; b < TRACE_BUCKETS ; b++ )
+	{
+		sum += bucket[b];
+		if ( sum >= fraction*total )
+		{
+			break;
+		}
+	}
+	return (double)((int64)1<<(b<TRACE_BUCKETS?b:TRACE_BUCKETS-1))/1000.0;
+}
+
+void trace_profile(void)
+{
+	if ( ! trace_active )
+	{
+		return;
+	}
+	output_profile("\nSync latency by class (us)");
+	output_profile("==========================\n");
+	output_profile("%-24s %-8s %10s %8s %8s %8s %8s", "Class", "Pass", "Syncs", "p50", "p90", "p99", "max");
+	output_profile("%-24s %-8s %10s %8s %8s %8s %8s", "------------------------", "--------", "----------", "--------", "--------", "--------", "--------");
+	CLASS *oclass;
+	for ( oclass = class_get_first_class() ; oclass != NULL ; oclass = oclass->next )
+	{
+		unsigned int pass;
+		if ( (size_t)oclass->id >= n_classes )
+		{
+			continue;
+		}
+		for ( pass = 0 ; pass < TRACE_PASSES ; pass++ )
+		{
+			int64 bucket[TRACE_BUCKETS];
+			int64 total = trace_histogram(oclass,pass,bucket);
+			if ( total == 0 )
+			{
+				continue;
+			}
+			output_profile("%-24.24s %-8s %10" FMT_INT64 "d %8.1f %8.1f %8.1f %8.1f",
+				oclass->name, passname[pass], total,
+				trace_percentile(bucket,total,0.50),
+				trace_percentile(bucket,total,0.90),
+				trace_percentile(bucket,total,0.99),
+				trace_percentile(bucket,total,1.00));
+		}
+	}
+}
+
+/* write a JSON string */
+static void trace_write_string(FILE *fp, const char *str)
+{
+	fputc('"',fp);
+	for ( ; *str != '\0' ; str++ )
+	{
+		if ( *str == '"' || *str == '\\' )
+		{
+			fputc('\\',fp);
+		}
+		fputc(*str,fp);
+	}
+	fputc('"',fp);
+}
+
+STATUS trace_save(const char *filename)
+{
+	if ( ! trace_active )
+	{
+		return SUCCESS;
+	}
+	trace_active = false;
+	if ( ! trace_spans )
+	{
+		return SUCCESS;
+	}
+	FILE *fp = fopen(filename,"w");
+	if ( fp == NULL )
+	{
+		output_error("unable to open trace file '%s' for writing: %s", filename, strerror(errno));
+		/* TROUBLESHOOT
+			The file named by the profiler_trace global variable could not be
+			opened.  Check that the directory exists and is writable and try again.
+		 */
+		return FAILED;
+	}
+	unsigned int n;
+	size_t n_events = 0, n_dropped = 0;
+	fprintf(fp,"{\"traceEvents\":[\n");
+	for ( n = 0 ; n < n_threads ; n++ )
+	{
+		fprintf(fp,"%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+			n>0?",\n":"", n, n>0?"worker":"main", n);
+	}
+	for ( n = 0 ; n < n_threads ; n++ )
+	{
+		TRACETHREAD *t = &thread_list[n];
+		trace_flush_class(t);
+		for ( std::vector<TRACEEVENT>::iterator event = t->events->begin() ; event != t->events->end() ; event++ )
+		{
+			fprintf(fp,",\n{\"name\":");
+			if ( strcmp(event->category,"object") == 0 )
+			{
+				char name[64];
+				OBJECT *obj = object_find_by_id((OBJECTNUM)event->arg);
+				trace_write_string(fp,obj!=NULL?object_name(obj,name,sizeof(name)):event->name);
+			}
+			else
+			{
+				trace_write_string(fp,event->name);
+			}
+			fprintf(fp,",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+				event->category, n, (event->start-t_origin)/1000.0, (event->stop-event->start)/1000.0);
+			if ( event->arg >= 0 )
+			{
+				const char *argname = "count";
+				if ( strcmp(event->category,"rank") == 0 ) argname = "rank";
+				else if ( strcmp(event->category,"object") == 0 ) argname = "id";
+				else if ( strcmp(event->category,"clock") == 0 ) argname = "timestamp";
+				fprintf(fp,",\"args\":{\"%s\":%" FMT_INT64 "d}", argname, event->arg);
+			}
+			fprintf(fp,"}");
+		}
+		n_events += t->events->size();
+		n_dropped += t->n_dropped;
+	}
+	fprintf(fp,"\n],\n\"displayTimeUnit\":\"ns\",\n\"histograms\":{\n\"bounds\":[");
+	unsigned int b;
+	for ( b = 0 ; b < TRACE_BUCKETS ; b++ )
+	{
+		fprintf(fp,"%s%" FMT_INT64 "d", b>0?",":"", (int64)1<<b);
+	}
+	fprintf(fp,"]");
+	CLASS *oclass;
+	for ( oclass = class_get_first_class() ; oclass != NULL ; oclass = oclass->next )
+	{
+		unsigned int pass;
+		if ( (size_t)oclass->id >= n_classes )
+		{
+			continue;
+		}
+		for ( pass = 0 ; pass < TRACE_PASSES ; pass++ )
+		{
+			int64 bucket[TRACE_BUCKETS];
+			if ( trace_histogram(oclass,pass,bucket) == 0 )
+			{
+				continue;
+			}
+			fprintf(fp,",\n\"%s.%s\":[", oclass->name, passname[pass]);
+			for ( b = 0 ; b < TRACE_BUCKETS ; b++ )
+			{
+				fprintf(fp,"%s%" FMT_INT64 "d", b>0?",":"", bucket[b]);
+			}
+			fprintf(fp,"]");
+		}
+	}
+	fprintf(fp,"\n}\n}\n");
+	fclose(fp);
+	if ( n_dropped > 0 )
+	{
+		output_warning("trace buffer was full, %lu spans were not saved", (unsigned long)n_dropped);
+		/* TROUBLESHOOT
+			Each thread records at most TRACE_MAXEVENTS spans.  Shorten the
+			simulation, reduce the number of threads, or increase the value
+			of profiler_trace_sample to record a complete trace.
+		 */
+	}
+	IN_MYCONTEXT output_verbose("saved %lu spans to trace file '%s'", (unsigned long)n_events, filename);
+	return SUCCESS;
+}
+
+/** @} **/
@@ -0,0 +1,108 @@
+/* File: trace.h
+ * Copyright (C) 2018, Regents of the Leland Stanford Junior University
+
+	@file trace.h
+	@addtogroup trace Sync tracer
+	@ingroup core
+
+	The sync tracer records the time spent by each thread in the passes,
+	ranks and classes of each timestep, the time each thread waits for
+	the others to finish a rank, and optionally the sync time of a sample
+	of the objects.  The spans are saved in Chrome trace-event format so
+	they can be viewed using chrome://tracing or https://ui.perfetto.dev.
+
+	The tracer also collects a latency histogram of the object sync time
+	for each class and pass, which is reported with the profiler results
+	and saved with the trace.
+
+	Spans are recorded in per-thread buffers, so recording a span never
+	locks or shares memory with another thread.
+
+ @{
+ **/
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#if ! defined _GLDCORE_H && ! defined _GRIDLABD_H
+#error "this header may only be included from gldcore.h or gridlabd.h"
+#endif
+
+/* Define: TRACE_BUCKETS
+	Number of histogram buckets.  Bucket n counts the syncs that took less than 2^n ns. */
+#define TRACE_BUCKETS 32
+
+/* Define: TRACE_MAXEVENTS
+	Maximum number of spans recorded by each thread. */
+#define TRACE_MAXEVENTS 4000000
+
+/* Variable: trace_active
+	Flag indicating that the tracer is running */
+extern bool trace_active;
+
+/* Function: trace_now
+	Get the tracer clock
+
+	Returns:
+	The monotonic clock in ns
+ */
+int64 trace_now(void);
+
+/* Function: trace_passname
+	Get the name of a sync pass
+
+	Returns:
+	The name of the pass (0=presync, 1=sync, 2=postsync)
+ */
+const char *trace_passname(unsigned int pass);
+
+/* Function: trace_init
+	Start the tracer
+
+	The tracer is started only when <global_profiler> or <global_profiler_trace>
+	is set.  Spans are recorded only when <global_profiler_trace> is set.
+
+	Returns:
+	SUCCESS or FAILED
+ */
+STATUS trace_init(unsigned int n_threads); /**< number of threads that record spans */
+
+/* Function: trace_span
+	Record a span
+ */
+void trace_span(unsigned int thread, /**< thread that did the work */
+				const char *name, /**< name of the span (must be static) */
+				const char *category, /**< category of the span (must be static) */
+				int64 start, /**< start time (from <trace_now>) */
+				int64 stop, /**< stop time (from <trace_now>) */
+				int64 arg=-1); /**< rank or object id (-1 for none) */
+
+/* Function: trace_object
+	Record the sync of an object
+
+	The sync time is added to the histogram of the object's class and pass.
+	Consecutive syncs of the same class by the same thread are merged into
+	one class span, and a span is recorded for sampled objects.
+ */
+void trace_object(unsigned int thread, /**< thread that did the sync */
+				  OBJECT *obj, /**< object synced */
+				  unsigned int pass, /**< pass number (0=presync, 1=sync, 2=postsync) */
+				  int64 start, /**< start time (from <trace_now>) */
+				  int64 stop); /**< stop time (from <trace_now>) */
+
+/* Function: trace_profile
+	Report the class latency histograms with the profiler results
+ */
+void trace_profile(void);
+
+/* Function: trace_save
+	Save the trace and stop the tracer
+
+	Returns:
+	SUCCESS or FAILED
+ */
+STATUS trace_save(const char *filename); /**< Chrome trace file name */
+
+#endif
+
+/** @} **/
@@ -21,7 +21,7 @@ complex_assert::complex_assert(MODULE *module)
 	if (oclass==NULL)
 	{
 		// register to receive notice for first top down. bottom up, and second top down synchronizations
-		oclass = gl_register_class(module,"complex_assert",sizeof(complex_assert),PC_AUTOLOCK|PC_OBSERVER);
+		oclass = gl_register_class(module,"complex_assert",sizeof(complex_assert),PC_AUTOLOCK|PC_OBSERVER|PC_PARALLELINIT);
 		if (oclass==NULL)
 			throw "unable to register class complex_assert";
 		else
@@ -93,8 +93,7 @@ TIMESTAMP complex_assert::commit(TIMESTAMP t1, TIMESTAMP t2)
 	}
 
 	// get the target property
-	gld_property target_prop(get_parent(),get_target());
-	if ( !target_prop.is_valid() || target_prop.get_type()!=PT_complex ) {
+	if ( get_target_addr() == NULL ) {
 		gl_error("Specified target %s for %s is not valid.",get_target(),get_parent()->get_name());
 		/*  TROUBLESHOOT
 		Check to make sure the target you are specifying is a published variable for the object
@@ -106,7 +105,7 @@ TIMESTAMP complex_assert::commit(TIMESTAMP t1, TIMESTAMP t2)
 	}
 
 	// test the target value
-	complex x; target_prop.getp(x);
+	complex x = target_value.getp(my()->parent);
 	if ( status==ASSERT_TRUE )
 	{
 		if ( operation==FULL || operation==REAL || operation==IMAGINARY )
@@ -214,9 +213,25 @@ int complex_assert::postnotify(PROPERTY *prop, const char *value)
 	{
 		once = ONCE_TRUE ;
 	}
+	else if ( strcmp(prop->name, "target")==0 )
+	{
+		target_value.bind((PROPERTY*)NULL);
+	}
 	return 1;
 }
 
+// get the address of the target property in the parent, binding the accessor on first use
+// and again whenever the parent is not of the class the accessor is bound to
+complex *complex_assert::get_target_addr(void)
+{
+	OBJECT *parent = my()->parent;
+	if ( parent == NULL )
+		return NULL;
+	if ( !target_value.is_bound(parent) && !target_value.bind(parent,get_target()) )
+		return NULL;
+	return target_value.get_addr(parent);
+}
+
 EXPORT SIMULATIONMODE update_complex_assert(OBJECT *obj, TIMESTAMP t0, unsigned int64 delta_time, unsigned long dt, unsigned int iteration_count_val)
 {
 	char buff[64];
@@ -249,7 +264,7 @@ EXPORT SIMULATIONMODE update_complex_assert(OBJECT *obj, TIMESTAMP t0, unsigned
 		if (delta_time>=dt)
 		{
 			//Get value
-			x = (complex*)gl_get_complex_by_name(obj->parent,da->get_target());
+			x = da->get_target_addr();
 
 			if (x==NULL) 
 			{
@@ -25,6 +25,9 @@ public:
 	GL_STRUCT(complex,once_value);
 	GL_ATOMIC(double,within);
 
+private:
+	gld_accessor<complex> target_value;
+
 public:
 	/* required implementations */
 	complex_assert(MODULE *module);
@@ -33,6 +36,7 @@ public:
 	TIMESTAMP commit(TIMESTAMP t1, TIMESTAMP t2);
 	int postnotify(PROPERTY *prop, const char *value);
 	inline int prenotify(PROPERTY*,const char *) { return 1; };
+	complex *get_target_addr(void);
 
 public:
 	static CLASS *oclass;
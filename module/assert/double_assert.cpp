@@ -20,7 +20,7 @@ double_assert::double_assert(MODULE *module)
 	if (oclass==NULL)
 	{
 		// register to receive notice for first top down. bottom up, and second top down synchronizations
-		oclass = gl_register_class(module,"double_assert",sizeof(double_assert),PC_AUTOLOCK|PC_OBSERVER);
+		oclass = gl_register_class(module,"double_assert",sizeof(double_assert),PC_AUTOLOCK|PC_OBSERVER|PC_PARALLELINIT);
 		if (oclass==NULL)
 			throw "unable to register class double_assert";
 		else
@@ -86,8 +86,7 @@ TIMESTAMP double_assert::commit(TIMESTAMP t1, TIMESTAMP t2)
 	}
 		
 	// get the target property
-	gld_property target_prop(get_parent(),get_target());
-	if ( !target_prop.is_valid() || target_prop.get_type()!=PT_double ) 
+	if ( get_target_addr() == NULL ) 
 	{
 		gl_error("Specified target %s for %s is not valid.",get_target(),get_parent()->get_name());
 		/*  TROUBLESHOOT
@@ -115,7 +114,7 @@ TIMESTAMP double_assert::commit(TIMESTAMP t1, TIMESTAMP t2)
 	}
 
 	// test the target value
-	double x; target_prop.getp(x);
+	double x = target_value.getp(my()->parent);
 	if ( status == ASSERT_TRUE )
 	{
 		double m = fabs(x-value);
@@ -154,9 +153,25 @@ int double_assert::postnotify(PROPERTY *prop, const char *value)
 	{
 		once = ONCE_TRUE;
 	}
+	else if ( strcmp(prop->name, "target")==0 )
+	{
+		target_value.bind((PROPERTY*)NULL);
+	}
 	return 1;
 }
 
+// get the address of the target property in the parent, binding the accessor on first use
+// and again whenever the parent is not of the class the accessor is bound to
+double *double_assert::get_target_addr(void)
+{
+	OBJECT *parent = my()->parent;
+	if ( parent == NULL )
+		return NULL;
+	if ( !target_value.is_bound(parent) && !target_value.bind(parent,get_target()) )
+		return NULL;
+	return target_value.get_addr(parent);
+}
+
 //EXPORT for object-level call (as opposed to module-level)
 EXPORT SIMULATIONMODE update_double_assert(OBJECT *obj, TIMESTAMP t0, unsigned int64 delta_time, unsigned long dt, unsigned int iteration_count_val)
 {
@@ -206,7 +221,7 @@ EXPORT SIMULATIONMODE update_double_assert(OBJECT *obj, TIMESTAMP t0, unsigned i
 		if (delta_time>=dt)
 		{
 			//Get value
-			x = (double*)gl_get_double_by_name(obj->parent,da->get_target());
+			x = da->get_target_addr();
 
 			if (x==NULL) 
 			{
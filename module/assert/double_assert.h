@@ -24,6 +24,9 @@ public:
 	GL_ATOMIC(enumeration,within_mode);
 	GL_ATOMIC(double,within);
 
+private:
+	gld_accessor<double> target_value;
+
 public:
 	/* required implementations */
 	double_assert(MODULE *module);
@@ -32,6 +35,7 @@ public:
 	TIMESTAMP commit(TIMESTAMP t1, TIMESTAMP t2);
 	int postnotify(PROPERTY *prop, const char *value);
 	inline int prenotify(PROPERTY*,const char *) { return 1; };
+	double *get_target_addr(void);
 public:
 	static CLASS *oclass;
 	static double_assert *defaults;
@@ -53,4 +53,233 @@ EXPORT int check(){
 	return 0;
 }
 
+/* create an uninitialized object of a class without adding it to the model */
+static OBJECT *accessor_test_object(CLASS *oclass)
+{
+	OBJECT *obj = (OBJECT*)calloc(1,sizeof(OBJECT)+oclass->size);
+	if ( obj != NULL )
+		obj->oclass = oclass;
+	return obj;
+}
+
+/* find the within property of a test object without an accessor */
+static double *accessor_test_within(OBJECT *obj)
+{
+	PROPERTY *prop = callback->find_property(obj->oclass,(char*)"within");
+	return (double*)((char*)(obj+1)+(size_t)prop->addr);
+}
+
+/* unit test of gld_accessor using the properties of the assert classes */
+EXPORT void test(int argc, char *argv[])
+{
+	int failed = 0, ok = 0;
+	const size_t N = 4;
+	OBJECT *obj[N+1];
+	OBJECT *other = NULL;
+	double values[N+1];
+	size_t n;
+
+	gl_testmsg("\nBEGIN: accessor tests");
+	for ( n = 0 ; n < N ; n++ )
+	{
+		obj[n] = accessor_test_object(double_assert::oclass);
+	}
+	obj[N] = NULL; /* skipped by read and write */
+	other = accessor_test_object(complex_assert::oclass);
+	for ( n = 0 ; n < N ; n++ )
+	{
+		if ( obj[n] == NULL || other == NULL )
+		{
+			gl_testmsg("unable to allocate test objects");
+			failed++;
+			goto Done;
+		}
+	}
+
+	/* bind by class checks the name and the type */
+	{
+		gld_accessor<double> value, missing, wrongtype;
+		gld_accessor<int32> status;
+		if ( !value.bind(double_assert::oclass,"value") || !value.is_valid() || strcmp(value.get_property()->name,"value") != 0 )
+		{
+			gl_testmsg("bind to double_assert.value failed");
+			failed++;
+		}
+		else ok++;
+		if ( missing.bind(double_assert::oclass,"no_such_property") || missing.is_valid() )
+		{
+			gl_testmsg("bind to a missing property succeeded");
+			failed++;
+		}
+		else ok++;
+		if ( wrongtype.bind(double_assert::oclass,"status") || wrongtype.is_valid() )
+		{
+			gl_testmsg("bind of a double accessor to an enumeration succeeded");
+			failed++;
+		}
+		else ok++;
+		if ( !status.bind(double_assert::oclass,"status") )
+		{
+			gl_testmsg("bind of an int32 accessor to an enumeration failed");
+			failed++;
+		}
+		else ok++;
+		if ( !value.bind(obj[0],"within") || strcmp(value.get_property()->name,"within") != 0 )
+		{
+			gl_testmsg("bind by object to double_assert.within failed");
+			failed++;
+		}
+		else ok++;
+		value.bind((PROPERTY*)NULL);
+		if ( value.is_valid() || value.is_bound(obj[0]) )
+		{
+			gl_testmsg("accessor is still bound after bind(NULL)");
+			failed++;
+		}
+		else ok++;
+	}
+
+	/* is_bound only accepts objects of the bound class */
+	{
+		gld_accessor<double> value(double_assert::oclass,"value");
+		gld_accessor<complex> cvalue(complex_assert::oclass,"value");
+		if ( !value.is_bound(obj[0]) || value.is_bound(other) || value.is_bound(NULL) )
+		{
+			gl_testmsg("double_assert accessor is_bound gives the wrong result");
+			failed++;
+		}
+		else ok++;
+		if ( !cvalue.is_bound(other) || cvalue.is_bound(obj[0]) )
+		{
+			gl_testmsg("complex_assert accessor is_bound gives the wrong result");
+			failed++;
+		}
+		else ok++;
+	}
+
+	/* get and set use the property of each object */
+	{
+		gld_accessor<double> value(double_assert::oclass,"value");
+		gld_accessor<double> within(double_assert::oclass,"within");
+		for ( n = 0 ; n < N ; n++ )
+		{
+			double_assert *my = OBJECTDATA(obj[n],double_assert);
+			value.set(obj[n],n+0.5);
+			within.setp(obj[n],n+0.25);
+			if ( my->get_value() != n+0.5 || my->get_within() != n+0.25 )
+			{
+				gl_testmsg("set on object %d wrote value=%g within=%g", (int)n, my->get_value(), my->get_within());
+				failed++;
+			}
+			else ok++;
+			my->set_value(n*2.0);
+			if ( value.get(obj[n]) != n*2.0 || value.getp(obj[n]) != n*2.0 || within.get(obj[n]) != n+0.25 )
+			{
+				gl_testmsg("get on object %d read value=%g within=%g", (int)n, value.get(obj[n]), within.get(obj[n]));
+				failed++;
+			}
+			else ok++;
+		}
+	}
+
+	/* read gathers and write scatters, skipping NULL objects */
+	{
+		gld_accessor<double> value(double_assert::oclass,"value");
+		for ( n = 0 ; n <= N ; n++ )
+		{
+			values[n] = -1.0;
+		}
+		if ( value.read(obj,N+1,values) != N )
+		{
+			gl_testmsg("read did not skip the NULL object");
+			failed++;
+		}
+		else ok++;
+		for ( n = 0 ; n < N ; n++ )
+		{
+			if ( values[n] != n*2.0 )
+			{
+				gl_testmsg("read value %d is %g instead of %g", (int)n, values[n], n*2.0);
+				failed++;
+			}
+			else ok++;
+			values[n] = 10.0+n;
+		}
+		if ( values[N] != -1.0 )
+		{
+			gl_testmsg("read wrote a value for the NULL object");
+			failed++;
+		}
+		else ok++;
+		if ( value.write(obj,N+1,values) != N )
+		{
+			gl_testmsg("write did not skip the NULL object");
+			failed++;
+		}
+		else ok++;
+		for ( n = 0 ; n < N ; n++ )
+		{
+			if ( OBJECTDATA(obj[n],double_assert)->get_value() != 10.0+n )
+			{
+				gl_testmsg("write value %d is %g instead of %g", (int)n, OBJECTDATA(obj[n],double_assert)->get_value(), 10.0+n);
+				failed++;
+			}
+			else ok++;
+		}
+	}
+
+	/* an assert follows its target when its parent changes to another class */
+	{
+		OBJECT *check = accessor_test_object(double_assert::oclass);
+		double_assert *my = check ? OBJECTDATA(check,double_assert) : NULL;
+		if ( my == NULL )
+		{
+			gl_testmsg("unable to allocate the assert test object");
+			failed++;
+			goto Done;
+		}
+		my->set_target((char*)"within");
+		check->parent = obj[0];
+		if ( my->get_target_addr() != accessor_test_within(obj[0]) )
+		{
+			gl_testmsg("assert target in a double_assert parent is not its within property");
+			failed++;
+		}
+		else ok++;
+		check->parent = other;
+		if ( my->get_target_addr() != accessor_test_within(other) )
+		{
+			gl_testmsg("assert target in a complex_assert parent is not its within property");
+			failed++;
+		}
+		else ok++;
+		check->parent = obj[1];
+		if ( my->get_target_addr() != accessor_test_within(obj[1]) )
+		{
+			gl_testmsg("assert target in a double_assert parent is not its within property after a class change");
+			failed++;
+		}
+		else ok++;
+		free(check);
+	}
+
+Done:
+	for ( n = 0 ; n < N ; n++ )
+	{
+		free(obj[n]);
+	}
+	free(other);
+	if ( failed )
+	{
+		gl_error("accessortest: %d accessor tests failed--see test.txt for more information",failed);
+		gl_testmsg("!!! %d accessor tests failed",failed);
+	}
+	else
+	{
+		gl_verbose("%d accessor tests completed with no errors--see test.txt for details",ok);
+		gl_testmsg("accessortest: %d accessor tests completed with no errors",ok);
+	}
+	gl_testmsg("END: accessor tests");
+}
+
 /** @} **/
\ No newline at end of file
@@ -20,7 +20,7 @@ int_assert::int_assert(MODULE *module)
 	if (oclass==NULL)
 	{
 		// register to receive notice for first top down. bottom up, and second top down synchronizations
-		oclass = gl_register_class(module,"int_assert",sizeof(int_assert),PC_AUTOLOCK|PC_OBSERVER);
+		oclass = gl_register_class(module,"int_assert",sizeof(int_assert),PC_AUTOLOCK|PC_OBSERVER|PC_PARALLELINIT);
 		if (oclass==NULL)
 			throw "unable to register class int_assert";
 		else
@@ -651,7 +651,7 @@ const char *database::get_header_value(OBJECT *obj, const char *item, char *buff
     else if ( strcmp(item,"groupid") == 0 )
     {
         char *c, *p = buffer;
-        for ( c = obj->groupid ; *c != '\0' && p < buffer+len-1 ; c++ )
+        for ( c = obj->cold->groupid ; *c != '\0' && p < buffer+len-1 ; c++ )
         {
             if ( strchr(", \t",*c) )
             {
@@ -670,31 +670,31 @@ const char *database::get_header_value(OBJECT *obj, const char *item, char *buff
     }
     else if ( strcmp(item,"on_init") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.init ? obj->events.init : "");
+        snprintf(buffer,len,"%s", obj->cold->events.init ? obj->cold->events.init : "");
     }
     else if ( strcmp(item,"on_precommit") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.precommit ? obj->events.precommit : "");
+        snprintf(buffer,len,"%s", obj->cold->events.precommit ? obj->cold->events.precommit : "");
     }
     else if ( strcmp(item,"on_presync") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.presync ? obj->events.presync : "");
+        snprintf(buffer,len,"%s", obj->cold->events.presync ? obj->cold->events.presync : "");
     }
     else if ( strcmp(item,"on_sync") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.sync ? obj->events.sync : "");
+        snprintf(buffer,len,"%s", obj->cold->events.sync ? obj->cold->events.sync : "");
     }
     else if ( strcmp(item,"on_postsync") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.postsync ? obj->events.postsync : "");
+        snprintf(buffer,len,"%s", obj->cold->events.postsync ? obj->cold->events.postsync : "");
     }
     else if ( strcmp(item,"on_commit") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.commit ? obj->events.commit : "");
+        snprintf(buffer,len,"%s", obj->cold->events.commit ? obj->cold->events.commit : "");
     }
     else if ( strcmp(item,"on_finalize") == 0 )
     {
-        snprintf(buffer,len,"%s", obj->events.finalize ? obj->events.finalize : "");
+        snprintf(buffer,len,"%s", obj->cold->events.finalize ? obj->cold->events.finalize : "");
     }
     else
     {
@@ -534,7 +534,7 @@ static bool import_objects(MYSQL *mysql)
 				return false;
 			}
 		}
-		if ( row[3]!=NULL ) strncpy(obj->groupid,row[3],sizeof(obj->groupid));
+		if ( row[3]!=NULL ) gl_set_value_by_name(obj,"groupid",row[3]);
 		obj->parent = row[4]==NULL ? NULL : gl_object_find_by_id(atoi(row[4]));
 		obj->rank = atoi(row[5]);
 		obj->clock = get_mysql_timestamp(row[6]);
@@ -1100,7 +1100,7 @@ static bool export_objects(MYSQL *mysql)
 		char heartbeat[64] = MYSQL_TS_NEVER;
 		if ( mod!=NULL ) sprintf(modname,"\"%s\"", mod->name);
 		if ( obj->name!=NULL ) sprintf(name,"\"%s\"", obj->name);
-		if ( strcmp(obj->groupid,"")!=0 ) sprintf(groupid,"\"%s\"", (const char*)obj->groupid);
+		if ( strcmp(obj->cold->groupid,"")!=0 ) sprintf(groupid,"\"%s\"", (const char*)obj->cold->groupid);
 		if ( obj->parent!=NULL ) sprintf(parent,"%d", obj->parent->id);
 		if ( !isnan(obj->latitude) ) sprintf(latitude,"%g", obj->latitude);
 		if ( !isnan(obj->longitude) ) sprintf(longitude,"%g", obj->longitude);
@@ -1283,10 +1283,13 @@ bool export_schedules(MYSQL *mysql)
 		return false;
 	for ( SCHEDULE *schedule=gl_schedule_getfirst() ; schedule!=NULL ; schedule=schedule->next )
 	{
-		char quoted[sizeof(schedule->definition)*2+1];
-		mysql_real_escape_string(mysql,quoted,schedule->definition,strlen(schedule->definition));
-		if ( !query(mysql,"REPLACE INTO `%s` (`name`,`definition`) VALUES (\"%s\",\"%s\")", get_table_name("schedules"),
-				schedule->name, quoted) )
+		size_t len = strlen(schedule->definition);
+		char *quoted = new char[len*2+1];
+		mysql_real_escape_string(mysql,quoted,schedule->definition,len);
+		bool ok = query(mysql,"REPLACE INTO `%s` (`name`,`definition`) VALUES (\"%s\",\"%s\")", get_table_name("schedules"),
+				schedule->name, quoted);
+		delete [] quoted;
+		if ( !ok )
 			return false;
 	}
 	return true;
@@ -0,0 +1,7 @@
+# the time at which the object leaves group A (2020-01-01 01:30:00 UTC)
+change = 1577842200
+
+def regroup(obj,t):
+    if t >= change and gridlabd.get_value(obj,"groupid") != "B":
+        gridlabd.set_value(obj,"groupid","B")
+    return t+1800